@@ -0,0 +1,98 @@
+/**
+ * @file bench.h
+ * @brief 内核性能测试入口
+ *
+ * htOSInit()之后、htOSStart()之前调用 htBenchSuiteStart()，由一个测试任务依次运行各项测试，
+ * 每项测试自己创建和删除所需的辅助任务与内核对象，全部完成后调用htTaskEndScheduler()。
+ *
+ * 计时：主机(BENCH_HOST)上为单调时钟纳秒，目标板上为移植层的运行时间计数器(CPU周期)。每项测试分若干批运行，
+ * 每批测一次总时间并折算为单次操作耗时，输出全部批次的平均值、最好批次和最差批次。
+ * 结果为CSV或JSON，一项测试参数一行/一个对象，便于在不同内核版本之间比较。
+ */
+#ifndef HT_BENCH_H
+#define HT_BENCH_H
+
+#include "httypes.h"
+
+/* 测试任务优先级，辅助任务使用相邻的更高优先级 */
+#ifndef BENCH_PRIORITY
+#define BENCH_PRIORITY 8
+#endif
+
+/* 辅助任务栈大小(字) */
+#ifndef BENCH_STACK_SIZE
+#define BENCH_STACK_SIZE 256
+#endif
+
+/* 每项测试的批次数 */
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 20
+#endif
+
+/* 每批的操作次数 */
+#ifndef BENCH_BATCH
+#define BENCH_BATCH 500
+#endif
+
+/* 输出格式 */
+#define BENCH_FORMAT_CSV 0
+#define BENCH_FORMAT_JSON 1
+
+/* 一组采样的统计 */
+typedef struct htBenchStat {
+	uint32_t ulSamples; /* 采样数 */
+	uint64_t ullSum; /* 总和 */
+	uint32_t ulMin; /* 最小值 */
+	uint32_t ulMax; /* 最大值 */
+} htBenchStat_t;
+
+/**
+ * 读取计时器，两次读数之差为经过的时间
+ * @return 主机上为纳秒，目标板上为CPU周期，32位回绕
+ */
+uint32_t htBenchNow(void);
+
+/* 计时单位名称："ns" 或 "cycles" */
+const char *htBenchUnit(void);
+
+/* 设置输出格式，在htBenchSuiteStart()之前调用，默认CSV */
+void htBenchSetFormat(UBaseType_t uxFormat);
+
+void htBenchStatInit(htBenchStat_t *pxStat);
+void htBenchStatAdd(htBenchStat_t *pxStat, uint32_t ulValue);
+
+/**
+ * 输出一行结果
+ * @param pcName 测试名
+ * @param pcParam 参数名，没有参数时为"-"
+ * @param ulValue 参数值
+ * @param pxStat 单次操作耗时的统计，采样数为0表示该参数被跳过(如内存不足)
+ */
+void htBenchReport(const char *pcName, const char *pcParam, uint32_t ulValue, const htBenchStat_t *pxStat);
+
+/* 输出的开头和结尾(CSV表头、JSON数组括号) */
+void htBenchBegin(void);
+void htBenchEnd(void);
+
+/**
+ * 滴答钩子：记录每个tick发生的时刻，供延时唤醒抖动测试使用
+ * 应在vApplicationTickHook()中调用；未调用时抖动测试输出采样数为0
+ */
+void htBenchTickHook(void);
+
+/* 各项测试，在测试任务中依次调用 */
+void htBenchYield(void);
+void htBenchDelayJitter(void);
+void htBenchQueuePingPong(void);
+void htBenchSemaphore(void);
+void htBenchMutex(void);
+void htBenchMalloc(void);
+void htBenchNotify(void);
+
+/**
+ * 创建测试任务
+ * @return htPASS表示创建成功
+ */
+BaseType_t htBenchSuiteStart(void);
+
+#endif /* HT_BENCH_H */
@@ -0,0 +1,39 @@
+/**
+ * @file bench_main.c
+ * @brief 主机性能测试程序 - 在POSIX移植层上运行全部测试
+ *
+ * 用法：bench.out [--json]，结果写到标准输出，默认CSV。
+ */
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "htos.h"
+
+/* 滴答钩子：记录tick时刻供唤醒延迟测试使用 */
+void vApplicationTickHook(void)
+{
+	htBenchTickHook();
+}
+
+int main(int argc, char *argv[])
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0) {
+			htBenchSetFormat(BENCH_FORMAT_JSON);
+		} else {
+			fprintf(stderr, "usage: %s [--json]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	htOSInit();
+	if (htBenchSuiteStart() != htPASS) {
+		fprintf(stderr, "bench: cannot create bench task\n");
+		return 1;
+	}
+	htOSStart();
+
+	return 0;
+}
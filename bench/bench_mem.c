@@ -0,0 +1,78 @@
+/**
+ * @file bench_mem.c
+ * @brief 内存分配：htPortMalloc/htPortFree在不同分配模式下的单次操作开销
+ *
+ * - fixed：同一大小反复分配释放，空闲块始终可直接复用
+ * - mixed：保持一组存活块，按伪随机顺序用随机大小替换，堆逐渐碎片化后的查找与合并开销
+ * 伪随机序列固定种子，每次运行的操作序列相同。
+ */
+#include "bench.h"
+#include "htmem.h"
+
+/* 固定大小测试的块大小(字节) */
+static const uint16_t usFixedSizes[] = { 16, 64, 256 };
+
+/* 混合测试的存活块数和大小范围 */
+#ifndef BENCH_MALLOC_LIVE
+#define BENCH_MALLOC_LIVE 16
+#endif
+#define BENCH_MALLOC_MIN_SIZE 8
+#define BENCH_MALLOC_MAX_SIZE 512
+
+static uint32_t ulRandomState;
+
+static uint32_t prvRandom(void)
+{
+	ulRandomState = ulRandomState * 1103515245UL + 12345UL;
+	return ulRandomState >> 8;
+}
+
+/**
+ * 内存分配开销，每次操作为一次分配或一次释放
+ */
+void htBenchMalloc(void)
+{
+	void *pvLive[BENCH_MALLOC_LIVE];
+	htBenchStat_t xStat;
+	uint32_t ulStart;
+	uint32_t ulSlot;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+	void *pv;
+
+	for (i = 0; i < sizeof(usFixedSizes) / sizeof(usFixedSizes[0]); i++) {
+		htBenchStatInit(&xStat);
+		for (j = 0; j < BENCH_SAMPLES; j++) {
+			ulStart = htBenchNow();
+			for (k = 0; k < BENCH_BATCH; k++) {
+				pv = htPortMalloc(usFixedSizes[i]);
+				htPortFree(pv);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / (2U * BENCH_BATCH));
+		}
+		htBenchReport("malloc_fixed", "size", usFixedSizes[i], &xStat);
+	}
+
+	ulRandomState = 1;
+	for (i = 0; i < BENCH_MALLOC_LIVE; i++) {
+		pvLive[i] = htPortMalloc(BENCH_MALLOC_MIN_SIZE + prvRandom() % (BENCH_MALLOC_MAX_SIZE - BENCH_MALLOC_MIN_SIZE));
+	}
+
+	htBenchStatInit(&xStat);
+	for (j = 0; j < BENCH_SAMPLES; j++) {
+		ulStart = htBenchNow();
+		for (k = 0; k < BENCH_BATCH; k++) {
+			ulSlot = prvRandom() % BENCH_MALLOC_LIVE;
+			htPortFree(pvLive[ulSlot]);
+			pvLive[ulSlot] =
+				htPortMalloc(BENCH_MALLOC_MIN_SIZE + prvRandom() % (BENCH_MALLOC_MAX_SIZE - BENCH_MALLOC_MIN_SIZE));
+		}
+		htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / (2U * BENCH_BATCH));
+	}
+	htBenchReport("malloc_mixed", "live_blocks", BENCH_MALLOC_LIVE, &xStat);
+
+	for (i = 0; i < BENCH_MALLOC_LIVE; i++) {
+		htPortFree(pvLive[i]);
+	}
+}
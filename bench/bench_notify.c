@@ -0,0 +1,52 @@
+/**
+ * @file bench_notify.c
+ * @brief 任务通知往返开销
+ *
+ * 两个任务乒乓：测试任务发通知后等待回应，更高优先级的被动方收到后立即回应，
+ * 每次往返包含两次发信号、两次阻塞获取和两次上下文切换。
+ * 与 bench_sync.c 中信号量有竞争的往返结构相同，两者结果可直接对比。
+ */
+#include "bench.h"
+#include "httask.h"
+
+static TaskHandle_t xPingTask;
+
+/* 被动方：收到通知立即回应 */
+static void prvPongTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		(void)htTaskNotifyTake(htTRUE, htBLOCKED_INDEFINITELY);
+		(void)htTaskNotifyGive(xPingTask);
+	}
+}
+
+/**
+ * 任务通知往返开销
+ */
+void htBenchNotify(void)
+{
+	TaskHandle_t xPongTask = NULL;
+	htBenchStat_t xStat;
+	uint32_t ulStart;
+	uint32_t i;
+	uint32_t j;
+
+	htBenchStatInit(&xStat);
+	xPingTask = htTaskGetCurrentTaskHandle();
+
+	if (htTaskCreate(prvPongTask, "b_notify", BENCH_STACK_SIZE, NULL, BENCH_PRIORITY + 1, &xPongTask) == htPASS) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htTaskNotifyGive(xPongTask);
+				(void)htTaskNotifyTake(htTRUE, htBLOCKED_INDEFINITELY);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+		htTaskDelete(xPongTask);
+	}
+
+	htBenchReport("notify_give_take", "contended", 1, &xStat);
+}
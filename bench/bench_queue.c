@@ -0,0 +1,80 @@
+/**
+ * @file bench_queue.c
+ * @brief 队列乒乓：不同消息大小下htQueueSend/htQueueReceive的往返开销
+ *
+ * 两个长度为1的队列，测试任务发送后等待回应，更高优先级的回应任务收到后立即回发，
+ * 每次往返包含两次发送、两次阻塞接收、两次消息拷贝和两次上下文切换。
+ */
+#include <string.h>
+#include "bench.h"
+#include "httask.h"
+#include "htqueue.h"
+
+#define BENCH_QUEUE_MAX_ITEM 256
+
+static const uint16_t usItemSizes[] = { 4, 16, 64, BENCH_QUEUE_MAX_ITEM };
+
+static QueueHandle_t xPingQueue;
+static QueueHandle_t xPongQueue;
+
+/* 回应任务：收到消息原样发回 */
+static void prvPongTask(void *pvParameters)
+{
+	uint8_t ucItem[BENCH_QUEUE_MAX_ITEM];
+
+	(void)pvParameters;
+
+	for (;;) {
+		if (htQueueReceive(xPingQueue, ucItem, htBLOCKED_INDEFINITELY) == htPASS) {
+			(void)htQueueSend(xPongQueue, ucItem, htBLOCKED_INDEFINITELY);
+		}
+	}
+}
+
+/**
+ * 队列往返开销
+ */
+void htBenchQueuePingPong(void)
+{
+	uint8_t ucItem[BENCH_QUEUE_MAX_ITEM];
+	TaskHandle_t xPongTask;
+	htBenchStat_t xStat;
+	uint32_t ulStart;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+
+	memset(ucItem, 0x5A, sizeof(ucItem));
+
+	for (i = 0; i < sizeof(usItemSizes) / sizeof(usItemSizes[0]); i++) {
+		htBenchStatInit(&xStat);
+		xPongTask = NULL;
+		xPingQueue = htQueueCreate(1, usItemSizes[i]);
+		xPongQueue = htQueueCreate(1, usItemSizes[i]);
+
+		if (xPingQueue != NULL && xPongQueue != NULL &&
+				htTaskCreate(prvPongTask, "b_pong", BENCH_STACK_SIZE, NULL, BENCH_PRIORITY + 1, &xPongTask) == htPASS) {
+			for (j = 0; j < BENCH_SAMPLES; j++) {
+				ulStart = htBenchNow();
+				for (k = 0; k < BENCH_BATCH; k++) {
+					(void)htQueueSend(xPingQueue, ucItem, htBLOCKED_INDEFINITELY);
+					(void)htQueueReceive(xPongQueue, ucItem, htBLOCKED_INDEFINITELY);
+				}
+				htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+			}
+		}
+
+		/* 回应任务阻塞在接收上，可以直接删除 */
+		if (xPongTask != NULL) {
+			htTaskDelete(xPongTask);
+		}
+		if (xPingQueue != NULL) {
+			htQueueDelete(xPingQueue);
+		}
+		if (xPongQueue != NULL) {
+			htQueueDelete(xPongQueue);
+		}
+
+		htBenchReport("queue_pingpong", "item_size", usItemSizes[i], &xStat);
+	}
+}
@@ -0,0 +1,117 @@
+/**
+ * @file bench_report.c
+ * @brief 计时和结果输出
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include "bench.h"
+#ifdef BENCH_HOST
+#include <time.h>
+#else
+#include "htPort.h"
+#endif
+
+static UBaseType_t uxFormat = BENCH_FORMAT_CSV;
+static UBaseType_t uxReported = 0;
+
+#ifdef BENCH_HOST
+uint32_t htBenchNow(void)
+{
+	struct timespec xNow;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xNow);
+
+	return (uint32_t)((uint64_t)xNow.tv_sec * 1000000000U + (uint64_t)xNow.tv_nsec);
+}
+
+const char *htBenchUnit(void)
+{
+	return "ns";
+}
+#else
+#if configGENERATE_RUN_TIME_STATS == 0
+#error "目标板上用移植层的运行时间计数器计时，需要configGENERATE_RUN_TIME_STATS"
+#endif
+
+uint32_t htBenchNow(void)
+{
+	/* Cortex-M3移植层为DWT周期计数器，调度器启动时已配置 */
+	return htPortGetRunTimeCounter();
+}
+
+const char *htBenchUnit(void)
+{
+	return "cycles";
+}
+#endif
+
+void htBenchSetFormat(UBaseType_t uxNewFormat)
+{
+	uxFormat = uxNewFormat;
+}
+
+void htBenchStatInit(htBenchStat_t *pxStat)
+{
+	pxStat->ulSamples = 0;
+	pxStat->ullSum = 0;
+	pxStat->ulMin = 0xFFFFFFFFUL;
+	pxStat->ulMax = 0;
+}
+
+void htBenchStatAdd(htBenchStat_t *pxStat, uint32_t ulValue)
+{
+	pxStat->ulSamples++;
+	pxStat->ullSum += ulValue;
+	if (ulValue < pxStat->ulMin) {
+		pxStat->ulMin = ulValue;
+	}
+	if (ulValue > pxStat->ulMax) {
+		pxStat->ulMax = ulValue;
+	}
+}
+
+/**
+ * 输出一行结果
+ */
+void htBenchReport(const char *pcName, const char *pcParam, uint32_t ulValue, const htBenchStat_t *pxStat)
+{
+	unsigned long ulMean = 0;
+	unsigned long ulMin = 0;
+	unsigned long ulMax = 0;
+
+	if (pxStat->ulSamples > 0) {
+		ulMean = (unsigned long)(pxStat->ullSum / pxStat->ulSamples);
+		ulMin = (unsigned long)pxStat->ulMin;
+		ulMax = (unsigned long)pxStat->ulMax;
+	}
+
+	if (uxFormat == BENCH_FORMAT_JSON) {
+		printf("%s  {\"name\": \"%s\", \"param\": \"%s\", \"value\": %lu, \"samples\": %lu, \"unit\": \"%s\", "
+			   "\"mean\": %lu, \"min\": %lu, \"max\": %lu}",
+			(uxReported > 0) ? ",\n" : "", pcName, pcParam, (unsigned long)ulValue,
+			(unsigned long)pxStat->ulSamples, htBenchUnit(), ulMean, ulMin, ulMax);
+	} else {
+		printf("%s,%s,%lu,%lu,%s,%lu,%lu,%lu\n", pcName, pcParam, (unsigned long)ulValue,
+			(unsigned long)pxStat->ulSamples, htBenchUnit(), ulMean, ulMin, ulMax);
+	}
+	uxReported++;
+	fflush(stdout);
+}
+
+void htBenchBegin(void)
+{
+	uxReported = 0;
+	if (uxFormat == BENCH_FORMAT_JSON) {
+		printf("[\n");
+	} else {
+		printf("name,param,value,samples,unit,mean,min,max\n");
+	}
+}
+
+void htBenchEnd(void)
+{
+	if (uxFormat == BENCH_FORMAT_JSON) {
+		printf("\n]\n");
+	}
+	fflush(stdout);
+}
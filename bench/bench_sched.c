@@ -0,0 +1,148 @@
+/**
+ * @file bench_sched.c
+ * @brief 调度开销：htTaskYield耗时，以及不同任务数下延时任务从滴答到开始运行的唤醒延迟
+ */
+#include "bench.h"
+#include "httask.h"
+#include "htscheduler.h"
+
+/* 抖动测试的任务数，最大值不能超过BENCH_JITTER_MAX_TASKS */
+#define BENCH_JITTER_MAX_TASKS 500
+static const uint16_t usJitterTaskCounts[] = { 10, 100, BENCH_JITTER_MAX_TASKS };
+
+/* 每个抖动测试任务的延时周期(tick)，任务错开启动，每个tick约有 任务数/周期 个任务同时醒来 */
+#ifndef BENCH_JITTER_PERIOD
+#define BENCH_JITTER_PERIOD 10
+#endif
+
+/* 每个任务唤醒的次数 */
+#ifndef BENCH_JITTER_ROUNDS
+#define BENCH_JITTER_ROUNDS 20
+#endif
+
+/* 抖动测试任务栈大小(字)，任务数多，单独取小一些 */
+#ifndef BENCH_JITTER_STACK_SIZE
+#define BENCH_JITTER_STACK_SIZE 128
+#endif
+
+/* 最近一次滴答的时刻和tick值，由滴答钩子写入 */
+static volatile uint32_t ulTickTime;
+static volatile TickType_t xTickTimeTick;
+static volatile BaseType_t xTickHookCalled = htFALSE;
+
+static htBenchStat_t xJitterStat;
+
+/**
+ * 滴答钩子
+ */
+void htBenchTickHook(void)
+{
+	ulTickTime = htBenchNow();
+	xTickTimeTick = xTickCount;
+	xTickHookCalled = htTRUE;
+}
+
+/* 陪跑任务：与测试任务同优先级，不断让出CPU */
+static void prvYieldTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		htTaskYield();
+	}
+}
+
+/* 连续让出BENCH_BATCH次的平均耗时 */
+static void prvMeasureYield(htBenchStat_t *pxStat)
+{
+	uint32_t ulStart;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		ulStart = htBenchNow();
+		for (j = 0; j < BENCH_BATCH; j++) {
+			htTaskYield();
+		}
+		htBenchStatAdd(pxStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+	}
+}
+
+/**
+ * htTaskYield耗时
+ * tasks=1：同优先级没有其他就绪任务，让出后仍选中自己，不触发PendSV
+ * tasks=2：同优先级有另一个就绪任务，每次让出都轮到陪跑任务，结果包含一次上下文切换
+ */
+void htBenchYield(void)
+{
+	TaskHandle_t xPartner = NULL;
+	htBenchStat_t xStat;
+
+	htBenchStatInit(&xStat);
+	prvMeasureYield(&xStat);
+	htBenchReport("yield", "tasks", 1, &xStat);
+
+	htBenchStatInit(&xStat);
+	if (htTaskCreate(prvYieldTask, "b_yield", BENCH_STACK_SIZE, NULL, BENCH_PRIORITY, &xPartner) == htPASS) {
+		prvMeasureYield(&xStat);
+		htTaskDelete(xPartner);
+	}
+
+	htBenchReport("yield", "tasks", 2, &xStat);
+}
+
+/* 抖动测试任务：每次醒来记录距离本tick滴答的时间 */
+static void prvJitterTask(void *pvParameters)
+{
+	uint32_t ulLatency;
+
+	/* 错开第一次唤醒，使各tick醒来的任务数相近 */
+	htTaskDelay(1 + (TickType_t)((uintptr_t)pvParameters % BENCH_JITTER_PERIOD));
+
+	for (;;) {
+		ulLatency = htBenchNow() - ulTickTime;
+		htEnterCritical();
+		if (xTickHookCalled == htTRUE && xTickTimeTick == xTickCount) {
+			htBenchStatAdd(&xJitterStat, ulLatency);
+		}
+		htExitCritical();
+		htTaskDelay(BENCH_JITTER_PERIOD);
+	}
+}
+
+/**
+ * 延时唤醒延迟：tick发生到被唤醒的任务开始运行的时间，包含到期处理和同一tick先醒来任务的运行
+ * 任务数超出堆容量时该参数的采样数为0
+ */
+void htBenchDelayJitter(void)
+{
+	static TaskHandle_t xTasks[BENCH_JITTER_MAX_TASKS];
+	uint32_t ulCount;
+	uint32_t ulCreated;
+	uint32_t i;
+
+	for (i = 0; i < sizeof(usJitterTaskCounts) / sizeof(usJitterTaskCounts[0]); i++) {
+		ulCount = usJitterTaskCounts[i];
+		htBenchStatInit(&xJitterStat);
+
+		for (ulCreated = 0; ulCreated < ulCount; ulCreated++) {
+			if (htTaskCreate(prvJitterTask, "b_jitter", BENCH_JITTER_STACK_SIZE, (void *)(uintptr_t)ulCreated,
+					BENCH_PRIORITY + 1, &xTasks[ulCreated]) != htPASS) {
+				break;
+			}
+		}
+
+		if (ulCreated == ulCount) {
+			htTaskDelay((BENCH_JITTER_ROUNDS + 1) * BENCH_JITTER_PERIOD);
+		} else {
+			htBenchStatInit(&xJitterStat);
+		}
+
+		/* 测试任务优先级更低，运行到这里时抖动测试任务都已阻塞 */
+		while (ulCreated > 0) {
+			htTaskDelete(xTasks[--ulCreated]);
+		}
+
+		htBenchReport("delay_wake_latency", "tasks", ulCount, &xJitterStat);
+	}
+}
@@ -0,0 +1,37 @@
+/**
+ * @file bench_suite.c
+ * @brief 测试任务：依次运行各项性能测试并输出结果
+ */
+#include "bench.h"
+#include "httask.h"
+
+/* 测试任务栈大小(字)，混合分配测试的存活块表在此栈上 */
+#define BENCH_RUNNER_STACK_SIZE 512
+
+static void prvBenchTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htBenchBegin();
+	htBenchYield();
+	htBenchQueuePingPong();
+	htBenchSemaphore();
+	htBenchMutex();
+	htBenchNotify();
+	htBenchMalloc();
+	htBenchDelayJitter();
+	htBenchEnd();
+
+	htTaskEndScheduler();
+	for (;;) {
+		htTaskDelay(htBLOCKED_INDEFINITELY);
+	}
+}
+
+/**
+ * 创建测试任务
+ */
+BaseType_t htBenchSuiteStart(void)
+{
+	return htTaskCreate(prvBenchTask, "bench", BENCH_RUNNER_STACK_SIZE, NULL, BENCH_PRIORITY, NULL);
+}
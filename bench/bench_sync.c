@@ -0,0 +1,193 @@
+/**
+ * @file bench_sync.c
+ * @brief 信号量与互斥量：无竞争时的获取/释放开销，以及有竞争时的交接开销
+ *
+ * - 无竞争：测试任务自己释放、自己获取，不发生阻塞和切换
+ * - 信号量有竞争：与更高优先级任务用两个二值信号量乒乓，每次往返两次阻塞、两次切换
+ * - 互斥量有竞争：测试任务持有互斥量时唤醒更高优先级的等待者，等待者阻塞在互斥量上并
+ *   触发优先级继承，测试任务释放后等待者获取、释放，再等待下一次唤醒
+ * - 互斥量的两种实现分别测量：基于队列的htSemaphoreTakeMutex/GiveMutex(mutex_take_give)
+ *   和轻量互斥量htMutexLock/Unlock(mutex_lock_unlock)，后者无竞争时只有两次原子比较交换
+ */
+#include "bench.h"
+#include "httask.h"
+#include "htsemaphore.h"
+#include "htmutex.h"
+
+static SemaphoreHandle_t xPingSem;
+static SemaphoreHandle_t xPongSem;
+static SemaphoreHandle_t xMutex;
+static MutexHandle_t xLightMutex;
+
+/* 信号量回应任务 */
+static void prvSemPongTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		(void)htSemaphoreTake(xPongSem, htBLOCKED_INDEFINITELY);
+		(void)htSemaphoreGive(xPingSem);
+	}
+}
+
+/* 互斥量等待者：每次被通知后争用一次互斥量 */
+static void prvMutexWaiterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		(void)htTaskNotifyTake(htTRUE, htBLOCKED_INDEFINITELY);
+		(void)htSemaphoreTakeMutex(xMutex, htBLOCKED_INDEFINITELY);
+		(void)htSemaphoreGiveMutex(xMutex);
+	}
+}
+
+/* 轻量互斥量等待者 */
+static void prvLightMutexWaiterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		(void)htTaskNotifyTake(htTRUE, htBLOCKED_INDEFINITELY);
+		(void)htMutexLock(xLightMutex, htBLOCKED_INDEFINITELY);
+		(void)htMutexUnlock(xLightMutex);
+	}
+}
+
+/**
+ * 信号量获取/释放开销
+ */
+void htBenchSemaphore(void)
+{
+	TaskHandle_t xPongTask = NULL;
+	htBenchStat_t xStat;
+	uint32_t ulStart;
+	uint32_t i;
+	uint32_t j;
+
+	/* 无竞争：一次释放加一次获取 */
+	htBenchStatInit(&xStat);
+	xPingSem = htSemaphoreCreateBinary();
+	xPongSem = htSemaphoreCreateBinary();
+	if (xPingSem != NULL && xPongSem != NULL) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htSemaphoreGive(xPingSem);
+				(void)htSemaphoreTake(xPingSem, 0);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+	}
+	htBenchReport("semaphore_give_take", "contended", 0, &xStat);
+
+	/* 有竞争：一次往返 */
+	htBenchStatInit(&xStat);
+	if (xPingSem != NULL && xPongSem != NULL &&
+			htTaskCreate(prvSemPongTask, "b_sem", BENCH_STACK_SIZE, NULL, BENCH_PRIORITY + 1, &xPongTask) == htPASS) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htSemaphoreGive(xPongSem);
+				(void)htSemaphoreTake(xPingSem, htBLOCKED_INDEFINITELY);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+		htTaskDelete(xPongTask);
+	}
+	htBenchReport("semaphore_give_take", "contended", 1, &xStat);
+
+	if (xPingSem != NULL) {
+		htSemaphoreDelete(xPingSem);
+	}
+	if (xPongSem != NULL) {
+		htSemaphoreDelete(xPongSem);
+	}
+}
+
+/**
+ * 互斥量获取/释放开销
+ */
+void htBenchMutex(void)
+{
+	TaskHandle_t xWaiter = NULL;
+	htBenchStat_t xStat;
+	uint32_t ulStart;
+	uint32_t i;
+	uint32_t j;
+
+	xMutex = htSemaphoreCreateMutex();
+
+	/* 无竞争：一次获取加一次释放 */
+	htBenchStatInit(&xStat);
+	if (xMutex != NULL) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htSemaphoreTakeMutex(xMutex, htBLOCKED_INDEFINITELY);
+				(void)htSemaphoreGiveMutex(xMutex);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+	}
+	htBenchReport("mutex_take_give", "contended", 0, &xStat);
+
+	/* 有竞争：持有期间等待者阻塞并继承优先级，释放时交接给等待者 */
+	htBenchStatInit(&xStat);
+	if (xMutex != NULL &&
+			htTaskCreate(prvMutexWaiterTask, "b_mutex", BENCH_STACK_SIZE, NULL, BENCH_PRIORITY + 1, &xWaiter) == htPASS) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htSemaphoreTakeMutex(xMutex, htBLOCKED_INDEFINITELY);
+				(void)htTaskNotifyGive(xWaiter);
+				(void)htSemaphoreGiveMutex(xMutex);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+		htTaskDelete(xWaiter);
+	}
+	htBenchReport("mutex_take_give", "contended", 1, &xStat);
+
+	if (xMutex != NULL) {
+		htSemaphoreDelete(xMutex);
+	}
+
+	xLightMutex = htMutexCreate();
+
+	/* 轻量互斥量，无竞争 */
+	htBenchStatInit(&xStat);
+	if (xLightMutex != NULL) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htMutexLock(xLightMutex, htBLOCKED_INDEFINITELY);
+				(void)htMutexUnlock(xLightMutex);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+	}
+	htBenchReport("mutex_lock_unlock", "contended", 0, &xStat);
+
+	/* 轻量互斥量，有竞争：释放时直接交给等待者 */
+	htBenchStatInit(&xStat);
+	if (xLightMutex != NULL &&
+			htTaskCreate(prvLightMutexWaiterTask, "b_lmutex", BENCH_STACK_SIZE, NULL, BENCH_PRIORITY + 1, &xWaiter) ==
+					htPASS) {
+		for (i = 0; i < BENCH_SAMPLES; i++) {
+			ulStart = htBenchNow();
+			for (j = 0; j < BENCH_BATCH; j++) {
+				(void)htMutexLock(xLightMutex, htBLOCKED_INDEFINITELY);
+				(void)htTaskNotifyGive(xWaiter);
+				(void)htMutexUnlock(xLightMutex);
+			}
+			htBenchStatAdd(&xStat, (htBenchNow() - ulStart) / BENCH_BATCH);
+		}
+		htTaskDelete(xWaiter);
+	}
+	htBenchReport("mutex_lock_unlock", "contended", 1, &xStat);
+
+	if (xLightMutex != NULL) {
+		htMutexDelete(xLightMutex);
+	}
+}
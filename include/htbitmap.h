@@ -0,0 +1,137 @@
+/**
+ * @file htbitmap.h
+ * @brief 优先级位图 - 用前导零计数(CLZ)在O(1)时间内找到最高优先级
+ *
+ * - configMAX_PRIORITIES <= 32：单级位图，一个32位字，查找只需一次CLZ
+ * - configMAX_PRIORITIES > 32：两级位图，一级字(ulGroups)的第g位表示
+ *   二级字ulWords[g]非空，最多支持32*32=1024个优先级，查找只需两次CLZ
+ *
+ * 无论配置多少个优先级，置位/清位/查找的开销都是常数。
+ */
+#ifndef HT_BITMAP_H
+#define HT_BITMAP_H
+
+#include "httypes.h"
+
+#if configMAX_PRIORITIES > 1024
+#error "htbitmap: configMAX_PRIORITIES must not exceed 1024"
+#endif
+
+/**
+ * 前导零计数，移植层可预先定义以使用其他实现
+ * 注意：参数为0时结果未定义，调用者必须保证非0
+ */
+#ifndef htPortCountLeadingZeros
+#if defined(__CC_ARM)
+#define htPortCountLeadingZeros(ulValue) ((UBaseType_t)__clz(ulValue))
+#elif defined(__GNUC__) || defined(__clang__)
+#define htPortCountLeadingZeros(ulValue) ((UBaseType_t)__builtin_clz(ulValue))
+#else
+static inline UBaseType_t htPortCountLeadingZeros(uint32_t ulValue)
+{
+	UBaseType_t uxZeros = 0;
+	while ((ulValue & 0x80000000UL) == 0) {
+		ulValue <<= 1;
+		uxZeros++;
+	}
+	return uxZeros;
+}
+#endif
+#endif
+
+/* 最高置位位的位置(0-31) */
+#define htBITMAP_TOP_BIT(ulValue) (31U - htPortCountLeadingZeros(ulValue))
+
+/* 二级字数量 */
+#define htBITMAP_WORDS ((configMAX_PRIORITIES + 31U) / 32U)
+
+/* 优先级位图结构 */
+typedef struct htPriorityBitmap {
+#if configMAX_PRIORITIES > 32
+	uint32_t ulGroups; /* 一级位图：第g位表示ulWords[g]非空 */
+#endif
+	uint32_t ulWords[htBITMAP_WORDS]; /* 二级位图：每位对应一个优先级 */
+} htPriorityBitmap_t;
+
+/**
+ * 清空位图
+ * @param pxBitmap 位图指针
+ */
+static inline void htBitmapInit(htPriorityBitmap_t *pxBitmap)
+{
+	UBaseType_t uxWord;
+
+#if configMAX_PRIORITIES > 32
+	pxBitmap->ulGroups = 0;
+#endif
+	for (uxWord = 0; uxWord < htBITMAP_WORDS; uxWord++) {
+		pxBitmap->ulWords[uxWord] = 0;
+	}
+}
+
+/**
+ * 标记某优先级非空
+ * @param pxBitmap 位图指针
+ * @param uxPriority 优先级
+ */
+static inline void htBitmapSet(htPriorityBitmap_t *pxBitmap, UBaseType_t uxPriority)
+{
+	pxBitmap->ulWords[uxPriority >> 5] |= (1UL << (uxPriority & 31U));
+#if configMAX_PRIORITIES > 32
+	pxBitmap->ulGroups |= (1UL << (uxPriority >> 5));
+#endif
+}
+
+/**
+ * 标记某优先级为空
+ * @param pxBitmap 位图指针
+ * @param uxPriority 优先级
+ */
+static inline void htBitmapClear(htPriorityBitmap_t *pxBitmap, UBaseType_t uxPriority)
+{
+	pxBitmap->ulWords[uxPriority >> 5] &= ~(1UL << (uxPriority & 31U));
+#if configMAX_PRIORITIES > 32
+	if (pxBitmap->ulWords[uxPriority >> 5] == 0) {
+		pxBitmap->ulGroups &= ~(1UL << (uxPriority >> 5));
+	}
+#endif
+}
+
+/**
+ * 查询位图是否为空
+ * @param pxBitmap 位图指针
+ * @return htTRUE表示没有任何优先级被标记
+ */
+static inline BaseType_t htBitmapIsEmpty(const htPriorityBitmap_t *pxBitmap)
+{
+#if configMAX_PRIORITIES > 32
+	return (pxBitmap->ulGroups == 0) ? htTRUE : htFALSE;
+#else
+	return (pxBitmap->ulWords[0] == 0) ? htTRUE : htFALSE;
+#endif
+}
+
+/**
+ * 获取最高的被标记优先级
+ * @param pxBitmap 位图指针
+ * @return 最高优先级，位图为空时返回0
+ */
+static inline UBaseType_t htBitmapGetHighest(const htPriorityBitmap_t *pxBitmap)
+{
+#if configMAX_PRIORITIES > 32
+	UBaseType_t uxGroup;
+
+	if (pxBitmap->ulGroups == 0) {
+		return 0;
+	}
+	uxGroup = htBITMAP_TOP_BIT(pxBitmap->ulGroups);
+	return (uxGroup << 5) + htBITMAP_TOP_BIT(pxBitmap->ulWords[uxGroup]);
+#else
+	if (pxBitmap->ulWords[0] == 0) {
+		return 0;
+	}
+	return htBITMAP_TOP_BIT(pxBitmap->ulWords[0]);
+#endif
+}
+
+#endif /* HT_BITMAP_H */
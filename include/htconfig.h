@@ -1,39 +1,171 @@
 /**
  * @file htconfig.h
  * @brief htOS配置文件
+ *
+ * 每项配置都可以在编译命令行或包含本文件之前预先定义来覆盖，
+ * 主机测试和性能测试据此使用不同的堆大小等参数而不修改本文件。
  */
 #ifndef HT_CONFIG_H
 #define HT_CONFIG_H
 
 /* 系统时钟配置 */
+#ifndef configTICK_RATE_HZ
 #define configTICK_RATE_HZ 1000 /* 系统滴答频率，单位Hz */
+#endif
+#ifndef configMAX_PRIORITIES
 #define configMAX_PRIORITIES 32 /* 最大支持的任务优先级 */
+#endif
+#ifndef configMINIMAL_STACK_SIZE
 #define configMINIMAL_STACK_SIZE 128 /* 最小任务栈大小(字) */
+#endif
+#ifndef configMAX_TASK_NAME_LEN
 #define configMAX_TASK_NAME_LEN 16 /* 任务名最大长度 */
+#endif
+#ifndef configUSE_PREEMPTION
 #define configUSE_PREEMPTION 1 /* 使用抢占式调度 */
+#endif
+#ifndef configUSE_TIME_SLICING
 #define configUSE_TIME_SLICING 1 /* 使用时间片调度 */
+#endif
+#ifndef configTIME_SLICE_TICKS
+#define configTIME_SLICE_TICKS 1 /* 默认时间片长度(tick)，可用htTaskSetTimeSlice()按任务修改 */
+#endif
+
+/* 中断优先级配置（Cortex-M，8位BASEPRI格式，数值越小优先级越高，只有高__NVIC_PRIO_BITS位有效） */
+#ifndef configKERNEL_INTERRUPT_PRIORITY
+#define configKERNEL_INTERRUPT_PRIORITY 0xFF /* PendSV的优先级，必须是最低 */
+#endif
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY 0x50 /* 临界区只屏蔽优先级数值不小于此值的中断；更高优先级的中断不受内核影响，但不能调用任何内核API */
+#endif
+
+/* 低功耗配置 */
+#ifndef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE 0 /* 使用无滴答空闲：所有任务阻塞时停掉周期性滴答，一次睡到下一个唤醒时间 */
+#endif
+#ifndef configEXPECTED_IDLE_TIME_BEFORE_SLEEP
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2 /* 预计空闲tick数不少于此值才进入无滴答睡眠 */
+#endif
+
+/* 延时定时轮配置（O(1)插入/到期，见httimewheel.h） */
+#ifndef configTIMEWHEEL_SLOT_BITS
+#define configTIMEWHEEL_SLOT_BITS 4 /* 每级槽数的位数，每级2^4=16个槽，最大5 */
+#endif
+#ifndef configTIMEWHEEL_LEVELS
+#define configTIMEWHEEL_LEVELS 4 /* 级数，直接覆盖2^(4*4)=65536个tick，更远的延时暂存于溢出列表 */
+#endif
+
+/* 软件定时器配置 */
+#ifndef configUSE_TIMERS
+#define configUSE_TIMERS 0 /* 使用软件定时器，启动调度器时创建一个守护任务统一处理 */
+#endif
+#ifndef configTIMER_TASK_PRIORITY
+#define configTIMER_TASK_PRIORITY (configMAX_PRIORITIES - 1) /* 定时器守护任务优先级 */
+#endif
+#ifndef configTIMER_TASK_STACK_DEPTH
+#define configTIMER_TASK_STACK_DEPTH 256 /* 定时器守护任务栈大小(字)，回调函数运行在此栈上 */
+#endif
+#ifndef configTIMER_QUEUE_LENGTH
+#define configTIMER_QUEUE_LENGTH 8 /* 定时器命令队列长度 */
+#endif
+
+/* 栈使用分析配置 */
+#ifndef configSTACK_FILL_PATTERN
+#define configSTACK_FILL_PATTERN 0xA5A5A5A5UL /* 创建任务时用此值填充整个栈，从未被改写的字即为从未用到的栈 */
+#endif
+#ifndef configIDLE_STACK_SCAN_PERIOD
+#define configIDLE_STACK_SCAN_PERIOD 0 /* 空闲任务每隔多少tick扫描一次所有任务的栈，0表示不扫描 */
+#endif
+#ifndef configSTACK_LOW_WATERMARK
+#define configSTACK_LOW_WATERMARK 32 /* 扫描发现剩余栈少于此字数且比上次更少时打印警告 */
+#endif
+#ifndef configSTACK_REPORT_MARGIN
+#define configSTACK_REPORT_MARGIN 25 /* 栈报告中建议的栈大小 = 峰值用量 + 此百分比的余量 */
+#endif
+#ifndef configCHECK_FOR_STACK_OVERFLOW
+#define configCHECK_FOR_STACK_OVERFLOW 2 /* 任务切换时检查切出任务的栈：0不检查，1检查保存的栈指针是否在栈区内，2另外检查栈底的哨兵字 */
+#endif
+#ifndef configSTACK_CANARY_WORDS
+#define configSTACK_CANARY_WORDS 4 /* 检查级别2时栈底作为哨兵的字数，不再是填充图案即视为溢出 */
+#endif
 
 /* 内存管理配置 - 调整堆内存大小 */
+#ifndef configTOTAL_HEAP_SIZE
 #define configTOTAL_HEAP_SIZE (12 * 1024) /*12KB */
+#endif
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION 1 /* 支持从堆创建任务和内核对象；为0时htmem.c整体不参与编译，内核任务使用静态存储 */
+#endif
+#ifndef configSUPPORT_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION 1 /* 支持xxxCreateStatic接口，TCB、栈和对象存储区由调用者提供 */
+#endif
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0 && configSUPPORT_STATIC_ALLOCATION == 0
+#error "configSUPPORT_DYNAMIC_ALLOCATION和configSUPPORT_STATIC_ALLOCATION至少启用一个"
+#endif
 
 /* 调试配置 */
+#ifndef configUSE_TRACE_FACILITY
 #define configUSE_TRACE_FACILITY 1 /* 使用跟踪功能 */
-#define configGENERATE_RUN_TIME_STATS 0 /* 生成运行时统计信息 */
+#endif
+#ifndef configGENERATE_RUN_TIME_STATS
+#define configGENERATE_RUN_TIME_STATS 0 /* 生成运行时统计信息：任务切换时按移植层高精度计数器累计各任务运行时间 */
+#endif
+#ifndef configRUN_TIME_STATS_WINDOW
+#define configRUN_TIME_STATS_WINDOW 10 /* CPU使用率统计窗口(秒)，每秒采样一次，保留最近N个采样 */
+#endif
+#ifndef configUSE_STATS_FORMATTING_FUNCTIONS
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0 /* 使用统计信息格式化函数 */
+#endif
 
 /* 钩子函数配置 */
+#ifndef configUSE_IDLE_HOOK
 #define configUSE_IDLE_HOOK 0 /* 使用空闲钩子 */
+#endif
+#ifndef configUSE_TICK_HOOK
 #define configUSE_TICK_HOOK 0 /* 使用滴答钩子 */
+#endif
+#ifndef configUSE_STACK_OVERFLOW_HOOK
+#define configUSE_STACK_OVERFLOW_HOOK 0 /* 栈溢出时调用vApplicationStackOverflowHook()，为0时打印任务名后停机 */
+#endif
+#ifndef configUSE_MALLOC_FAILED_HOOK
 #define configUSE_MALLOC_FAILED_HOOK 0 /* 使用内存分配失败钩子 */
+#endif
 
 /* 功能开关 */
+#ifndef configUSE_MUTEXES
 #define configUSE_MUTEXES 1 /* 使用互斥锁 */
+#endif
+#ifndef configUSE_RECURSIVE_MUTEXES
 #define configUSE_RECURSIVE_MUTEXES 1 /* 使用递归互斥锁 */
+#endif
+#ifndef configUSE_COUNTING_SEMAPHORES
 #define configUSE_COUNTING_SEMAPHORES 1 /* 使用计数信号量 */
+#endif
+#ifndef configUSE_QUEUE_SETS
 #define configUSE_QUEUE_SETS 0 /* 使用队列集 */
+#endif
+#ifndef configUSE_TASK_NOTIFICATIONS
 #define configUSE_TASK_NOTIFICATIONS 1 /* 使用任务通知 */
+#endif
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 1 /* 每个任务的通知槽数量 */
+#endif
+#ifndef configUSE_PERIODIC_TASKS
+#define configUSE_PERIODIC_TASKS 1 /* 周期任务接口：按绝对时间释放，统计释放抖动、最坏响应时间和截止时间错过次数 */
+#endif
+#ifndef configUSE_TASK_REGISTRY
+#define configUSE_TASK_REGISTRY 0 /* htOSStart()创建HT_TASK_DEFINE定义的所有任务，见htregistry.h */
+#endif
+#ifndef configUSE_EVENT_GROUPS
+#define configUSE_EVENT_GROUPS 1 /* 使用事件组 */
+#endif
 
 /* 空闲任务配置 */
+#ifndef configDEBUG_IDLE_STATS
 #define configDEBUG_IDLE_STATS 0 /* 启用空闲任务状态打印 */
+#endif
+#ifndef configDEBUG_TASK_CREATE
+#define configDEBUG_TASK_CREATE 1 /* 创建任务时打印栈地址 */
+#endif
 
 #endif /* HT_CONFIG_H */
@@ -0,0 +1,71 @@
+/**
+ * @file hteventgroup.h
+ * @brief 事件组 - 一个任务同时等待多个条件中的任意一个或全部
+ *
+ * 每个事件组有32个事件位，全部可供用户使用（等待条件保存在等待任务的TCB中，不占用事件位）。
+ * 一次置位操作在同一个临界区内检查所有等待者，唤醒全部条件已满足的任务，
+ * 并统一清除它们要求退出时清除的位。
+ */
+#ifndef HT_EVENTGROUP_H
+#define HT_EVENTGROUP_H
+
+#include "httypes.h"
+#include "htwait.h"
+
+/* 事件位类型 */
+typedef uint32_t EventBits_t;
+
+/* 事件组结构 */
+typedef struct htEventGroup
+{
+    volatile EventBits_t uxEventBits;  /* 当前事件位 */
+    htWaitQueue_t xTasksWaitingForBits; /* 等待事件位的任务 */
+    uint8_t ucStaticallyAllocated;      /* 存储区由调用者提供，删除时不释放 */
+} htEventGroup_t;
+
+/* 事件组句柄类型 */
+typedef htEventGroup_t *EventGroupHandle_t;
+
+/* 静态创建事件组时由调用者提供的存储区 */
+typedef htEventGroup_t htStaticEventGroup_t;
+
+/* API函数原型 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+EventGroupHandle_t htEventGroupCreate(void);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/* 使用调用者提供的存储区创建事件组，不访问堆 */
+EventGroupHandle_t htEventGroupCreateStatic(htStaticEventGroup_t *pxEventGroupBuffer);
+#endif
+void htEventGroupDelete(EventGroupHandle_t xEventGroup);
+
+/**
+ * 等待事件位
+ * @param xEventGroup 事件组
+ * @param uxBitsToWaitFor 等待的位，不能为0
+ * @param xClearOnExit htTRUE时条件满足后清除uxBitsToWaitFor
+ * @param xWaitForAllBits htTRUE时等待全部位，否则等待任意一位
+ * @param xTicksToWait 最长等待tick数
+ * @return 条件满足时的事件位(清除前)；超时返回当前事件位，调用者据此判断是否满足
+ */
+EventBits_t htEventGroupWaitBits(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToWaitFor, BaseType_t xClearOnExit,
+    BaseType_t xWaitForAllBits, TickType_t xTicksToWait);
+
+/**
+ * 置位事件位，并唤醒所有条件已满足的等待者
+ * @return 函数返回时的事件位
+ */
+EventBits_t htEventGroupSetBits(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToSet);
+EventBits_t htEventGroupSetBitsFromISR(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToSet,
+    BaseType_t *pxHigherPriorityTaskWoken);
+
+/**
+ * 清除事件位
+ * @return 清除前的事件位
+ */
+EventBits_t htEventGroupClearBits(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToClear);
+
+/* 读取当前事件位 */
+EventBits_t htEventGroupGetBits(EventGroupHandle_t xEventGroup);
+
+#endif /* HT_EVENTGROUP_H */
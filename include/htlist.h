@@ -25,4 +25,7 @@ htListItem_t *htListGetHead(htList_t *pxList);
 htListItem_t *htListGetFirstListItem(htList_t *pxList);
 UBaseType_t htListGetCurrentNumberOfItems(htList_t *pxList);
 
+/* 游标移到下一项(跳过表尾)并返回其所有者，用于轮转；链表不能为空 */
+void *htListGetOwnerOfNextEntry(htList_t *pxList);
+
 #endif /* HTLIST_H */
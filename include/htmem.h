@@ -153,6 +153,4 @@ size_t htGetFreeHeapSize(void);
  */
 size_t htGetMinimumEverFreeHeapSize(void);
 
-static inline int tlsf_block_within_heap(const block_header_t *block);
-
 #endif /* HT_MEM_H */
@@ -0,0 +1,73 @@
+/**
+ * @file htmutex.h
+ * @brief 轻量互斥量 - 不经过队列，持有者直接记录在对象中
+ *
+ * 无竞争时获取和释放各只需一次原子比较交换(Cortex-M上为LDREX/STREX，主机上为C11原子操作)，
+ * 不进入临界区。互斥量被持有时获取者进入临界区，在持有者字上置位等待标志、把等待队列挂到
+ * 持有者的pxMutexesHeld链表上、提升持有者的优先级(沿持有链传递)后阻塞；持有者释放时快速路径
+ * 因等待标志而失败，转入临界区把互斥量直接交给优先级最高的等待者，并按仍持有的其他互斥量的
+ * 等待者重新计算自己的优先级。
+ *
+ * 只有有等待者时等待队列才登记持有者、挂到pxMutexesHeld上：只有这样的互斥量影响继承的优先级，
+ * 无竞争的获取和释放因此不需要修改链表。所有互斥量在创建时登记到一个链表中，删除任务时
+ * 遍历它找到任务仍持有的互斥量(包括无竞争持有的)，交给等待者或变为空闲。
+ *
+ * 只能在任务中使用，不支持递归获取；同一任务重复获取时立即返回失败。
+ */
+#ifndef HT_MUTEX_H
+#define HT_MUTEX_H
+
+#include "httypes.h"
+#include "htwait.h"
+
+/* 持有者字的最低位：有任务在等待，释放时必须走慢速路径(TCB地址至少4字节对齐) */
+#define htMUTEX_HAS_WAITERS ((uintptr_t)1U)
+
+/* 互斥量结构 */
+typedef struct htMutex
+{
+    volatile uintptr_t uxOwner;  /* 持有者TCB地址 | htMUTEX_HAS_WAITERS，0表示空闲 */
+    htWaitQueue_t xWaiters;      /* 等待获取的任务，按优先级排列；有等待者时pxOwner与持有者一致 */
+    struct htMutex *pxNextMutex; /* 所有互斥量链表中的下一个 */
+    uint8_t ucStaticallyAllocated; /* 存储区由调用者提供，删除时不释放 */
+} htMutex_t;
+
+/* 互斥量句柄类型 */
+typedef htMutex_t *MutexHandle_t;
+
+/* 静态创建互斥量时由调用者提供的存储区 */
+typedef htMutex_t htStaticMutex_t;
+
+/* API函数原型 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+MutexHandle_t htMutexCreate(void);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/* 使用调用者提供的存储区创建互斥量，不访问堆 */
+MutexHandle_t htMutexCreateStatic(htStaticMutex_t *pxMutexBuffer);
+#endif
+
+/* 删除互斥量，只能删除空闲(未被持有)的互斥量 */
+void htMutexDelete(MutexHandle_t xMutex);
+
+/**
+ * 获取互斥量
+ * @param xMutex 互斥量
+ * @param xTicksToWait 被其他任务持有时最长等待tick数，0表示不等待
+ * @return htPASS表示已获取；超时、重复获取、参数无效或调度器未启动时返回htFAIL
+ */
+BaseType_t htMutexLock(MutexHandle_t xMutex, TickType_t xTicksToWait);
+
+/**
+ * 释放互斥量，有任务在等待时直接交给优先级最高的等待者
+ * @return htPASS表示已释放；当前任务不是持有者时返回htFAIL
+ */
+BaseType_t htMutexUnlock(MutexHandle_t xMutex);
+
+/* 查询持有者，空闲时返回NULL */
+TaskHandle_t htMutexGetOwner(MutexHandle_t xMutex);
+
+/* 删除任务时由htTaskDelete()调用：任务仍持有的互斥量交给优先级最高的等待者，没有等待者时变为空闲 */
+void htMutexReleaseAll(htTCB_t *pxTCB);
+
+#endif /* HT_MUTEX_H */
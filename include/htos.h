@@ -30,6 +30,8 @@ int htOSStart(void);
 
 
 
+/* 兼容旧API的创建函数都从堆分配，只在configSUPPORT_DYNAMIC_ALLOCATION为1时提供 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建新任务（兼容旧API）
  * 
@@ -42,6 +44,7 @@ int htOSStart(void);
  */
 TaskHandle_t htOSTaskCreate(const char* name, void (*function)(void*), void* param, 
                   uint32_t stackSize, uint8_t priority);
+#endif
 
 /**
  * 删除任务（兼容旧API）
@@ -51,6 +54,7 @@ TaskHandle_t htOSTaskCreate(const char* name, void (*function)(void*), void* par
  */
 int htOSTaskDelete(TaskHandle_t task);
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建队列（兼容旧API）
  * 
@@ -59,6 +63,7 @@ int htOSTaskDelete(TaskHandle_t task);
  * @return 队列句柄，NULL表示失败
  */
 QueueHandle_t htOSQueueCreate(uint32_t length, uint32_t itemSize);
+#endif
 
 /**
  * 发送数据到队列（兼容旧API）
@@ -80,6 +85,7 @@ int htOSQueueSend(QueueHandle_t queue, const void* item, uint32_t timeout);
  */
 int htOSQueueReceive(QueueHandle_t queue, void* buffer, uint32_t timeout);
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建二值信号量（兼容旧API）
  * 
@@ -93,6 +99,7 @@ SemaphoreHandle_t htOSSemaphoreCreateBinary(void);
  * @return 互斥锁句柄，NULL表示失败
  */
 SemaphoreHandle_t htOSMutexCreate(void);
+#endif
 
 /**
  * 获取信号量/互斥锁（兼容旧API）
@@ -4,6 +4,7 @@
 #include "httypes.h"
 #include "htlist.h"
 #include "httask.h"
+#include "htwait.h"
 
 /* 队列指针数据结构 */
 typedef struct htQueuePointers
@@ -16,6 +17,7 @@ typedef struct htQueuePointers
 typedef struct htSemaphoreData
 {
     UBaseType_t uxSemaphoreCount;  /* 信号量计数值 */
+    htTCB_t *pxMutexHolder;        /* 互斥量持有者，非互斥量或未被持有时为NULL */
 } htSemaphoreData_t;
 
 /* 记录递归互斥量所有者和递归计数的结构 */
@@ -23,8 +25,6 @@ typedef struct htMutexHolder
 {
     htTCB_t* xTaskHandle;
     UBaseType_t uxRecursiveCallCount;
-    //用于优先级继承
-    UBaseType_t uxOriginalPriority;
 } htMutexHolder_t;
 
 /* 队列定义结构 */
@@ -39,8 +39,8 @@ typedef struct htQueueDefinition
         htSemaphoreData_t xSemaphore; /* 信号量特有数据 */
     } u;
 
-    htList_t xTasksWaitingToSend;     /* 等待发送的任务列表 */
-    htList_t xTasksWaitingToReceive;  /* 等待接收的任务列表 */
+    htWaitQueue_t xTasksWaitingToSend;     /* 等待发送的任务 */
+    htWaitQueue_t xTasksWaitingToReceive;  /* 等待接收的任务 */
 
     volatile UBaseType_t uxMessagesWaiting; /* 当前队列中的消息数量 */
     UBaseType_t uxLength;                   /* 队列长度（项目数量） */
@@ -48,18 +48,34 @@ typedef struct htQueueDefinition
 
     volatile int8_t cRxLock;                /* 队列接收锁 */
     volatile int8_t cTxLock;                /* 队列发送锁 */
+    uint8_t ucStaticallyAllocated;          /* 队列结构和存储区由调用者提供，删除时不释放 */
 
 } htQUEUE_t;
 
 /* 队列句柄类型 */
 typedef htQUEUE_t *QueueHandle_t;
 
+/* 静态创建队列时由调用者提供的队列结构存储区 */
+typedef htQUEUE_t htStaticQueue_t;
+
 /* 常量定义 */
 #define htQUEUE_UNLOCKED    ((int8_t) -1)
 #define htQUEUE_LOCKED      ((int8_t) 0)
 
 /* API函数原型 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 QueueHandle_t htQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建队列，不访问堆
+ * @param pucQueueStorage 消息存储区，至少uxQueueLength * uxItemSize字节；uxItemSize为0时可为NULL
+ * @param pxQueueBuffer 队列结构存储区
+ * @return 队列句柄，参数无效时返回NULL
+ */
+QueueHandle_t htQueueCreateStatic(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t *pucQueueStorage,
+    htStaticQueue_t *pxQueueBuffer);
+#endif
 void htQueueDelete(QueueHandle_t xQueue);
 
 BaseType_t htQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait);
@@ -72,4 +88,7 @@ UBaseType_t htQueueMessagesWaiting(QueueHandle_t xQueue);
 BaseType_t htQueueReset(QueueHandle_t xQueue);
 BaseType_t htQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
 
+/* 设置等待任务的唤醒顺序(htWAIT_ORDER_PRIORITY/htWAIT_ORDER_FIFO)，信号量句柄同样适用 */
+BaseType_t htQueueSetWaitOrder(QueueHandle_t xQueue, UBaseType_t uxOrder);
+
 #endif /* HT_QUEUE_H */
@@ -0,0 +1,75 @@
+/**
+ * @file htregistry.h
+ * @brief 链接期任务表 - 用HT_TASK_DEFINE在任意源文件中定义任务，htOSStart()统一创建
+ *
+ * 每个HT_TASK_DEFINE生成一个const任务描述符放入htTasks段（与lettershell的SHELL_EXPORT_CMD相同的做法），
+ * 以及静态的TCB和栈。链接器把所有描述符拼成一张表，描述符留在flash中，
+ * 启动时按表调用htTaskCreateStatic()，不访问堆，也不需要在main()中逐个创建。
+ *
+ * GCC下由链接器自动生成__start_htTasks/__stop_htTasks，链接脚本使用--gc-sections时需要KEEP(*(htTasks))；
+ * Keil使用htTasks$$Base/htTasks$$Limit，IAR使用__section_begin/__section_end，
+ * 这两种工具链下没有定义任何任务时段符号不存在，链接失败。
+ *
+ * 默认关闭，使用HT_TASK_DEFINE的工程需要把configUSE_TASK_REGISTRY设为1。
+ */
+#ifndef HT_REGISTRY_H
+#define HT_REGISTRY_H
+
+#include "httypes.h"
+#include "httask.h"
+
+#if configUSE_TASK_REGISTRY == 1
+
+#if configSUPPORT_STATIC_ALLOCATION == 0
+#error "configUSE_TASK_REGISTRY需要configSUPPORT_STATIC_ALLOCATION"
+#endif
+
+#if defined(__CC_ARM) || defined(__CLANG_ARM) || defined(__GNUC__)
+#define HT_REGISTRY_USED __attribute__((used))
+/* 按指针对齐，防止编译器为较大的对象提高对齐而在表项之间留下空隙 */
+#define HT_REGISTRY_SECTION(x) __attribute__((section(x), aligned(sizeof(void *))))
+#elif defined(__IAR_SYSTEMS_ICC__)
+#define HT_REGISTRY_USED __root
+#define HT_REGISTRY_SECTION(x) @x
+#else
+#error "链接期任务表不支持当前编译器，请把configUSE_TASK_REGISTRY设为0"
+#endif
+
+/* 任务描述符，放在htTasks段中，只读 */
+typedef struct htTaskDescriptor {
+	const char *pcName; /* 任务名称 */
+	TaskFunction_t pxTaskCode; /* 任务函数，参数为NULL */
+	StackType_t *puxStackBuffer; /* 静态栈 */
+	htTCB_t *pxTaskBuffer; /* 静态TCB */
+	uint16_t usStackDepth; /* 栈大小(字) */
+	UBaseType_t uxPriority; /* 任务优先级 */
+} htTaskDescriptor_t;
+
+/**
+ * 定义一个随htOSStart()启动的任务
+ * @param name 任务名称，同时用于生成符号名，必须是合法的标识符且全局唯一
+ * @param fn 任务函数
+ * @param stack 栈大小(字)
+ * @param prio 任务优先级
+ */
+#define HT_TASK_DEFINE(name, fn, stack, prio) \
+	static StackType_t htTaskStack_##name[(stack)]; \
+	htTCB_t htTaskTCB_##name; \
+	HT_REGISTRY_USED const htTaskDescriptor_t htTaskDesc_##name HT_REGISTRY_SECTION("htTasks") = { \
+		#name, (fn), htTaskStack_##name, &htTaskTCB_##name, (stack), (prio) \
+	}
+
+/* 在其他源文件中引用HT_TASK_DEFINE定义的任务 */
+#define HT_TASK_DECLARE(name) extern htTCB_t htTaskTCB_##name
+/* HT_TASK_DEFINE定义的任务的句柄，任务创建前后都不变 */
+#define HT_TASK_HANDLE(name) ((TaskHandle_t)&htTaskTCB_##name)
+
+/**
+ * 创建任务表中的所有任务，由htOSStart()调用
+ * @return 创建的任务数
+ */
+UBaseType_t htTaskCreateRegistered(void);
+
+#endif /* configUSE_TASK_REGISTRY == 1 */
+
+#endif /* HT_REGISTRY_H */
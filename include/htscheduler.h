@@ -14,6 +14,21 @@ void htSuspendScheduler(void);
 /* 恢复调度器 */
 void htResumeScheduler(void);
 
+/* 挂起调度器（嵌套计数），挂起期间的任务切换请求延迟到恢复时执行 */
+UBaseType_t htSchedulerSuspend(void);
+
+/* 恢复调度器，处理挂起期间中断唤醒的任务和推迟的到期 */
+void htSchedulerResume(void);
+
+/* 调度器是否被挂起，挂起期间唤醒的任务先进入待就绪列表 */
+BaseType_t htSchedulerIsSuspended(void);
+
+/* 请求任务切换，当前任务让出本轮给同优先级的下一个就绪任务，可在中断中调用 */
+void htSchedulerRotate(void);
+
+/* 是否有比当前任务优先级更高的任务就绪 */
+BaseType_t htSchedulerNeedsSwitch(void);
+
 /* 系统滴答处理函数 */
 void htSchedulerTickHandler(void);
 
@@ -23,6 +38,12 @@ void htEnterCritical(void);
 /* 内核退出临界区 */
 void htExitCritical(void);
 
+/* 中断中进入临界区，返回进入前的屏蔽状态 */
+UBaseType_t htEnterCriticalFromISR(void);
+
+/* 中断中退出临界区，恢复进入前的屏蔽状态 */
+void htExitCriticalFromISR(UBaseType_t uxSavedMask);
+
 /* 临界区嵌套计数器 */
 extern volatile UBaseType_t uxCriticalNesting;
 /* 任务调度 */
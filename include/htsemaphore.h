@@ -9,6 +9,14 @@
 /* 信号量句柄定义 */
 typedef QueueHandle_t SemaphoreHandle_t;
 
+/* 静态创建信号量时由调用者提供的存储区 */
+typedef struct htStaticSemaphore
+{
+    htQUEUE_t xQueue;             /* 信号量本体，句柄指向这里 */
+    htMutexHolder_t xMutexHolder; /* 递归互斥量的持有者信息，其他类型不使用 */
+} htStaticSemaphore_t;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /* 二值信号量创建函数 */
 SemaphoreHandle_t htSemaphoreCreateBinary(void);
 
@@ -18,6 +26,16 @@ SemaphoreHandle_t htSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t
 /* 互斥量创建函数 */
 SemaphoreHandle_t htSemaphoreCreateMutex(void);
 SemaphoreHandle_t htSemaphoreCreateRecursiveMutex(void);
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/* 使用调用者提供的存储区创建，不访问堆；存储区在删除信号量之前必须一直有效，参数无效时返回NULL */
+SemaphoreHandle_t htSemaphoreCreateBinaryStatic(htStaticSemaphore_t *pxSemaphoreBuffer);
+SemaphoreHandle_t htSemaphoreCreateCountingStatic(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount,
+    htStaticSemaphore_t *pxSemaphoreBuffer);
+SemaphoreHandle_t htSemaphoreCreateMutexStatic(htStaticSemaphore_t *pxSemaphoreBuffer);
+SemaphoreHandle_t htSemaphoreCreateRecursiveMutexStatic(htStaticSemaphore_t *pxSemaphoreBuffer);
+#endif
 
 /* 信号量删除函数 */
 void htSemaphoreDelete(SemaphoreHandle_t xSemaphore);
@@ -37,7 +55,7 @@ BaseType_t htSemaphoreTakeRecursive(SemaphoreHandle_t xSemaphore, TickType_t xTi
 BaseType_t htSemaphoreGive(SemaphoreHandle_t xSemaphore);
 BaseType_t htSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken);
 
-/* 互斥量释放 */
+/* 互斥量释放，只有持有者能释放，否则返回htFAIL */
 BaseType_t htSemaphoreGiveMutex(SemaphoreHandle_t xSemaphore);
 
 /* 递归互斥量释放 */
@@ -46,4 +64,7 @@ BaseType_t htSemaphoreGiveRecursive(SemaphoreHandle_t xSemaphore);
 /* 获取信号量计数值 */
 UBaseType_t htSemaphoreGetCount(SemaphoreHandle_t xSemaphore);
 
+/* 删除任务时由htTaskDelete()调用：任务仍持有的互斥量和递归互斥量恢复为可用，并唤醒一个等待者 */
+void htSemaphoreReleaseAll(htTCB_t *pxTCB);
+
 #endif /* HT_SEMAPHORE_H */
@@ -3,12 +3,21 @@
 
 #include "httypes.h"
 #include "htlist.h"
+#include "htbitmap.h"
 
-#define htPortStartFirstTask vPortStartFirstTask
+struct htWaitQueue;
 
 /* 任务函数类型定义 */
 typedef void (*TaskFunction_t)(void *pvParameters);
 
+/* 周期任务的时序统计，单位均为tick */
+typedef struct htPeriodicStats {
+	uint32_t ulReleases; /* 已释放的周期数 */
+	uint32_t ulDeadlineMisses; /* 错过截止时间的周期数，包括因超时而被跳过的周期 */
+	TickType_t xMaxReleaseJitter; /* 最大释放抖动：释放时刻到任务实际开始运行 */
+	TickType_t xWorstResponseTime; /* 最坏响应时间：释放时刻到调用htTaskWaitForNextPeriod() */
+} htPeriodicStats_t;
+
 /* 任务控制块(TCB)结构 */
 typedef struct htTaskControlBlock {
 	StackType_t *pxTopOfStack; /* 任务堆栈指针,注意任务堆栈必须在第一个，否则无法切换 */
@@ -20,14 +29,58 @@ typedef struct htTaskControlBlock {
 	char pcTaskName[configMAX_TASK_NAME_LEN]; /* 任务名称 */
 	UBaseType_t uxTaskState; /* 任务状态 */
 	UBaseType_t uxBasePriority; /* 任务基础优先级(用于优先级继承) */
-	uint32_t ulNotifiedValue; /* 任务通知值 */
-	UBaseType_t uxNotificationStatus; /* 任务通知状态 */
-	uint32_t ulRunTimeCounter; /* 任务运行时间计数 */
+#if configUSE_TIME_SLICING == 1
+	UBaseType_t uxTimeSlice; /* 时间片长度(tick) */
+	UBaseType_t uxTimeSliceLeft; /* 本轮剩余的tick数，被更高优先级任务抢占时保留 */
+#endif
+#if configUSE_TASK_NOTIFICATIONS == 1
+	volatile uint32_t ulNotifiedValue[configTASK_NOTIFICATION_ARRAY_ENTRIES]; /* 各通知槽的通知值 */
+	volatile uint8_t ucNotifyState[configTASK_NOTIFICATION_ARRAY_ENTRIES]; /* 各通知槽的状态 */
+#endif
+#if configGENERATE_RUN_TIME_STATS == 1
+	uint64_t ullRunTimeCounter; /* 任务累计运行时间(移植层计数器单位) */
+#endif
 	UBaseType_t uxStackDepth; /* 堆栈深度 */
+	UBaseType_t uxStackHighWaterMark; /* 最近一次扫描得到的历史最小剩余栈(字) */
+	struct htWaitQueue *pxWaitQueue; /* 正在等待的等待队列，未等待时为NULL */
+	BaseType_t xWaitResult; /* 最近一次阻塞的结束原因(htWAIT_SIGNALLED/htWAIT_TIMEOUT) */
+	uint8_t ucStaticallyAllocated; /* TCB和栈由调用者提供，删除时不释放 */
+#if configUSE_PERIODIC_TASKS == 1
+	TickType_t xPeriod; /* 周期(tick)，0表示不是周期任务 */
+	TickType_t xRelativeDeadline; /* 相对截止时间(tick)，从释放时刻算起 */
+	TickType_t xReleaseTime; /* 本周期的释放时刻 */
+	htPeriodicStats_t xPeriodicStats; /* 时序统计 */
+#endif
+	struct htWaitQueue *pxMutexesHeld; /* 持有的互斥量的等待队列链表，用于重新计算继承的优先级 */
+#if configUSE_EVENT_GROUPS == 1
+	uint32_t ulEventWaitBits; /* 等待的事件位；被唤醒时改写为条件满足时的事件位 */
+	uint8_t ucEventWaitFlags; /* 等待方式：全部/任意、退出时是否清除 */
+#endif
 	//   uint32_t ulDelayTime;                   /* 原始延时值，用于调试 */
 
 } htTCB_t;
 
+/* 任务通知动作 */
+typedef enum htNotifyAction {
+	HT_NOTIFY_NO_ACTION = 0, /* 只唤醒，不修改通知值 */
+	HT_NOTIFY_SET_BITS, /* 通知值按位或上ulValue */
+	HT_NOTIFY_INCREMENT, /* 通知值加1，ulValue被忽略 */
+	HT_NOTIFY_OVERWRITE, /* 通知值直接改为ulValue */
+	HT_NOTIFY_NO_OVERWRITE, /* 上一个通知未被取走时失败，否则改为ulValue */
+} htNotifyAction_t;
+
+/* 应用钩子，启用对应配置时由应用程序提供 */
+#if configUSE_IDLE_HOOK == 1
+void vApplicationIdleHook(void);
+#endif
+#if configUSE_TICK_HOOK == 1
+void vApplicationTickHook(void);
+#endif
+#if configCHECK_FOR_STACK_OVERFLOW > 0 && configUSE_STACK_OVERFLOW_HOOK == 1
+/* 在任务切换中调用，xTask为溢出的任务；返回后继续调度 */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, const char *pcTaskName);
+#endif
+
 /* 全局变量声明 */
 extern htTCB_t *pxCurrentTCB; /* 当前运行的任务TCB */
 extern UBaseType_t uxCurrentNumberOfTasks; /* 当前任务数量 */
@@ -35,16 +88,87 @@ extern TickType_t xTickCount; /* 系统tick计数 */
 extern htList_t pxAllocatedTasksList; /* 所有任务列表 */
 /* 就绪列表声明 */
 extern htList_t pxReadyTasksLists[];
+/* 就绪优先级位图：第n位置位表示pxReadyTasksLists[n]非空 */
+extern htPriorityBitmap_t xReadyPriorities;
+
+/* 就绪列表操作 - 所有对就绪列表的插入/移除都必须经过这两个函数以维护位图 */
+void htTaskAddToReadyList(htTCB_t *pxTCB);
+void htTaskRemoveFromReadyList(htTCB_t *pxTCB);
+
+/* 解除阻塞：撤销超时并移入就绪列表，调度器挂起时先放入待就绪列表，调用者负责临界区保护 */
+void htTaskUnblock(htTCB_t *pxTCB);
+/* 把待就绪列表中的任务移入就绪列表，返回移入的任务数，调用者负责临界区保护 */
+UBaseType_t htTaskProcessPendingReady(void);
+/* 定时轮追到xTickCount，处理到期的延时任务，调用者负责临界区保护 */
+void htTaskCheckDelayedTasks(void);
+
+/* 获取最高就绪优先级 - 一次(两级位图时两次)CLZ */
+#define htTaskGetTopReadyPriority() htBitmapGetHighest(&xReadyPriorities)
 
 /* 任务管理相关函数声明 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 BaseType_t htTaskCreate(TaskFunction_t pxTaskCode, const char *const pcName, const uint16_t usStackDepth,
 		void *const pvParameters, UBaseType_t uxPriority, void **const pxCreatedTask);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建任务，不访问堆
+ * @param puxStackBuffer 栈存储区，至少usStackDepth个字，任务删除前必须一直有效
+ * @param pxTaskBuffer TCB存储区，任务删除前必须一直有效
+ * @return 任务句柄，参数无效时返回NULL
+ */
+TaskHandle_t htTaskCreateStatic(TaskFunction_t pxTaskCode, const char *const pcName, const uint16_t usStackDepth,
+		void *const pvParameters, UBaseType_t uxPriority, StackType_t *const puxStackBuffer,
+		htTCB_t *const pxTaskBuffer);
+#endif
 
 void htTaskDelete(TaskHandle_t xTaskToDelete);
 void htTaskDelay(TickType_t xTicksToDelay);
+/* 将当前任务移出就绪列表并按超时放入定时轮，调用者负责临界区保护 */
+void htTaskPlaceOnDelayedList(TickType_t xTicksToWait);
+/**
+ * 延时到绝对时刻*pxPreviousWakeTime + xTimeIncrement，周期不受任务自身执行时间影响
+ * @param pxPreviousWakeTime 上次唤醒时刻，首次调用前初始化为xTickCount，返回时更新为本次唤醒时刻
+ * @return htPASS表示发生了延时；唤醒时刻已过时立即返回htFAIL
+ */
 BaseType_t htTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement);
+#if configUSE_PERIODIC_TASKS == 1
+/**
+ * 把当前任务设为周期任务，调用时刻为第一个周期的释放时刻，同时清零统计
+ * @param xPeriod 周期(tick)，不能为0
+ * @param xRelativeDeadline 相对截止时间(tick)，0表示等于周期
+ */
+BaseType_t htTaskSetPeriodic(TickType_t xPeriod, TickType_t xRelativeDeadline);
+/**
+ * 结束本周期的工作，阻塞到下一个释放时刻
+ * 本周期超出截止时间时计一次错过；已经错过下一个释放时刻时跳过这些周期，
+ * 每跳过一个也计一次错过，保持释放时刻与周期对齐
+ * @return htPASS表示本周期在截止时间内完成，htFAIL表示错过或当前任务不是周期任务
+ */
+BaseType_t htTaskWaitForNextPeriod(void);
+/* 读取周期任务的时序统计，xTask为NULL时为当前任务 */
+BaseType_t htTaskGetPeriodicStats(TaskHandle_t xTask, htPeriodicStats_t *pxStats);
+#endif
 UBaseType_t htTaskPriorityGet(TaskHandle_t xTask);
+#if configUSE_TIME_SLICING == 1
+/* 设置任务的时间片长度(tick)，0表示configTIME_SLICE_TICKS，从下一轮开始生效 */
+void htTaskSetTimeSlice(TaskHandle_t xTask, UBaseType_t uxTicks);
+UBaseType_t htTaskGetTimeSlice(TaskHandle_t xTask);
+#endif
 void htTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority);
+/**
+ * 优先级继承：把互斥量持有者提升到uxPriority，持有者本身阻塞在另一个互斥量上时沿持有链继续提升
+ * 调用者负责临界区保护
+ * @param pxOwner 持有者，为NULL时什么也不做
+ * @param uxPriority 等待者的优先级
+ */
+void htTaskPriorityInherit(htTCB_t *pxOwner, UBaseType_t uxPriority);
+/**
+ * 按基础优先级和仍持有的互斥量中最高的等待者重新计算优先级，用于释放互斥量和等待者超时之后
+ * 优先级改变且任务阻塞在互斥量上时沿持有链继续重新计算，调用者负责临界区保护
+ * @param pxTCB 任务，为NULL时什么也不做
+ */
+void htTaskPriorityUpdate(htTCB_t *pxTCB);
 void htTaskSuspend(TaskHandle_t xTaskToSuspend);
 void htTaskResume(TaskHandle_t xTaskToResume);
 void htTaskResumeFromISR(TaskHandle_t xTaskToResume);
@@ -54,13 +178,53 @@ htTaskStatus_t htTaskGetState(TaskHandle_t xTask);
 void htTaskStartScheduler(void);
 void htTaskEndScheduler(void);
 void htTaskTickInc(void);
+/* 任务通知相关函数声明 - 直接作用于TCB中的通知槽，不需要队列对象 */
+#if configUSE_TASK_NOTIFICATIONS == 1
+BaseType_t htTaskNotifyIndexed(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+		htNotifyAction_t eAction);
+BaseType_t htTaskNotifyIndexedFromISR(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+		htNotifyAction_t eAction, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t htTaskNotifyWaitIndexed(UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry,
+		uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait);
+uint32_t htTaskNotifyTakeIndexed(UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+/* 使用第0个通知槽的简写 */
+#define htTaskNotify(xTaskToNotify, ulValue, eAction) htTaskNotifyIndexed((xTaskToNotify), 0, (ulValue), (eAction))
+#define htTaskNotifyFromISR(xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken) \
+	htTaskNotifyIndexedFromISR((xTaskToNotify), 0, (ulValue), (eAction), (pxHigherPriorityTaskWoken))
+#define htTaskNotifyWait(ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait) \
+	htTaskNotifyWaitIndexed(0, (ulBitsToClearOnEntry), (ulBitsToClearOnExit), (pulNotificationValue), (xTicksToWait))
+#define htTaskNotifyTake(xClearCountOnExit, xTicksToWait) htTaskNotifyTakeIndexed(0, (xClearCountOnExit), (xTicksToWait))
+/* 当作轻量计数信号量使用 */
+#define htTaskNotifyGive(xTaskToNotify) htTaskNotifyIndexed((xTaskToNotify), 0, 0, HT_NOTIFY_INCREMENT)
+#define htTaskNotifyGiveFromISR(xTaskToNotify, pxHigherPriorityTaskWoken) \
+	htTaskNotifyIndexedFromISR((xTaskToNotify), 0, 0, HT_NOTIFY_INCREMENT, (pxHigherPriorityTaskWoken))
+#endif
+/* 无滴答空闲相关函数声明 */
+TickType_t htTaskGetExpectedIdleTime(void);
+BaseType_t htTaskConfirmSleepModeStatus(void);
+void htTaskStepTick(TickType_t xTicksToJump);
+#if configCHECK_FOR_STACK_OVERFLOW > 0
+/* 检查切出任务的栈是否溢出，在任务切换中调用，移植层须先把栈指针保存到TCB */
+void htTaskCheckForStackOverflow(void);
+#endif
+/* 运行时间统计相关函数声明 */
+#if configGENERATE_RUN_TIME_STATS == 1
+/* 把上次记账以来的时间计入当前任务，在任务切换和滴答中断中调用，调用者负责临界区保护 */
+void htTaskAccountRunTime(void);
+/* 任务累计运行时间，xTask为NULL时为当前任务 */
+uint64_t htTaskGetRunTimeCounter(TaskHandle_t xTask);
+/* 所有任务累计运行时间之和 */
+uint64_t htTaskGetTotalRunTime(void);
+/* 最近configRUN_TIME_STATS_WINDOW秒内的总运行时间和空闲任务运行时间 */
+void htTaskGetRunTimeWindow(uint64_t *pullTotal, uint64_t *pullIdle);
+#endif
 /* 任务调度相关函数声明 */
 void htTaskYield(void);
 void htTaskSwitchContext(void);
 // 获取所有任务信息
 htList_t htTaskGetAllTaskInfo(void);
 /* 空闲任务相关函数声明 */
-static void htprvIdleTask(void *pvParameters);
 BaseType_t htprvCreateIdleTask(void);
 
 #endif /* HTTASK_H */
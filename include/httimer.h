@@ -0,0 +1,76 @@
+/**
+ * @file httimer.h
+ * @brief 软件定时器 - 单次/自动重载定时器，由一个守护任务统一处理
+ *
+ * - 活动定时器挂在守护任务私有的定时轮上，同一tick到期的定时器在一批内连续回调
+ * - 启动/停止/修改周期都通过命令队列发给守护任务，任务和ISR中都可以调用
+ * - 回调函数运行在守护任务的栈上，不能阻塞；每个定时器只占几十字节，不需要独立的任务栈
+ */
+#ifndef HT_TIMER_H
+#define HT_TIMER_H
+
+#include "httypes.h"
+#include "htlist.h"
+
+/* 定时器结构 */
+typedef struct htTimer
+{
+    htListItem_t xTimerListItem;   /* 挂在定时轮上，xItemValue为到期时间 */
+    const char *pcTimerName;       /* 定时器名称(调试用) */
+    TickType_t xTimerPeriod;       /* 周期(tick) */
+    void *pvTimerID;               /* 用户标识，多个定时器共用回调时区分 */
+    htTimerCallback_t pxCallbackFunction; /* 到期回调 */
+    uint8_t ucStatus;              /* 自动重载/活动标志 */
+} htTimer_t;
+
+/* 定时器句柄类型 */
+typedef htTimer_t *TimerHandle_t;
+
+/* 静态创建定时器时由调用者提供的存储区 */
+typedef htTimer_t htStaticTimer_t;
+
+/* API函数原型 */
+
+/**
+ * 创建定时器，创建后处于停止状态
+ * @param pcTimerName 定时器名称
+ * @param xTimerPeriod 周期(tick)，不能为0
+ * @param xAutoReload htTRUE为自动重载，htFALSE为单次
+ * @param pvTimerID 用户标识
+ * @param pxCallbackFunction 到期回调
+ * @return 定时器句柄，NULL表示失败
+ */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+TimerHandle_t htTimerCreate(const char *pcTimerName, TickType_t xTimerPeriod, BaseType_t xAutoReload,
+    void *pvTimerID, htTimerCallback_t pxCallbackFunction);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/* 使用调用者提供的存储区创建定时器，不访问堆；删除命令处理完之前存储区必须一直有效 */
+TimerHandle_t htTimerCreateStatic(const char *pcTimerName, TickType_t xTimerPeriod, BaseType_t xAutoReload,
+    void *pvTimerID, htTimerCallback_t pxCallbackFunction, htStaticTimer_t *pxTimerBuffer);
+#endif
+
+/* 以下命令发送到守护任务执行，xTicksToWait为命令队列满时的最长等待时间 */
+BaseType_t htTimerStart(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t htTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t htTimerReset(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t htTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait);
+BaseType_t htTimerDelete(TimerHandle_t xTimer, TickType_t xTicksToWait);
+
+/* ISR版本 - 命令队列满时立即失败 */
+BaseType_t htTimerStartFromISR(TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t htTimerStopFromISR(TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t htTimerResetFromISR(TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t htTimerChangePeriodFromISR(TimerHandle_t xTimer, TickType_t xNewPeriod,
+    BaseType_t *pxHigherPriorityTaskWoken);
+
+/* 查询 */
+void *htTimerGetTimerID(TimerHandle_t xTimer);
+const char *htTimerGetName(TimerHandle_t xTimer);
+TickType_t htTimerGetPeriod(TimerHandle_t xTimer);
+BaseType_t htTimerIsTimerActive(TimerHandle_t xTimer);
+
+/* 创建定时器守护任务，由htStartScheduler调用 */
+BaseType_t htTimerCreateTimerTask(void);
+
+#endif /* HT_TIMER_H */
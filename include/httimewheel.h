@@ -0,0 +1,84 @@
+/**
+ * @file httimewheel.h
+ * @brief 分级定时轮 - 延时/超时任务的O(1)插入与均摊O(1)到期处理
+ *
+ * 结构：configTIMEWHEEL_LEVELS级，每级2^configTIMEWHEEL_SLOT_BITS个槽，每个槽是一个htList_t。
+ * - 第0级每个槽对应1个tick，第L级每个槽对应2^(SLOT_BITS*L)个tick
+ * - 插入：根据剩余tick数选级，根据唤醒时间对应位选槽，O(1)
+ * - 每tick只处理第0级当前槽；低级转完一圈时把高一级的当前槽"下放"(cascade)到低级
+ * - 超出定时轮范围的项暂存在溢出列表，顶级转完一圈时重新分配
+ *
+ * 所有时间差都用无符号减法计算，tick计数器回绕时仍然正确。
+ * 列表项的xItemValue保存绝对唤醒时间，可以随时用htListRemove()提前移除。
+ */
+#ifndef HT_TIMEWHEEL_H
+#define HT_TIMEWHEEL_H
+
+#include "httypes.h"
+#include "htlist.h"
+
+#if configTIMEWHEEL_SLOT_BITS < 1 || configTIMEWHEEL_SLOT_BITS > 5
+#error "httimewheel: configTIMEWHEEL_SLOT_BITS must be in 1..5"
+#endif
+#if (configTIMEWHEEL_SLOT_BITS * (configTIMEWHEEL_LEVELS - 1)) >= 32
+#error "httimewheel: too many levels for a 32-bit tick"
+#endif
+
+#define htTIMEWHEEL_SLOTS (1UL << configTIMEWHEEL_SLOT_BITS) /* 每级槽数 */
+#define htTIMEWHEEL_SLOT_MASK (htTIMEWHEEL_SLOTS - 1UL)
+#define htTIMEWHEEL_RANGE_BITS (configTIMEWHEEL_SLOT_BITS * configTIMEWHEEL_LEVELS) /* 直接覆盖的位数 */
+
+/* 定时轮结构 */
+typedef struct htTimeWheel {
+	TickType_t xTime; /* 定时轮已处理到的时间 */
+	htList_t xSlots[configTIMEWHEEL_LEVELS][htTIMEWHEEL_SLOTS]; /* 各级槽 */
+#if htTIMEWHEEL_RANGE_BITS < 32
+	htList_t xOverflow; /* 超出定时轮范围的项 */
+#endif
+} htTimeWheel_t;
+
+/* 到期回调，列表项在回调前已从定时轮移除 */
+typedef void (*htTimeWheelExpired_t)(htListItem_t *pxItem);
+
+/**
+ * 初始化定时轮
+ * @param pxWheel 定时轮
+ * @param xNow 当前时间
+ */
+void htTimeWheelInit(htTimeWheel_t *pxWheel, TickType_t xNow);
+
+/**
+ * 插入列表项
+ * @param pxWheel 定时轮
+ * @param pxItem 列表项（不能已在任何列表中）
+ * @param xWakeTime 绝对唤醒时间；等于当前时间时按下一个tick处理
+ */
+void htTimeWheelInsert(htTimeWheel_t *pxWheel, htListItem_t *pxItem, TickType_t xWakeTime);
+
+/**
+ * 定时轮前进一个tick，并对所有在新时间到期的项调用回调
+ * @param pxWheel 定时轮
+ * @param pxExpired 到期回调
+ * @return 本tick到期的项数
+ */
+UBaseType_t htTimeWheelTick(htTimeWheel_t *pxWheel, htTimeWheelExpired_t pxExpired);
+
+/**
+ * 距离下一个需要处理的tick还有多少个tick
+ * 返回值不晚于最早的到期时间：高级槽返回其下放时间，溢出列表返回顶级回绕时间
+ * @param pxWheel 定时轮
+ * @return tick数(>=1)，定时轮为空时返回htBLOCKED_INDEFINITELY
+ */
+TickType_t htTimeWheelNextEvent(htTimeWheel_t *pxWheel);
+
+/**
+ * 定时轮一次前进多个tick（用于无滴答空闲后补偿tick）
+ * 中间没有任何槽需要处理的tick直接跳过
+ * @param pxWheel 定时轮
+ * @param xTicks 前进的tick数
+ * @param pxExpired 到期回调
+ * @return 期间到期的项数
+ */
+UBaseType_t htTimeWheelAdvance(htTimeWheel_t *pxWheel, TickType_t xTicks, htTimeWheelExpired_t pxExpired);
+
+#endif /* HT_TIMEWHEEL_H */
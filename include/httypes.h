@@ -16,8 +16,9 @@ typedef uint32_t TickType_t;
 typedef void *TaskHandle_t;
 typedef uint32_t StackType_t;
 
-/* 定时器回调函数类型 */
-typedef void (*htTimerCallback_t)(void);
+/* 定时器回调函数类型，参数为到期的定时器 */
+struct htTimer;
+typedef void (*htTimerCallback_t)(struct htTimer *xTimer);
 
 /* 常量定义 */
 #define htPASS 0
@@ -32,6 +33,7 @@ enum htTaskStatus {
 	HT_TASK_RUNNING, /* 任务运行中 */
 	HT_TASK_BLOCKED, /* 任务阻塞 */
 	HT_TASK_SUSPENDED, /* 任务挂起 */
+	HT_TASK_DELETED, /* 任务已自删除，栈和TCB等待空闲任务回收 */
 };
 typedef enum htTaskStatus htTaskStatus_t;
 
@@ -8,12 +8,15 @@
 #define OS_SAFE_DELAY(ms) htTaskDelay((ms * configTICK_RATE_HZ) / 1000 + 1)
 
 /* 系统统计函数 */
-uint32_t htGetIdleRunTimePercent(void); /* 获取空闲任务运行时间百分比 */
-uint32_t htGetCPUUsage(void);           /* 获取CPU使用率 */
+uint32_t htGetIdleRunTimePercent(void); /* 获取最近统计窗口内空闲任务运行时间百分比 */
+uint32_t htGetCPUUsage(void);           /* 获取最近统计窗口内的CPU使用率 */
+uint32_t htGetTaskRunTimePercent(TaskHandle_t xTask); /* 获取任务自启动以来的运行时间百分比 */
 uint64_t htGetRunTimeCounter(void);     /* 获取系统总运行时间计数 */
 
 /* 堆栈分析函数 */
-UBaseType_t htGetTaskStackHighWaterMark(TaskHandle_t xTask); /* 获取任务堆栈使用高水位标记 */
+UBaseType_t htGetTaskStackHighWaterMark(TaskHandle_t xTask); /* 获取任务运行以来的最小剩余栈(字) */
+UBaseType_t htGetRecommendedStackDepth(UBaseType_t uxUsed);   /* 按峰值用量计算建议的栈大小(字) */
+void htStackReport(void);                                      /* 打印各任务栈用量和建议的栈大小 */
 
 /* 任务调试信息 */
 void htListTasks(void);                 /* 列出系统中所有任务及其状态 */
@@ -0,0 +1,123 @@
+/**
+ * @file htwait.h
+ * @brief 等待队列 - 队列、信号量、互斥量共用的阻塞/唤醒引擎
+ *
+ * 阻塞的任务同时挂在两处：
+ * - xEventListItem 挂在等待队列上，事件发生时由 htWaitQueueWakeOne() 唤醒
+ * - xStateListItem 挂在延时定时轮上，超时到期时由tick处理唤醒
+ * 先发生的一方把任务从另一处移除，并在TCB中记录唤醒原因。
+ *
+ * 阻塞接口只返回一次，不递归重入：调用者在循环中检查资源，
+ * 不满足时调用 htWaitQueueBlock()，被唤醒后用剩余tick数再试，
+ * 栈用量固定，超时也一定生效。
+ *
+ * 唤醒顺序：
+ * - htWAIT_ORDER_PRIORITY(默认)：等待列表按优先级排序，同优先级先来先醒。
+ *   唤醒最高优先级的等待者只需取表头，O(1)；插入时从表尾向前跳过更低优先级的等待者。
+ * - htWAIT_ORDER_FIFO：严格按到达顺序唤醒，用于对公平性敏感的对象。
+ *
+ * 优先级继承：互斥量的等待队列在pxOwner中记录持有者，并挂在持有者的pxMutexesHeld链表上。
+ * 等待者由此找到持有者提升其优先级，持有者本身在等待另一个互斥量时沿链继续提升；
+ * 持有者释放时按链表中各等待队列的最高等待者重新计算自己的优先级（见httask.h）。
+ */
+#ifndef HT_WAIT_H
+#define HT_WAIT_H
+
+#include "httypes.h"
+#include "htlist.h"
+#include "httask.h"
+
+/* 阻塞结束原因 */
+#define htWAIT_SIGNALLED 0 /* 被事件唤醒 */
+#define htWAIT_TIMEOUT 1 /* 等待超时 */
+
+/* 唤醒顺序 */
+#define htWAIT_ORDER_PRIORITY 0 /* 按优先级 */
+#define htWAIT_ORDER_FIFO 1 /* 按到达顺序 */
+
+/* 事件列表项的排序键：优先级越高键值越小，排在越前面 */
+#define htWAIT_PRIORITY_KEY(uxPriority) ((TickType_t)(configMAX_PRIORITIES - (uxPriority)))
+
+/* 等待队列结构 */
+typedef struct htWaitQueue {
+	htList_t xTasks; /* 等待中的任务(xEventListItem)，按唤醒顺序排列 */
+	UBaseType_t uxOrder; /* 唤醒顺序 htWAIT_ORDER_xxx */
+	htTCB_t *pxOwner; /* 互斥量的持有者，用于优先级继承；其他对象为NULL */
+	struct htWaitQueue *pxNextHeld; /* 持有者pxMutexesHeld链表中的下一个 */
+} htWaitQueue_t;
+
+/**
+ * 初始化等待队列，默认按优先级唤醒
+ * @param pxWaitQueue 等待队列
+ */
+void htWaitQueueInit(htWaitQueue_t *pxWaitQueue);
+
+/**
+ * 设置唤醒顺序，只影响之后进入等待的任务，应在对象投入使用前设置
+ * @param pxWaitQueue 等待队列
+ * @param uxOrder htWAIT_ORDER_PRIORITY 或 htWAIT_ORDER_FIFO
+ */
+void htWaitQueueSetOrder(htWaitQueue_t *pxWaitQueue, UBaseType_t uxOrder);
+
+/**
+ * 查询是否有任务在等待
+ * @param pxWaitQueue 等待队列
+ * @return htTRUE表示没有任务在等待
+ */
+BaseType_t htWaitQueueIsEmpty(htWaitQueue_t *pxWaitQueue);
+
+/**
+ * 阻塞当前任务直到被唤醒或超时
+ * 必须在(仅一层)临界区内调用；函数内退出临界区完成任务切换，返回前重新进入临界区。
+ * @param pxWaitQueue 等待队列
+ * @param pxTicksToWait 输入等待tick数(不能为0)，返回时更新为剩余tick数；
+ *                      htBLOCKED_INDEFINITELY表示永久等待，保持不变
+ * @return htWAIT_SIGNALLED 或 htWAIT_TIMEOUT
+ */
+BaseType_t htWaitQueueBlock(htWaitQueue_t *pxWaitQueue, TickType_t *pxTicksToWait);
+
+/**
+ * 唤醒等待队列中的第一个任务(优先级最高或最早到达)，同时撤销其超时
+ * 可在任务或ISR中调用，调用者负责临界区保护
+ * @param pxWaitQueue 等待队列
+ * @return 被唤醒的任务，没有任务在等待时返回NULL
+ */
+htTCB_t *htWaitQueueWakeOne(htWaitQueue_t *pxWaitQueue);
+
+/**
+ * 唤醒等待队列中的指定任务，同时撤销其超时
+ * 用于按各自条件挑选等待者的对象(如事件组)，调用者负责临界区保护
+ * @param pxTCB 正在等待的任务
+ */
+void htWaitQueueWakeTask(htTCB_t *pxTCB);
+
+/**
+ * 把任务从它所在的等待队列中移除（超时或删除任务时使用）
+ * 任务不在任何等待队列中时什么也不做，调用者负责临界区保护
+ * @param pxTCB 任务
+ */
+void htWaitQueueRemove(htTCB_t *pxTCB);
+
+/**
+ * 等待中的任务优先级改变后(如优先级继承)调整其在等待列表中的位置
+ * 任务不在任何等待队列中时什么也不做，调用者负责临界区保护
+ * @param pxTCB 任务
+ */
+void htWaitQueueReposition(htTCB_t *pxTCB);
+
+/**
+ * 设置互斥量等待队列的持有者，同时把它从原持有者的pxMutexesHeld链表移到新持有者的链表上
+ * 只修改记录，不改变任何任务的优先级，调用者负责临界区保护
+ * @param pxWaitQueue 互斥量的等待队列
+ * @param pxOwner 新持有者，NULL表示不再被持有
+ */
+void htWaitQueueSetOwner(htWaitQueue_t *pxWaitQueue, htTCB_t *pxOwner);
+
+/**
+ * 查询等待者中的最高优先级，调用者负责临界区保护
+ * @param pxWaitQueue 等待队列
+ * @return 最高优先级，没有任务在等待时返回0
+ */
+UBaseType_t htWaitQueueGetTopPriority(htWaitQueue_t *pxWaitQueue);
+
+#endif /* HT_WAIT_H */
@@ -0,0 +1,303 @@
+#include "hteventgroup.h"
+#include "httask.h"
+#include "htmem.h"
+#include "htscheduler.h"
+
+#if configUSE_EVENT_GROUPS == 1
+
+/* 等待方式标志，保存在等待任务的ucEventWaitFlags中 */
+#define htEVENT_WAIT_FOR_ALL_BITS  0x01U /* 等待全部位 */
+#define htEVENT_CLEAR_ON_EXIT      0x02U /* 条件满足后清除等待的位 */
+
+/**
+ * 判断事件位是否满足等待条件
+ */
+static BaseType_t prvTestWaitCondition(EventBits_t uxCurrentBits, EventBits_t uxBitsToWaitFor, uint8_t ucFlags)
+{
+    if ((ucFlags & htEVENT_WAIT_FOR_ALL_BITS) != 0)
+    {
+        return ((uxCurrentBits & uxBitsToWaitFor) == uxBitsToWaitFor) ? htTRUE : htFALSE;
+    }
+
+    return ((uxCurrentBits & uxBitsToWaitFor) != 0) ? htTRUE : htFALSE;
+}
+
+/**
+ * 置位并唤醒所有条件已满足的等待者
+ * 遍历一次等待列表：满足条件的任务记录下当时的事件位后被唤醒，
+ * 它们要求清除的位汇总后在遍历结束时一次清除，保证同一次置位能唤醒所有等待者。
+ * 调用者负责临界区保护
+ */
+static void prvSetBitsAndWake(htEventGroup_t *pxEventGroup, EventBits_t uxBitsToSet,
+    BaseType_t *pxHigherPriorityTaskWoken)
+{
+    htList_t *pxList = &(pxEventGroup->xTasksWaitingForBits.xTasks);
+    const htListItem_t *pxEnd = (const htListItem_t *)&(pxList->xListEnd);
+    htListItem_t *pxItem;
+    htListItem_t *pxNext;
+    htTCB_t *pxTCB;
+    EventBits_t uxBitsToClear = 0;
+
+    pxEventGroup->uxEventBits |= uxBitsToSet;
+
+    for (pxItem = pxList->xListEnd.pxNext; pxItem != pxEnd; pxItem = pxNext)
+    {
+        pxNext = pxItem->pxNext;
+        pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+
+        if (prvTestWaitCondition(pxEventGroup->uxEventBits, pxTCB->ulEventWaitBits, pxTCB->ucEventWaitFlags) == htTRUE)
+        {
+            if ((pxTCB->ucEventWaitFlags & htEVENT_CLEAR_ON_EXIT) != 0)
+            {
+                uxBitsToClear |= pxTCB->ulEventWaitBits;
+            }
+
+            /* 把满足条件时的事件位交给等待者作为返回值 */
+            pxTCB->ulEventWaitBits = pxEventGroup->uxEventBits;
+            htWaitQueueWakeTask(pxTCB);
+
+            if (pxCurrentTCB != NULL && pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+            {
+                *pxHigherPriorityTaskWoken = htTRUE;
+            }
+        }
+    }
+
+    pxEventGroup->uxEventBits &= ~uxBitsToClear;
+}
+
+/**
+ * 初始化事件组
+ */
+static void prvInitialiseNewEventGroup(htEventGroup_t *pxEventGroup, uint8_t ucStaticallyAllocated)
+{
+    pxEventGroup->uxEventBits = 0;
+    pxEventGroup->ucStaticallyAllocated = ucStaticallyAllocated;
+    htWaitQueueInit(&(pxEventGroup->xTasksWaitingForBits));
+}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+/**
+ * 创建事件组
+ */
+EventGroupHandle_t htEventGroupCreate(void)
+{
+    htEventGroup_t *pxEventGroup;
+
+    pxEventGroup = (htEventGroup_t *)htPortMalloc(sizeof(htEventGroup_t));
+
+    if (pxEventGroup != NULL)
+    {
+        prvInitialiseNewEventGroup(pxEventGroup, htFALSE);
+    }
+
+    return pxEventGroup;
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建事件组
+ */
+EventGroupHandle_t htEventGroupCreateStatic(htStaticEventGroup_t *pxEventGroupBuffer)
+{
+    if (pxEventGroupBuffer != NULL)
+    {
+        prvInitialiseNewEventGroup(pxEventGroupBuffer, htTRUE);
+    }
+
+    return pxEventGroupBuffer;
+}
+#endif
+
+/**
+ * 删除事件组
+ * 仍在等待的任务全部被唤醒，返回值为0
+ */
+void htEventGroupDelete(EventGroupHandle_t xEventGroup)
+{
+    htTCB_t *pxTCB;
+    BaseType_t xYieldRequired = htFALSE;
+
+    if (xEventGroup == NULL)
+    {
+        return;
+    }
+
+    htEnterCritical();
+    while ((pxTCB = htWaitQueueWakeOne(&(xEventGroup->xTasksWaitingForBits))) != NULL)
+    {
+        pxTCB->ulEventWaitBits = 0;
+        xYieldRequired = htTRUE;
+    }
+    if (xYieldRequired == htTRUE)
+    {
+        htTaskYield();
+    }
+    htExitCritical();
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+    /* 静态创建的事件组由调用者管理存储区 */
+    if (xEventGroup->ucStaticallyAllocated == htFALSE)
+    {
+        htPortFree(xEventGroup);
+    }
+#endif
+}
+
+/**
+ * 等待事件位
+ */
+EventBits_t htEventGroupWaitBits(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToWaitFor, BaseType_t xClearOnExit,
+    BaseType_t xWaitForAllBits, TickType_t xTicksToWait)
+{
+    htEventGroup_t *pxEventGroup = xEventGroup;
+    EventBits_t uxReturn;
+    uint8_t ucFlags = 0;
+
+    /* 检查参数有效性 */
+    if (pxEventGroup == NULL || uxBitsToWaitFor == 0)
+    {
+        return 0;
+    }
+
+    if (xWaitForAllBits != htFALSE)
+    {
+        ucFlags |= htEVENT_WAIT_FOR_ALL_BITS;
+    }
+    if (xClearOnExit != htFALSE)
+    {
+        ucFlags |= htEVENT_CLEAR_ON_EXIT;
+    }
+
+    htEnterCritical();
+
+    uxReturn = pxEventGroup->uxEventBits;
+
+    if (prvTestWaitCondition(uxReturn, uxBitsToWaitFor, ucFlags) == htTRUE)
+    {
+        /* 条件已满足，不需要等待 */
+        if (xClearOnExit != htFALSE)
+        {
+            pxEventGroup->uxEventBits &= ~uxBitsToWaitFor;
+        }
+    }
+    else if (xTicksToWait != 0 && pxCurrentTCB != NULL)
+    {
+        /* 等待条件保存在TCB中，由置位方检查 */
+        pxCurrentTCB->ulEventWaitBits = uxBitsToWaitFor;
+        pxCurrentTCB->ucEventWaitFlags = ucFlags;
+
+        if (htWaitQueueBlock(&(pxEventGroup->xTasksWaitingForBits), &xTicksToWait) == htWAIT_SIGNALLED)
+        {
+            /* 置位方已经清除了需要清除的位，并留下了条件满足时的事件位 */
+            uxReturn = pxCurrentTCB->ulEventWaitBits;
+        }
+        else
+        {
+            /* 超时：返回当前事件位 */
+            uxReturn = pxEventGroup->uxEventBits;
+        }
+    }
+
+    htExitCritical();
+
+    return uxReturn;
+}
+
+/**
+ * 置位事件位
+ */
+EventBits_t htEventGroupSetBits(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToSet)
+{
+    EventBits_t uxReturn;
+    BaseType_t xYieldRequired = htFALSE;
+
+    if (xEventGroup == NULL)
+    {
+        return 0;
+    }
+
+    htEnterCritical();
+
+    prvSetBitsAndWake(xEventGroup, uxBitsToSet, &xYieldRequired);
+    uxReturn = xEventGroup->uxEventBits;
+
+    if (xYieldRequired == htTRUE)
+    {
+        htTaskYield();
+    }
+
+    htExitCritical();
+
+    return uxReturn;
+}
+
+/**
+ * 从ISR中置位事件位
+ * 直接在中断中完成唤醒，一次中断即可放行所有等待同一组条件的任务
+ */
+EventBits_t htEventGroupSetBitsFromISR(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToSet,
+    BaseType_t *pxHigherPriorityTaskWoken)
+{
+    BaseType_t xWoken = htFALSE;
+    EventBits_t uxReturn;
+    UBaseType_t uxSavedMask;
+
+    if (pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = htFALSE;
+    }
+
+    if (xEventGroup == NULL)
+    {
+        return 0;
+    }
+
+    uxSavedMask = htEnterCriticalFromISR();
+    prvSetBitsAndWake(xEventGroup, uxBitsToSet, &xWoken);
+    uxReturn = xEventGroup->uxEventBits;
+    htExitCriticalFromISR(uxSavedMask);
+
+    if (pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = xWoken;
+    }
+
+    return uxReturn;
+}
+
+/**
+ * 清除事件位
+ */
+EventBits_t htEventGroupClearBits(EventGroupHandle_t xEventGroup, EventBits_t uxBitsToClear)
+{
+    EventBits_t uxReturn;
+
+    if (xEventGroup == NULL)
+    {
+        return 0;
+    }
+
+    htEnterCritical();
+    uxReturn = xEventGroup->uxEventBits;
+    xEventGroup->uxEventBits &= ~uxBitsToClear;
+    htExitCritical();
+
+    return uxReturn;
+}
+
+/**
+ * 读取当前事件位
+ */
+EventBits_t htEventGroupGetBits(EventGroupHandle_t xEventGroup)
+{
+    if (xEventGroup == NULL)
+    {
+        return 0;
+    }
+
+    return xEventGroup->uxEventBits;
+}
+
+#endif /* configUSE_EVENT_GROUPS */
@@ -225,3 +225,21 @@ htList_t *htListGetItemContainer(htListItem_t *pxListItem)
 {
     return (htList_t *)pxListItem->pxContainer;
 }
+
+/**
+ * 把链表游标移到下一项并返回其所有者
+ * 到达表尾时绕回表头，反复调用即按链表顺序轮转；游标所指的项被移除时已退回前一项，
+ * 下次调用仍从被移除项之后继续
+ * @param pxList 链表，不能为空
+ * @return 新游标所指项的所有者
+ */
+void *htListGetOwnerOfNextEntry(htList_t *pxList)
+{
+    pxList->pxIndex = pxList->pxIndex->pxNext;
+    if(pxList->pxIndex == (htListItem_t *)&(pxList->xListEnd))
+    {
+        pxList->pxIndex = pxList->pxIndex->pxNext;
+    }
+    
+    return pxList->pxIndex->pvOwner;
+}
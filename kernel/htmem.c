@@ -20,6 +20,11 @@
 #include <stdio.h>
 #include "htmem.h"
 #include "htconfig.h"
+#include "htPort.h"
+#include "htscheduler.h"
+
+/* 只使用静态创建时整个分配器不参与编译，连同堆数组一起从镜像中去掉 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 
 /**
  * TLSF算法辅助宏定义
@@ -314,6 +319,9 @@ static inline block_header_t *tlsf_block_next(const block_header_t *block)
 	return tlsf_offset_to_block(block, tlsf_block_size(block));
 }
 
+/* 堆边界检查，定义在堆数组之后 */
+static inline int tlsf_block_within_heap(const block_header_t *block);
+
 /**
  * @brief 链接当前块和下一个物理块
  * @param block 当前块指针
@@ -547,10 +555,11 @@ static block_header_t *tlsf_block_split(tlsf_control_t *control, block_header_t
 	}
 
 	remaining->size = remain_size;
-	// 设置剩余块为空闲，前块为已用，初始化时主块前无块
-	tlsf_block_set_free(remaining);
+	// 前块(即将分配的block)为已用；标记为空闲时同时让后一个物理块指回剩余块并置位其前块空闲标志，
+	// 否则后一个块释放时会按旧的prev_phys_block合并到已分配的block上
 	tlsf_block_set_prev_used(remaining);
 	remaining->prev_phys_block = block;
+	tlsf_block_mark_as_free(remaining);
 
 	tlsf_block_set_size(block, size);
 	tlsf_block_mark_as_used(block);
@@ -678,7 +687,7 @@ void htMemInit(void)
 	g_tlsf_initialized = 1;
 }
 
-/* 分配内存 */
+/* 分配内存：挂起调度器而不是关中断来保护堆，不能在中断中调用 */
 void *htPortMalloc(size_t size)
 {
 	if (!g_tlsf_initialized) {
@@ -688,7 +697,7 @@ void *htPortMalloc(size_t size)
 	const size_t adjust = tlsf_align_up(size, TLSF_ALIGN_SIZE);
 	const size_t block_size = adjust ? tlsf_align_up(adjust + TLSF_BLOCK_HEADER_SIZE, TLSF_ALIGN_SIZE) : 0;
 
-	__disable_irq();
+	htSchedulerSuspend();
 
 	if (adjust && block_size) {
 		int fl, sl;
@@ -719,29 +728,29 @@ void *htPortMalloc(size_t size)
 				g_tlsf_control.min_free_size = g_tlsf_control.free_size;
 			}
 
-			__enable_irq();
+			htSchedulerResume();
 			return tlsf_block_to_ptr(block);
 		}
 	}
 
-	__enable_irq();
+	htSchedulerResume();
 	return NULL;
 }
 
-/* 释放内存 */
+/* 释放内存，不能在中断中调用 */
 void htPortFree(void *ptr)
 {
 	if (!ptr) {
 		return;
 	}
 
-	__disable_irq();
+	htSchedulerSuspend();
 
 	block_header_t *block = tlsf_block_from_ptr(ptr);
 
 	/* 验证指针有效性 */
 	if ((char *)block < (char *)g_tlsf_heap || (char *)block >= (char *)g_tlsf_heap + configTOTAL_HEAP_SIZE) {
-		__enable_irq();
+		htSchedulerResume();
 		return;
 	}
 
@@ -775,7 +784,7 @@ void htPortFree(void *ptr)
 	/* 因为邻居空闲块本来就在 free_size 中，合并不改变总空闲量 */
 	g_tlsf_control.free_size += original_size;
 
-	__enable_irq();
+	htSchedulerResume();
 }
 /* 获取当前可用堆大小 */
 size_t htGetFreeHeapSize(void)
@@ -794,3 +803,5 @@ size_t htGetTotalHeapSize(void)
 {
 	return configTOTAL_HEAP_SIZE;
 }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION == 1 */
@@ -0,0 +1,276 @@
+#include "htmutex.h"
+#include "httask.h"
+#include "htmem.h"
+#include "htscheduler.h"
+#include "htPort.h"
+
+#if configUSE_MUTEXES == 1
+
+/* 所有互斥量，删除任务时据此找到它无竞争持有的互斥量 */
+static htMutex_t *pxMutexList = NULL;
+
+/**
+ * 从持有者字中取出持有者
+ */
+static htTCB_t *prvGetOwner(const htMutex_t *pxMutex)
+{
+    return (htTCB_t *)(pxMutex->uxOwner & ~htMUTEX_HAS_WAITERS);
+}
+
+/**
+ * 初始化互斥量
+ */
+static void prvInitialiseNewMutex(htMutex_t *pxMutex, uint8_t ucStaticallyAllocated)
+{
+    pxMutex->uxOwner = 0;
+    pxMutex->ucStaticallyAllocated = ucStaticallyAllocated;
+    htWaitQueueInit(&(pxMutex->xWaiters));
+
+    htEnterCritical();
+    pxMutex->pxNextMutex = pxMutexList;
+    pxMutexList = pxMutex;
+    htExitCritical();
+}
+
+/**
+ * 把互斥量交给优先级最高的等待者，没有等待者时变为空闲
+ * 新持有者继承剩下的等待者中最高的优先级，调用者负责临界区保护
+ * @return 新持有者，没有等待者时返回NULL
+ */
+static htTCB_t *prvHandOff(htMutex_t *pxMutex)
+{
+    htTCB_t *pxNewOwner;
+
+    /* 等待者全部离开后标志可能还在，此时直接变为空闲 */
+    pxNewOwner = htWaitQueueWakeOne(&(pxMutex->xWaiters));
+    pxMutex->uxOwner = (uintptr_t)pxNewOwner;
+
+    /* 还有等待者时保持等待标志 */
+    if (pxNewOwner != NULL && htWaitQueueIsEmpty(&(pxMutex->xWaiters)) == htFALSE)
+    {
+        pxMutex->uxOwner |= htMUTEX_HAS_WAITERS;
+        htWaitQueueSetOwner(&(pxMutex->xWaiters), pxNewOwner);
+        htTaskPriorityInherit(pxNewOwner, htWaitQueueGetTopPriority(&(pxMutex->xWaiters)));
+    }
+    else
+    {
+        htWaitQueueSetOwner(&(pxMutex->xWaiters), NULL);
+    }
+
+    return pxNewOwner;
+}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+/**
+ * 创建互斥量
+ */
+MutexHandle_t htMutexCreate(void)
+{
+    htMutex_t *pxMutex;
+
+    pxMutex = (htMutex_t *)htPortMalloc(sizeof(htMutex_t));
+
+    if (pxMutex != NULL)
+    {
+        prvInitialiseNewMutex(pxMutex, htFALSE);
+    }
+
+    return pxMutex;
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建互斥量
+ */
+MutexHandle_t htMutexCreateStatic(htStaticMutex_t *pxMutexBuffer)
+{
+    if (pxMutexBuffer != NULL)
+    {
+        prvInitialiseNewMutex(pxMutexBuffer, htTRUE);
+    }
+
+    return pxMutexBuffer;
+}
+#endif
+
+/**
+ * 删除互斥量
+ */
+void htMutexDelete(MutexHandle_t xMutex)
+{
+    htMutex_t **ppxLink;
+
+    if (xMutex == NULL)
+    {
+        return;
+    }
+
+    htEnterCritical();
+    htWaitQueueSetOwner(&(xMutex->xWaiters), NULL);
+    for (ppxLink = &pxMutexList; *ppxLink != NULL; ppxLink = &((*ppxLink)->pxNextMutex))
+    {
+        if (*ppxLink == xMutex)
+        {
+            *ppxLink = xMutex->pxNextMutex;
+            break;
+        }
+    }
+    htExitCritical();
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+    /* 静态创建的互斥量由调用者管理存储区 */
+    if (xMutex->ucStaticallyAllocated == htFALSE)
+    {
+        htPortFree(xMutex);
+    }
+#endif
+}
+
+/**
+ * 获取互斥量
+ * 快速路径：空闲时一次比较交换成为持有者。
+ * 慢速路径(临界区内)：置位等待标志、提升持有者优先级后阻塞，
+ * 被唤醒时释放者已经把互斥量交给本任务，不需要重试。
+ */
+BaseType_t htMutexLock(MutexHandle_t xMutex, TickType_t xTicksToWait)
+{
+    htTCB_t *pxOwner;
+    BaseType_t xReturn = htFAIL;
+
+    /* 检查参数有效性，调度器启动前没有当前任务可以作为持有者 */
+    if (xMutex == NULL || pxCurrentTCB == NULL)
+    {
+        return htFAIL;
+    }
+
+    if (htPortCompareAndSwap(&(xMutex->uxOwner), 0, (uintptr_t)pxCurrentTCB) == htTRUE)
+    {
+        return htPASS;
+    }
+
+    htEnterCritical();
+
+    pxOwner = prvGetOwner(xMutex);
+    if (pxOwner == NULL)
+    {
+        /* 比较交换失败后持有者已经释放 */
+        xMutex->uxOwner = (uintptr_t)pxCurrentTCB;
+        xReturn = htPASS;
+    }
+    else if (pxOwner != pxCurrentTCB && xTicksToWait != 0)
+    {
+        /* 第一个等待者负责置位等待标志，使持有者释放时走慢速路径 */
+        if ((xMutex->uxOwner & htMUTEX_HAS_WAITERS) == 0)
+        {
+            xMutex->uxOwner |= htMUTEX_HAS_WAITERS;
+            htWaitQueueSetOwner(&(xMutex->xWaiters), pxOwner);
+        }
+
+        /* 优先级继承，持有者在等待其他互斥量时沿持有链传递 */
+        htTaskPriorityInherit(pxOwner, pxCurrentTCB->uxPriority);
+
+        if (htWaitQueueBlock(&(xMutex->xWaiters), &xTicksToWait) == htWAIT_SIGNALLED)
+        {
+            xReturn = (prvGetOwner(xMutex) == pxCurrentTCB) ? htPASS : htFAIL;
+        }
+        else
+        {
+            /* 超时：持有者可能已经释放或换成别的任务，按剩下的等待者重新计算它的优先级 */
+            pxOwner = prvGetOwner(xMutex);
+            if (pxOwner != NULL)
+            {
+                if (htWaitQueueIsEmpty(&(xMutex->xWaiters)) == htTRUE)
+                {
+                    xMutex->uxOwner &= ~htMUTEX_HAS_WAITERS;
+                    htWaitQueueSetOwner(&(xMutex->xWaiters), NULL);
+                }
+                htTaskPriorityUpdate(pxOwner);
+            }
+        }
+    }
+
+    htExitCritical();
+
+    return xReturn;
+}
+
+/**
+ * 释放互斥量
+ * 快速路径：没有等待者时一次比较交换清除持有者。
+ * 慢速路径(临界区内)：交给优先级最高的等待者，再恢复自己的优先级。
+ */
+BaseType_t htMutexUnlock(MutexHandle_t xMutex)
+{
+    htTCB_t *pxNewOwner;
+    UBaseType_t uxOldPriority;
+    BaseType_t xReturn = htFAIL;
+
+    /* 检查参数有效性 */
+    if (xMutex == NULL || pxCurrentTCB == NULL)
+    {
+        return htFAIL;
+    }
+
+    if (htPortCompareAndSwap(&(xMutex->uxOwner), (uintptr_t)pxCurrentTCB, 0) == htTRUE)
+    {
+        return htPASS;
+    }
+
+    htEnterCritical();
+
+    if (prvGetOwner(xMutex) == pxCurrentTCB)
+    {
+        pxNewOwner = prvHandOff(xMutex);
+
+        uxOldPriority = pxCurrentTCB->uxPriority;
+        htTaskPriorityUpdate(pxCurrentTCB);
+
+        /* 优先级降低或新持有者优先级更高时都可能需要切换 */
+        if (pxCurrentTCB->uxPriority < uxOldPriority ||
+            (pxNewOwner != NULL && pxNewOwner->uxPriority > pxCurrentTCB->uxPriority))
+        {
+            htTaskYield();
+        }
+
+        xReturn = htPASS;
+    }
+
+    htExitCritical();
+
+    return xReturn;
+}
+
+/**
+ * 交出被删除任务持有的互斥量
+ * 无竞争的持有只记录在持有者字中，不在任务的pxMutexesHeld上，因此遍历所有互斥量查找
+ */
+void htMutexReleaseAll(htTCB_t *pxTCB)
+{
+    htMutex_t *pxMutex;
+
+    htEnterCritical();
+    for (pxMutex = pxMutexList; pxMutex != NULL; pxMutex = pxMutex->pxNextMutex)
+    {
+        if (prvGetOwner(pxMutex) == pxTCB)
+        {
+            (void)prvHandOff(pxMutex);
+        }
+    }
+    htExitCritical();
+}
+
+/**
+ * 查询持有者
+ */
+TaskHandle_t htMutexGetOwner(MutexHandle_t xMutex)
+{
+    if (xMutex == NULL)
+    {
+        return NULL;
+    }
+
+    return (TaskHandle_t)prvGetOwner(xMutex);
+}
+
+#endif /* configUSE_MUTEXES */
@@ -5,15 +5,14 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include "htOS.h"
-#include <stdio.h> 
+#include <stdio.h>
 #include "htos.h"
 #include "httask.h"
 #include "htscheduler.h"  
 #include "htmem.h"
 #include "htqueue.h"      // 添加队列模块
 #include "htsemaphore.h"  // 添加信号量模块
-#include "stm32f1xx.h"
+#include "htregistry.h"
 
 /* 版本定义 */
 #define HT_OS_VERSION_MAJOR    0
@@ -24,9 +23,6 @@
 /* 系统滴答计数器 - 改为外部声明，避免重复定义 */
 extern TickType_t xTickCount;
 
-/* 中断嵌套计数 */
-static volatile uint32_t uxCriticalNesting = 0;
-
 // 操作系统状态
 int gOSInitialized = 0;
 int gOSRunning = 0;
@@ -53,7 +49,9 @@ int htOSInit(void) {
     htSchedulerInit();
     
     gOSInitialized = 1;
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 		htMemInit();
+#endif
     return 0;
 }
 
@@ -76,6 +74,11 @@ int htOSStart(void)
         return 0;
     }
 
+#if configUSE_TASK_REGISTRY == 1
+    // 创建HT_TASK_DEFINE定义的任务
+    (void)htTaskCreateRegistered();
+#endif
+
     // Ensure there are tasks to run
     if (pxCurrentTCB == NULL) {
         printf("[htOS] ERROR: No tasks available to run!\r\n");
@@ -97,6 +100,7 @@ int htOSStart(void)
     return -1;
 }
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建新任务- 简单包装httask.h中的函数
  */
@@ -119,6 +123,7 @@ TaskHandle_t htOSTaskCreate(const char* name, void (*function)(void*), void* par
     
     return taskHandle;
 }
+#endif
 
 /**
  * 删除任务- 简单包装httask.h中的函数
@@ -132,12 +137,14 @@ int htOSTaskDelete(TaskHandle_t task) {
     return 0; // 假设删除总是成功
 }
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建队列（兼容旧API）- 直接调用htqueue.h中的函数
  */
 QueueHandle_t htOSQueueCreate(uint32_t length, uint32_t itemSize) {
     return htQueueCreate((UBaseType_t)length, (UBaseType_t)itemSize);
 }
+#endif
 
 /**
  * 发送数据到队列（兼容旧API）
@@ -171,6 +178,7 @@ int htOSQueueReceive(QueueHandle_t queue, void* buffer, uint32_t timeout) {
     return (status == htPASS) ? 0 : -1;
 }
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建二值信号量（兼容旧API）
  */
@@ -184,6 +192,7 @@ SemaphoreHandle_t htOSSemaphoreCreateBinary(void) {
 SemaphoreHandle_t htOSMutexCreate(void) {
     return htSemaphoreCreateMutex();
 }
+#endif
 
 /**
  * 获取信号量/互斥锁（兼容旧API）
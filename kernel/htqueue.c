@@ -6,61 +6,47 @@
 
 /**
  * 初始化队列
+ * @param pucQueueStorage 消息存储区，uxItemSize为0(信号量)时为NULL
  */
-static void prvInitialiseNewQueue(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, htQUEUE_t *pxNewQueue)
+static void prvInitialiseNewQueue(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t *pucQueueStorage,
+    htQUEUE_t *pxNewQueue)
 {
-    /* 队列结构已分配，现在创建队列存储区 */
-    if (uxItemSize == 0)
-    {
-        /* 二值信号量或计数信号量不需要存储区 */
-        pxNewQueue->pcHead = NULL;
-    }
-    else
-    {
-        /* 分配队列存储区 */
-        pxNewQueue->pcHead = (int8_t *)htPortMalloc(uxQueueLength * uxItemSize);
-    }
+    /* 初始化队列成员 */
+    pxNewQueue->pcHead = (int8_t *)pucQueueStorage;
+    pxNewQueue->uxLength = uxQueueLength;
+    pxNewQueue->uxItemSize = uxItemSize;
+    pxNewQueue->pcWriteTo = pxNewQueue->pcHead;
+    pxNewQueue->uxMessagesWaiting = 0;
+    pxNewQueue->cRxLock = htQUEUE_UNLOCKED;
+    pxNewQueue->cTxLock = htQUEUE_UNLOCKED;
 
-    if (pxNewQueue->pcHead != NULL || uxItemSize == 0)
+    /* 初始化指针 */
+    if (uxItemSize > 0)
     {
-        /* 初始化队列成员 */
-        pxNewQueue->uxLength = uxQueueLength;
-        pxNewQueue->uxItemSize = uxItemSize;
-        pxNewQueue->pcWriteTo = pxNewQueue->pcHead;
-        pxNewQueue->uxMessagesWaiting = 0;
-        pxNewQueue->cRxLock = htQUEUE_UNLOCKED;
-        pxNewQueue->cTxLock = htQUEUE_UNLOCKED;
-
-        /* 初始化指针 */
-        if (uxItemSize > 0)
-        {
-            /* 队列指针初始化 */
-            pxNewQueue->u.xQueue.pcTail = pxNewQueue->pcHead + (uxQueueLength * uxItemSize);
-            pxNewQueue->u.xQueue.pcReadFrom = pxNewQueue->pcHead;
-        }
-        else
-        {
-            /* 信号量初始化 - 初始计数为0 */
-            pxNewQueue->u.xSemaphore.uxSemaphoreCount = 0;
-        }
-
-        /* 初始化任务等待列表 */
-        htListInit(&(pxNewQueue->xTasksWaitingToSend));
-        htListInit(&(pxNewQueue->xTasksWaitingToReceive));
+        /* 队列指针初始化 */
+        pxNewQueue->u.xQueue.pcTail = pxNewQueue->pcHead + (uxQueueLength * uxItemSize);
+        pxNewQueue->u.xQueue.pcReadFrom = pxNewQueue->pcHead;
     }
     else
     {
-        /* 如果存储区分配失败，释放队列结构 */
-        htPortFree(pxNewQueue);
+        /* 信号量初始化 - 初始计数为0 */
+        pxNewQueue->u.xSemaphore.uxSemaphoreCount = 0;
+        pxNewQueue->u.xSemaphore.pxMutexHolder = NULL;
     }
+
+    /* 初始化任务等待列表 */
+    htWaitQueueInit(&(pxNewQueue->xTasksWaitingToSend));
+    htWaitQueueInit(&(pxNewQueue->xTasksWaitingToReceive));
 }
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建队列
  */
 QueueHandle_t htQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
 {
     htQUEUE_t *pxNewQueue;
+    uint8_t *pucQueueStorage = NULL;
 
     /* 至少有一个空间 */
     if (uxQueueLength < 1)
@@ -70,14 +56,49 @@ QueueHandle_t htQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
 
     /* 分配队列结构内存 */
     pxNewQueue = (htQUEUE_t *)htPortMalloc(sizeof(htQUEUE_t));
+    if (pxNewQueue == NULL)
+    {
+        return NULL;
+    }
 
-    if (pxNewQueue != NULL)
+    /* 二值信号量或计数信号量不需要存储区 */
+    if (uxItemSize > 0)
     {
-        prvInitialiseNewQueue(uxQueueLength, uxItemSize, pxNewQueue);
+        pucQueueStorage = (uint8_t *)htPortMalloc(uxQueueLength * uxItemSize);
+        if (pucQueueStorage == NULL)
+        {
+            /* 如果存储区分配失败，释放队列结构 */
+            htPortFree(pxNewQueue);
+            return NULL;
+        }
     }
 
+    prvInitialiseNewQueue(uxQueueLength, uxItemSize, pucQueueStorage, pxNewQueue);
+    pxNewQueue->ucStaticallyAllocated = htFALSE;
+
     return pxNewQueue;
 }
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建队列
+ */
+QueueHandle_t htQueueCreateStatic(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t *pucQueueStorage,
+    htStaticQueue_t *pxQueueBuffer)
+{
+    /* 至少有一个空间，有消息时必须提供存储区 */
+    if (uxQueueLength < 1 || pxQueueBuffer == NULL || (uxItemSize > 0 && pucQueueStorage == NULL))
+    {
+        return NULL;
+    }
+
+    prvInitialiseNewQueue(uxQueueLength, uxItemSize, (uxItemSize > 0) ? pucQueueStorage : NULL, pxQueueBuffer);
+    pxQueueBuffer->ucStaticallyAllocated = htTRUE;
+
+    return pxQueueBuffer;
+}
+#endif
 
 /**
  * 复制数据到队列
@@ -123,6 +144,11 @@ static void prvCopyDataFromQueue(htQUEUE_t *pxQueue, void *pvBuffer)
             pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
         }
     }
+    else
+    {
+        /* 如果是信号量，减少计数 */
+        pxQueue->u.xSemaphore.uxSemaphoreCount--;
+    }
     
     /* 更新消息计数 */
     pxQueue->uxMessagesWaiting--;
@@ -148,14 +174,32 @@ static void prvUnlockQueue(htQUEUE_t *pxQueue)
     }
 }
 
+/**
+ * 唤醒等待队列中的一个任务
+ * 被唤醒任务的优先级高于当前任务时置位*pxHigherPriorityTaskWoken
+ * 调用者负责临界区保护
+ */
+static void prvWakeWaitingTask(htWaitQueue_t *pxWaitQueue, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    htTCB_t *pxTCB = htWaitQueueWakeOne(pxWaitQueue);
+
+    if (pxTCB != NULL && pxCurrentTCB != NULL && pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+    {
+        if (pxHigherPriorityTaskWoken != NULL)
+        {
+            *pxHigherPriorityTaskWoken = htTRUE;
+        }
+    }
+}
+
 /**
  * 发送数据到队列
+ * 队列满时阻塞，被唤醒后用剩余的等待时间重试，超时返回htFAIL
  */
 BaseType_t htQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
 {
-    BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
-		TickType_t xTimeToWake =0;
+    BaseType_t xYieldRequired = htFALSE;
     
     /* 检查参数有效性 */
     if (pxQueue == NULL)
@@ -166,80 +210,53 @@ BaseType_t htQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType
     /* 禁用中断 */
     htEnterCritical();
     
-    /* 检查是否有空间 */
-    if (pxQueue->uxMessagesWaiting < pxQueue->uxLength || pxQueue->uxItemSize == 0)
+    for (;;)
     {
-        /* 有空间，直接复制数据 */
-        prvCopyDataToQueue(pxQueue, pvItemToQueue);
-        
-        /* 如果有任务在等待读取，唤醒一个优先级最高的任务 */
-        if (htListGetCurrentNumberOfItems(&(pxQueue->xTasksWaitingToReceive)) > 0)
+        /* 检查是否有空间 */
+        if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
         {
-            /* 获取等待列表中的第一个任务(优先级最高) */
-            htListItem_t *pxItem = htListGetHead(&(pxQueue->xTasksWaitingToReceive));
-            if (pxItem != NULL)
+            /* 有空间，直接复制数据 */
+            prvCopyDataToQueue(pxQueue, pvItemToQueue);
+            
+            /* 如果有任务在等待读取，唤醒优先级最高的一个 */
+            prvWakeWaitingTask(&(pxQueue->xTasksWaitingToReceive), &xYieldRequired);
+            if (xYieldRequired == htTRUE)
             {
-                /* 获取任务TCB并移出等待列表 */
-                htTCB_t *pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
-                htListRemove(pxItem);
-                
-                /* 添加到就绪列表 */
-                pxTCB->uxTaskState = HT_TASK_READY;
-                htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), &(pxTCB->xStateListItem));
+                htTaskYield();
             }
+            
+            htExitCritical();
+            return htPASS;
         }
         
-        xReturn = htPASS;
-    }
-		else if( pxQueue->uxMessagesWaiting == pxQueue->uxLength)
-		{
-			return xReturn;
-		}
-    else if (xTicksToWait > 0) 
-    {
-				__disable_irq();
-				if (pxCurrentTCB == NULL) {
-        __enable_irq();
-        return xReturn;
-        }       
-        /* 从就绪列表中删除当前任务 */
-        htListRemove(&(pxCurrentTCB->xStateListItem));
-        
-        /* 设置唤醒时间 */
-        if (xTicksToWait != 0xFFFFFFFF) /* 0xFFFFFFFF表示永久等待 */
+        /* 队列已满且不等待，或调度器尚未运行 */
+        if (xTicksToWait == 0 || pxCurrentTCB == NULL)
         {
-            xTimeToWake = xTickCount + xTicksToWait;
-            htListSetItemValue(&(pxCurrentTCB->xEventListItem), xTimeToWake);
+            break;
         }
         
-        /* 添加到发送等待队列 */
-        htListInsertEnd(&(pxQueue->xTasksWaitingToSend), &(pxCurrentTCB->xEventListItem));
-        
-        /* 标记任务为阻塞状态 */
-        pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
-        
-        /* 退出临界区并进行任务切换 */
-				__enable_irq();
-        htTaskYield();
-        
-        /* 任务被唤醒后继续执行，再次尝试发送 */
-        return htQueueSend(xQueue, pvItemToQueue, xTicksToWait);
+        /* 阻塞直到有空间或超时 */
+        if (htWaitQueueBlock(&(pxQueue->xTasksWaitingToSend), &xTicksToWait) == htWAIT_TIMEOUT)
+        {
+            break;
+        }
     }
     
     /* 退出临界区 */
     htExitCritical();
     
-    return xReturn;
+    return htFAIL;
 }
 
 /**
  * 从队列接收数据
+ * 队列空时阻塞，被唤醒后用剩余的等待时间重试，超时返回htFAIL
  */
 BaseType_t htQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
 {
-    BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
-    TickType_t xTimeToWake= 0;
+    BaseType_t xYieldRequired = htFALSE;
+    
     /* 检查参数有效性 */
     if (pxQueue == NULL || pvBuffer == NULL)
     {
@@ -249,69 +266,42 @@ BaseType_t htQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTick
     /* 禁用中断 */
     htEnterCritical();
     
-    /* 检查是否有消息 */
-    if (pxQueue->uxMessagesWaiting > 0)
+    for (;;)
     {
-        /* 有消息，直接接收 */
-        prvCopyDataFromQueue(pxQueue, pvBuffer);
-        
-        /* 如果有任务在等待发送，唤醒一个优先级最高的任务 */
-        if (htListGetCurrentNumberOfItems(&(pxQueue->xTasksWaitingToSend)) > 0)
+        /* 检查是否有消息 */
+        if (pxQueue->uxMessagesWaiting > 0)
         {
-            /* 获取等待列表中的第一个任务(优先级最高) */
-            htListItem_t *pxItem = htListGetHead(&(pxQueue->xTasksWaitingToSend));
-            if (pxItem != NULL)
+            /* 有消息，直接接收 */
+            prvCopyDataFromQueue(pxQueue, pvBuffer);
+            
+            /* 如果有任务在等待发送，唤醒优先级最高的一个 */
+            prvWakeWaitingTask(&(pxQueue->xTasksWaitingToSend), &xYieldRequired);
+            if (xYieldRequired == htTRUE)
             {
-                /* 获取任务TCB并移出等待列表 */
-                htTCB_t *pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
-                htListRemove(pxItem);
-                
-                /* 添加到就绪列表 */
-                pxTCB->uxTaskState = HT_TASK_READY;
-                htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), &(pxTCB->xStateListItem));
+                htTaskYield();
             }
+            
+            htExitCritical();
+            return htPASS;
         }
         
-        xReturn = htPASS;
-    }
-		
-    else if (xTicksToWait > 0)
-    {
-				__disable_irq();
-				if (pxCurrentTCB == NULL) {
-        __enable_irq();
-        return xReturn;
-        }     
-        
-        /* 将当前任务加入接收等待队列并阻塞 */
-        htListItem_t *pxStateListItem = &(pxCurrentTCB->xStateListItem);
-        
-        /* 从就绪列表中删除当前任务 */
-        htListRemove(pxStateListItem);
-        
-        /* 设置唤醒时间 */
-        if (xTicksToWait != 0xFFFFFFFF) /* 0xFFFFFFFF表示永久等待 */
+        /* 队列为空且不等待，或调度器尚未运行 */
+        if (xTicksToWait == 0 || pxCurrentTCB == NULL)
         {
-            xTimeToWake = xTickCount + xTicksToWait;
-            htListSetItemValue(&(pxCurrentTCB->xEventListItem), xTimeToWake);
+            break;
         }
         
-        /* 添加到接收等待队列 */
-        htListInsertEnd(&(pxQueue->xTasksWaitingToReceive), &(pxCurrentTCB->xEventListItem));
-        
-        /* 标记任务为阻塞状态 */
-        pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
-        
-        /* 退出临界区并进行任务切换 */
-				__enable_irq();
-        htTaskYield();
-				return htQueueReceive(xQueue, pvBuffer, xTicksToWait);
+        /* 阻塞直到有消息或超时 */
+        if (htWaitQueueBlock(&(pxQueue->xTasksWaitingToReceive), &xTicksToWait) == htWAIT_TIMEOUT)
+        {
+            break;
+        }
     }
     
     /* 退出临界区 */
     htExitCritical();
     
-    return xReturn;
+    return htFAIL;
 }
 
 /**
@@ -321,6 +311,7 @@ BaseType_t htQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue, B
 {
     BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
+    UBaseType_t uxSavedMask;
     
     /* 检查参数有效性 */
     if (pxQueue == NULL)
@@ -334,41 +325,23 @@ BaseType_t htQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue, B
         *pxHigherPriorityTaskWoken = htFALSE;
     }
     
+    /* 屏蔽同样会访问队列的其他中断 */
+    uxSavedMask = htEnterCriticalFromISR();
+    
     /* 检查是否有空间 */
-    if (pxQueue->uxMessagesWaiting < pxQueue->uxLength || pxQueue->uxItemSize == 0)
+    if (pxQueue->uxMessagesWaiting < pxQueue->uxLength)
     {
         /* 有空间，直接复制数据 */
         prvCopyDataToQueue(pxQueue, pvItemToQueue);
         
-        /* 如果有任务在等待读取，唤醒一个优先级最高的任务 */
-        if (htListGetCurrentNumberOfItems(&(pxQueue->xTasksWaitingToReceive)) > 0)
-        {
-            /* 获取等待列表中的第一个任务(优先级最高) */
-            htListItem_t *pxItem = htListGetHead(&(pxQueue->xTasksWaitingToReceive));
-            if (pxItem != NULL)
-            {
-                /* 获取任务TCB并移出等待列表 */
-                htTCB_t *pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
-                htListRemove(pxItem);
-                
-                /* 添加到就绪列表 */
-                pxTCB->uxTaskState = HT_TASK_READY;
-                htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), &(pxTCB->xStateListItem));
-                
-                /* 检查唤醒的任务优先级是否高于当前运行的任务 */
-                if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
-                {
-                    if (pxHigherPriorityTaskWoken != NULL)
-                    {
-                        *pxHigherPriorityTaskWoken = htTRUE;
-                    }
-                }
-            }
-        }
+        /* 如果有任务在等待读取，唤醒优先级最高的一个 */
+        prvWakeWaitingTask(&(pxQueue->xTasksWaitingToReceive), pxHigherPriorityTaskWoken);
         
         xReturn = htPASS;
     }
     
+    htExitCriticalFromISR(uxSavedMask);
+    
     return xReturn;
 }
 
@@ -379,6 +352,7 @@ BaseType_t htQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer, BaseType_
 {
     BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
+    UBaseType_t uxSavedMask;
     
     /* 检查参数有效性 */
     if (pxQueue == NULL || pvBuffer == NULL)
@@ -392,41 +366,22 @@ BaseType_t htQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer, BaseType_
         *pxHigherPriorityTaskWoken = htFALSE;
     }
     
+    uxSavedMask = htEnterCriticalFromISR();
+    
     /* 检查是否有消息 */
     if (pxQueue->uxMessagesWaiting > 0)
     {
         /* 有消息，直接接收 */
         prvCopyDataFromQueue(pxQueue, pvBuffer);
         
-        /* 如果有任务在等待发送，唤醒一个优先级最高的任务 */
-        if (htListGetCurrentNumberOfItems(&(pxQueue->xTasksWaitingToSend)) > 0)
-        {
-            /* 获取等待列表中的第一个任务(优先级最高) */
-            htListItem_t *pxItem = htListGetHead(&(pxQueue->xTasksWaitingToSend));
-            if (pxItem != NULL)
-            {
-                /* 获取任务TCB并移出等待列表 */
-                htTCB_t *pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
-                htListRemove(pxItem);
-                
-                /* 添加到就绪列表 */
-                pxTCB->uxTaskState = HT_TASK_READY;
-                htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), &(pxTCB->xStateListItem));
-                
-                /* 检查唤醒的任务优先级是否高于当前运行的任务 */
-                if (pxTCB->uxPriority > pxCurrentTCB->uxPriority)
-                {
-                    if (pxHigherPriorityTaskWoken != NULL)
-                    {
-                        *pxHigherPriorityTaskWoken = htTRUE;
-                    }
-                }
-            }
-        }
+        /* 如果有任务在等待发送，唤醒优先级最高的一个 */
+        prvWakeWaitingTask(&(pxQueue->xTasksWaitingToSend), pxHigherPriorityTaskWoken);
         
         xReturn = htPASS;
     }
     
+    htExitCriticalFromISR(uxSavedMask);
+    
     return xReturn;
 }
 
@@ -482,6 +437,27 @@ BaseType_t htQueueReset(QueueHandle_t xQueue)
     return htPASS;
 }
 
+/**
+ * 设置等待任务的唤醒顺序
+ * 默认按优先级唤醒；对公平性敏感的队列可改为先来先醒，应在投入使用前设置
+ */
+BaseType_t htQueueSetWaitOrder(QueueHandle_t xQueue, UBaseType_t uxOrder)
+{
+    htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
+    
+    if (pxQueue == NULL || (uxOrder != htWAIT_ORDER_PRIORITY && uxOrder != htWAIT_ORDER_FIFO))
+    {
+        return htFAIL;
+    }
+    
+    htEnterCritical();
+    htWaitQueueSetOrder(&(pxQueue->xTasksWaitingToSend), uxOrder);
+    htWaitQueueSetOrder(&(pxQueue->xTasksWaitingToReceive), uxOrder);
+    htExitCritical();
+    
+    return htPASS;
+}
+
 /**
  * 删除队列
  */
@@ -489,7 +465,9 @@ void htQueueDelete(QueueHandle_t xQueue)
 {
     htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
     
-    if (pxQueue != NULL)
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+    /* 静态创建的队列由调用者管理存储区 */
+    if (pxQueue != NULL && pxQueue->ucStaticallyAllocated == htFALSE)
     {
         /* 释放队列存储区 */
         if (pxQueue->pcHead != NULL)
@@ -500,15 +478,19 @@ void htQueueDelete(QueueHandle_t xQueue)
         /* 释放队列结构 */
         htPortFree(pxQueue);
     }
+#else
+    (void)pxQueue;
+#endif
 }
 
 /**
  * 查看队列中的数据但不移除
+ * 队列空时阻塞，被唤醒后用剩余的等待时间重试，超时返回htFAIL
  */
 BaseType_t htQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
 {
-    BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xQueue;
+    BaseType_t xYieldRequired = htFALSE;
     
     /* 检查参数有效性 */
     if (pxQueue == NULL || pvBuffer == NULL)
@@ -519,50 +501,43 @@ BaseType_t htQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksTo
     /* 禁用中断 */
     htEnterCritical();
     
-    /* 检查是否有消息 */
-    if (pxQueue->uxMessagesWaiting > 0)
+    for (;;)
     {
-        /* 有消息，复制但不移除 */
-        if (pxQueue->uxItemSize != 0)
+        /* 检查是否有消息 */
+        if (pxQueue->uxMessagesWaiting > 0)
         {
-            memcpy(pvBuffer, (void *)pxQueue->u.xQueue.pcReadFrom, pxQueue->uxItemSize);
+            /* 有消息，复制但不移除 */
+            if (pxQueue->uxItemSize != 0)
+            {
+                memcpy(pvBuffer, (void *)pxQueue->u.xQueue.pcReadFrom, pxQueue->uxItemSize);
+            }
+            
+            /* 数据仍在队列中，继续唤醒下一个等待接收的任务 */
+            prvWakeWaitingTask(&(pxQueue->xTasksWaitingToReceive), &xYieldRequired);
+            if (xYieldRequired == htTRUE)
+            {
+                htTaskYield();
+            }
+            
+            htExitCritical();
+            return htPASS;
         }
         
-        xReturn = htPASS;
-    }
-    else if (xTicksToWait > 0)
-    {
-        /* 队列为空，需要等待 */
-        /* 类似于htQueueReceive的等待逻辑 */
-        htListItem_t *pxStateListItem = &(pxCurrentTCB->xStateListItem);
-        
-        /* 从就绪列表中删除当前任务 */
-        htListRemove(pxStateListItem);
-        
-        /* 设置唤醒时间 */
-        TickType_t xTimeToWake = 0;
-        if (xTicksToWait != 0xFFFFFFFF) /* 0xFFFFFFFF表示永久等待 */
+        /* 队列为空且不等待，或调度器尚未运行 */
+        if (xTicksToWait == 0 || pxCurrentTCB == NULL)
         {
-            xTimeToWake = xTickCount + xTicksToWait;
-            htListSetItemValue(&(pxCurrentTCB->xEventListItem), xTimeToWake);
+            break;
         }
         
-        /* 添加到接收等待队列 */
-        htListInsertEnd(&(pxQueue->xTasksWaitingToReceive), &(pxCurrentTCB->xEventListItem));
-        
-        /* 标记任务为阻塞状态 */
-        pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
-        
-        /* 退出临界区并进行任务切换 */
-        htExitCritical();
-        htTaskYield();
-        
-        /* 任务被唤醒后继续执行，再次尝试查看 */
-        return htQueuePeek(xQueue, pvBuffer, 0);
+        /* 与htQueueReceive在同一个等待队列上阻塞 */
+        if (htWaitQueueBlock(&(pxQueue->xTasksWaitingToReceive), &xTicksToWait) == htWAIT_TIMEOUT)
+        {
+            break;
+        }
     }
     
     /* 退出临界区 */
     htExitCritical();
     
-    return xReturn;
+    return htFAIL;
 }
@@ -0,0 +1,44 @@
+/**
+ * @file htregistry.c
+ * @brief 链接期任务表 - 按htTasks段中的描述符创建任务
+ */
+#include "htregistry.h"
+
+#if configUSE_TASK_REGISTRY == 1
+
+#if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
+extern const htTaskDescriptor_t htTasks$$Base[];
+extern const htTaskDescriptor_t htTasks$$Limit[];
+#define htREGISTRY_BEGIN (htTasks$$Base)
+#define htREGISTRY_END (htTasks$$Limit)
+#elif defined(__ICCARM__) || defined(__ICCRX__)
+#pragma section = "htTasks"
+#define htREGISTRY_BEGIN ((const htTaskDescriptor_t *)__section_begin("htTasks"))
+#define htREGISTRY_END ((const htTaskDescriptor_t *)__section_end("htTasks"))
+#elif defined(__GNUC__)
+/* 段名是合法标识符时由链接器生成；弱引用使没有定义任何任务时两者都为NULL */
+extern const htTaskDescriptor_t __start_htTasks[] __attribute__((weak));
+extern const htTaskDescriptor_t __stop_htTasks[] __attribute__((weak));
+#define htREGISTRY_BEGIN (__start_htTasks)
+#define htREGISTRY_END (__stop_htTasks)
+#endif
+
+/**
+ * 创建任务表中的所有任务
+ */
+UBaseType_t htTaskCreateRegistered(void)
+{
+	const htTaskDescriptor_t *pxDesc;
+	UBaseType_t uxCreated = 0;
+
+	for (pxDesc = htREGISTRY_BEGIN; pxDesc < htREGISTRY_END; pxDesc++) {
+		if (htTaskCreateStatic(pxDesc->pxTaskCode, pxDesc->pcName, pxDesc->usStackDepth, NULL, pxDesc->uxPriority,
+					pxDesc->puxStackBuffer, pxDesc->pxTaskBuffer) != NULL) {
+			uxCreated++;
+		}
+	}
+
+	return uxCreated;
+}
+
+#endif /* configUSE_TASK_REGISTRY == 1 */
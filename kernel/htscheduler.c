@@ -1,11 +1,10 @@
 #include "htscheduler.h"
 #include "httask.h"
-#include "htport.h"
+#include "htPort.h"
 #include "htlist.h"
-#include "stm32f1xx_hal.h" 
+#include "httimer.h"
 #include <stddef.h>  // 提供NULL定义
 #include <stdio.h>   // 提供printf定义
-#include "core_cm3.h"    // 添加此头文件以提供NVIC函数和中断相关定义
 
 
 /* 外部函数声明 */
@@ -16,36 +15,21 @@ extern void htTaskYield(void);
 /* 外部变量声明 */
 extern htTCB_t *pxCurrentTCB;
 extern htList_t pxReadyTasksLists[];
-extern htList_t xDelayedTaskList1;
-extern htList_t xDelayedTaskList2;
-extern htList_t *pxDelayedTaskList;
-extern htList_t *pxOverflowDelayedTaskList;
 extern TickType_t xTickCount;
 
 
 
 /* 调度器变量 */
 static htSchedulerState_t xSchedulerState = HT_SCHEDULER_NOT_STARTED;
-static UBaseType_t uxSchedulerSuspended = 0;  /* 调度器挂起计数 */
+static volatile UBaseType_t uxSchedulerSuspended = 0;  /* 调度器挂起计数，中断中只读 */
 static BaseType_t xYieldPending = htFALSE;    /* 任务切换挂起标志 */
+static volatile BaseType_t xRotatePending = htFALSE; /* 当前任务让出本轮，下次切换轮到同优先级的下一个任务 */
 
 /* 临界区嵌套计数器 */
 volatile UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
 
 
 
-BaseType_t htPortStartScheduler(void)
-{
-    /* 重置临界区嵌套计数器 */
-    uxCriticalNesting = 0;
-    
-    /* 启动第一个任务 - 这个函数通常不会返回 */
-    htPortStartFirstTask();
-    
-    /* 如果到达这里，说明启动失败 */
-    return htFAIL;
-}
-
 /**
  * 初始化调度器
  */
@@ -73,34 +57,50 @@ void htStartScheduler(void)
         return;
     }
     
-    // 确保延时列表被初始化
-    htListInit(&xDelayedTaskList1);
-    htListInit(&xDelayedTaskList2);
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
-    
     // 创建空闲任务
     if (htprvCreateIdleTask() != htPASS) {
         printf("FATAL: Failed to create idle task!\r\n");
         return;
     }
 
+#if configUSE_TIMERS == 1
+    // 创建定时器守护任务
+    if (htTimerCreateTimerTask() != htPASS) {
+        printf("FATAL: Failed to create timer task!\r\n");
+        return;
+    }
+#endif
+
     
-    // 设置关键中断优先级
-    NVIC_SetPriority(PendSV_IRQn, 0xFF); // 最低优先级
-    NVIC_SetPriority(SysTick_IRQn, 0x70); // 较高优先级
-    
-    // 确保所有中断已正确配置
-    __enable_irq();
-    __DSB();
-    __ISB();
-    
+#if configGENERATE_RUN_TIME_STATS == 1
+    // 启动运行时间统计计数器
+    htPortConfigureRunTimeCounter();
+#endif
+
+    // 从最高优先级的就绪任务开始运行，而不是最先创建的任务
+    htTaskSwitchContext();
+
+#if configUSE_TIME_SLICING == 1
+    // 第一个任务没有经过切入，按启动前设置的时间片长度开始第一轮
+    pxCurrentTCB->uxTimeSliceLeft = pxCurrentTCB->uxTimeSlice;
+#endif
+
     // 更新系统状态
     xSchedulerState = HT_SCHEDULER_RUNNING;
     
-    // 启动第一个任务
-    vPortStartFirstTask();
-    
+    // 启动第一个任务，主机移植层在htTaskEndScheduler()之后从这里返回
+    (void)htPortStartScheduler();
+
+    xSchedulerState = HT_SCHEDULER_NOT_STARTED;
+}
+
+/**
+ * 停止调度器
+ * 主机移植层回到htStartScheduler()的调用者，目标板上停在移植层中
+ */
+void htTaskEndScheduler(void)
+{
+    htPortEndScheduler();
 }
 
 /**
@@ -168,12 +168,13 @@ void htSchedulerTickHandler(void)
  * 内核进入临界区
  */
 void htEnterCritical(void) {
+    /* 先禁用中断再计数，中断不会看到计数已加而中断仍开着的状态
+     * 由移植层实现(Cortex-M为BASEPRI，只屏蔽configMAX_SYSCALL_INTERRUPT_PRIORITY及以下的中断；
+     * 主机为屏蔽滴答信号) */
+    htPortDisableInterrupts();
+
     /* 增加嵌套计数 */
     uxCriticalNesting++;
-    
-    /* 禁用中断 - 实际实现将使用Cortex-M的PRIMASK或BASEPRI寄存器 */
-    /* 这里简化处理，实际需要根据目标MCU具体实现 */
-    __asm volatile ("cpsid i");
 }
 
 /**
@@ -187,11 +188,60 @@ void htExitCritical(void) {
         
         /* 如果计数为0，重新启用中断 */
         if (uxCriticalNesting == 0) {
-            __asm volatile ("cpsie i");
+            htPortEnableInterrupts();
         }
     }
 }
+
+/**
+ * 中断中进入临界区
+ * 不使用嵌套计数：中断可能打断任意代码，退出时恢复进入前的屏蔽状态
+ * @return 进入前的屏蔽状态，传给htExitCriticalFromISR()
+ */
+UBaseType_t htEnterCriticalFromISR(void) {
+    return htPortSetInterruptMaskFromISR();
+}
+
+/**
+ * 中断中退出临界区
+ * @param uxSavedMask htEnterCriticalFromISR()的返回值
+ */
+void htExitCriticalFromISR(UBaseType_t uxSavedMask) {
+    htPortClearInterruptMaskFromISR(uxSavedMask);
+}
  
+/**
+ * 在最高优先级就绪列表中选出下一个任务
+ * 列表游标pxIndex指向该优先级当前轮到的任务：
+ * - 当前任务仍在这个列表中：继续运行，除非它让出或时间片用完，此时轮到下一个
+ * - 当前任务是切走的更高优先级任务：被它抢占的任务继续剩余的时间片
+ * - 当前任务刚从这个列表中移除(阻塞/删除)：游标已退回前一项，轮到它后面的任务
+ * 开始新一轮的任务重新装满时间片
+ */
+static htTCB_t *prvSelectNextTask(htList_t *pxList, UBaseType_t uxTopPriority)
+{
+    htTCB_t *pxNextTCB;
+
+    if (htListGetItemContainer(&(pxCurrentTCB->xStateListItem)) == pxList) {
+        pxList->pxIndex = &(pxCurrentTCB->xStateListItem);
+        if (xRotatePending == htFALSE) {
+            return pxCurrentTCB;
+        }
+        pxNextTCB = (htTCB_t *)htListGetOwnerOfNextEntry(pxList);
+    } else if (pxCurrentTCB->uxPriority > uxTopPriority &&
+               pxList->pxIndex != (htListItem_t *)&(pxList->xListEnd)) {
+        return (htTCB_t *)htListGetItemOwner(pxList->pxIndex);
+    } else {
+        pxNextTCB = (htTCB_t *)htListGetOwnerOfNextEntry(pxList);
+    }
+
+#if configUSE_TIME_SLICING == 1
+    pxNextTCB->uxTimeSliceLeft = pxNextTCB->uxTimeSlice;
+#endif
+
+    return pxNextTCB;
+}
+
 /**
  * 上下文切换函数 - 增强健壮性
  * 选择下一个要运行的任务
@@ -212,45 +262,95 @@ void htTaskSwitchContext(void)
     if (pxCurrentTCB == NULL) {
         return;
     }
+
+#if configCHECK_FOR_STACK_OVERFLOW > 0
+    /* 移植层已保存切出任务的栈指针 */
+    htTaskCheckForStackOverflow();
+#endif
+
+#if configGENERATE_RUN_TIME_STATS == 1
+    /* 切出前把本次运行的时间计入当前任务 */
+    htTaskAccountRunTime();
+#endif
     
-    /* 选择最高优先级的就绪任务 */
-    UBaseType_t uxTopPriority = 0;
-    uint32_t safetyCounter = 0;
-    const uint32_t MAX_ITERATIONS = 32;
-    
-    /* 找到最高优先级的非空就绪列表 */
-    for (uxTopPriority = configMAX_PRIORITIES - 1; 
-         uxTopPriority > 0 && safetyCounter < MAX_ITERATIONS; 
-         uxTopPriority--) {
-        safetyCounter++;
-        if (htListGetCurrentNumberOfItems(&(pxReadyTasksLists[uxTopPriority])) > 0) {
-            break;
-        }
-    }
+    /* 选择最高优先级的就绪任务 - 由就绪位图经CLZ直接得到 */
+    UBaseType_t uxTopPriority = htTaskGetTopReadyPriority();
     
     /* 获取就绪列表 */
     htList_t *pxList = &(pxReadyTasksLists[uxTopPriority]);
     
-    /* 从就绪列表中获取下一个任务 */
-    htListItem_t *pxNextTCB = htListGetHead(pxList);
-    
     /* 如果找到就绪任务 */
-    if (pxNextTCB != NULL) {
-        /* 将列表索引移动到下一个项目 */
-        pxList->pxIndex = pxNextTCB;
-        
-        /* 获取任务控制块并验证 */
-        htTCB_t *pxNewTCB = (htTCB_t *)htListGetItemOwner(pxNextTCB);
+    if (htListGetCurrentNumberOfItems(pxList) > 0) {
+        /* 在同优先级的任务中轮转 */
+        htTCB_t *pxNewTCB = prvSelectNextTask(pxList, uxTopPriority);
         if (pxNewTCB != NULL) {
             /* 更新任务状态并设置当前TCB */
             pxNewTCB->uxTaskState = HT_TASK_RUNNING;
             pxCurrentTCB = pxNewTCB;
         }
     }
+
+    xRotatePending = htFALSE;
+}
+
+/**
+ * 判断下一次切换是否会换成另一个任务，只读，不移动列表游标
+ * 与prvSelectNextTask()的选择一致：当前任务仍在最高优先级就绪列表中时，
+ * 只有让出本轮且该列表中还有其他任务才会换人；不在该列表中(阻塞、删除、有更高优先级任务就绪)时一定换人
+ * 调用者负责临界区保护
+ *
+ * @param xRotate 当前任务是否让出本轮
+ * @return 会换成另一个任务时返回htTRUE
+ */
+static BaseType_t prvSwitchRequired(BaseType_t xRotate)
+{
+    htList_t *pxList = &(pxReadyTasksLists[htTaskGetTopReadyPriority()]);
+
+    if (htListGetItemContainer(&(pxCurrentTCB->xStateListItem)) != pxList)
+    {
+        return htTRUE;
+    }
+
+    return (xRotate == htTRUE && htListGetCurrentNumberOfItems(pxList) > 1) ? htTRUE : htFALSE;
+}
+
+/**
+ * 请求任务切换，并把当前任务的本轮让给同优先级的下一个就绪任务
+ * 时间片用完时由滴答中断调用，也可在任务中调用
+ * 先在C中判断切换后是否仍是当前任务，是则不触发PendSV，省去一次异常进出和寄存器保存恢复
+ */
+void htSchedulerRotate(void)
+{
+    UBaseType_t uxSavedMask;
+    BaseType_t xSwitchRequired = htTRUE;
+
+    uxSavedMask = htEnterCriticalFromISR();
+
+    /* 调度器挂起或未启动时照旧请求，由htTaskSwitchContext()记下挂起的切换 */
+    if (uxSchedulerSuspended == 0 && pxCurrentTCB != NULL)
+    {
+        xSwitchRequired = prvSwitchRequired(htTRUE);
+    }
+
+    /* 只置位不清除：之前已请求的轮转可能还没被PendSV处理 */
+    if (xSwitchRequired == htTRUE)
+    {
+        xRotatePending = htTRUE;
+    }
+
+    htExitCriticalFromISR(uxSavedMask);
+
+    if (xSwitchRequired == htTRUE)
+    {
+        htPortYield();
+    }
 }
 
 /**
  * 挂起调度器
+ * 挂起期间不发生任务切换，中断照常响应：中断唤醒的任务进入待就绪列表，
+ * 滴答只计数、到期处理推迟，因此只有任务会访问的长操作(遍历任务列表、堆分配等)
+ * 可以用挂起调度器代替关中断。只能在任务中调用
  * 
  * @return 当前挂起嵌套计数
  */
@@ -264,22 +364,54 @@ UBaseType_t htSchedulerSuspend(void)
 
 /**
  * 恢复调度器
+ * 完全恢复时在临界区内处理挂起期间积累的唤醒和到期，需要时请求任务切换
  */
 void htSchedulerResume(void)
 {
+    BaseType_t xYieldRequired = htFALSE;
+
+    htEnterCritical();
+
     /* 检查调度器是否被挂起 */
     if(uxSchedulerSuspended > 0)
     {
         /* 减少挂起计数 */
         uxSchedulerSuspended--;
         
-        /* 如果完全恢复且有挂起的上下文切换请求 */
-        if(uxSchedulerSuspended == 0 && xYieldPending == htTRUE)
+        if(uxSchedulerSuspended == 0)
         {
-            /* 触发上下文切换 */
-            htTaskYield();
+            /* 先移入中断唤醒的任务，再让定时轮追上挂起期间的滴答，
+             * 待就绪任务的超时项仍在定时轮中，顺序反过来会被当作超时再加入一次 */
+            (void)htTaskProcessPendingReady();
+            htTaskCheckDelayedTasks();
+
+            if(xYieldPending == htTRUE || htSchedulerNeedsSwitch() == htTRUE)
+            {
+                /* 挂起期间请求的切换在恢复时重新判断，选中的仍是当前任务时不触发PendSV */
+                xYieldRequired = prvSwitchRequired(xRotatePending);
+                xYieldPending = xYieldRequired;
+            }
         }
     }
+
+    htExitCritical();
+
+    /* 调度器启动前也可能挂起/恢复(如创建任务时分配内存)，此时不能切换 */
+    if(xYieldRequired == htTRUE && xSchedulerState == HT_SCHEDULER_RUNNING)
+    {
+        /* 触发上下文切换，不是让出，当前任务仍是最高优先级时继续本轮 */
+        htPortYield();
+    }
+}
+
+/**
+ * 查询调度器是否被挂起，可在中断中调用
+ * 
+ * @return 挂起时返回htTRUE
+ */
+BaseType_t htSchedulerIsSuspended(void)
+{
+    return (uxSchedulerSuspended != 0) ? htTRUE : htFALSE;
 }
 
 /**
@@ -297,13 +429,9 @@ BaseType_t htSchedulerNeedsSwitch(void)
         UBaseType_t uxCurrentPriority = pxCurrentTCB->uxPriority;
         
         /* 检查是否有更高优先级的任务就绪 */
-        for(UBaseType_t uxPriority = configMAX_PRIORITIES - 1; uxPriority > uxCurrentPriority; uxPriority--)
+        if(htTaskGetTopReadyPriority() > uxCurrentPriority)
         {
-            if(htListGetCurrentNumberOfItems(&(pxReadyTasksLists[uxPriority])) > 0)
-            {
-                xSwitchRequired = htTRUE;
-                break;
-            }
+            xSwitchRequired = htTRUE;
         }
     }
     
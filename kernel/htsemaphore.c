@@ -3,24 +3,62 @@
 #include "httask.h"
 #include "htmem.h"
 #include "htscheduler.h"
+#include <stddef.h>
 #include <stdio.h>
 
 
 
+/**
+ * 设置新建信号量的初始计数值
+ */
+static void prvSetInitialCount(QueueHandle_t xSemaphore, UBaseType_t uxInitialCount)
+{
+    htQUEUE_t *pxQueue = (htQUEUE_t *)xSemaphore;
+
+    if (pxQueue != NULL)
+    {
+        pxQueue->u.xSemaphore.uxSemaphoreCount = uxInitialCount;
+        pxQueue->uxMessagesWaiting = uxInitialCount;
+    }
+}
+
+#if configUSE_RECURSIVE_MUTEXES == 1
+/**
+ * 把初始的持有者信息存入新建的递归互斥量
+ * @return 递归互斥量句柄，失败时删除队列并返回NULL
+ */
+static SemaphoreHandle_t prvInitialiseRecursiveMutex(QueueHandle_t xSemaphore)
+{
+    htMutexHolder_t xMutexHolder;
+
+    if (xSemaphore != NULL)
+    {
+        /* 初始化互斥量持有者信息 */
+        xMutexHolder.xTaskHandle = NULL;
+        xMutexHolder.uxRecursiveCallCount = 0;
+
+        /* 将持有者信息存入队列，此后一直留在队列中，只在原位修改 */
+        if (htQueueSend(xSemaphore, &xMutexHolder, 0) != htPASS)
+        {
+            htQueueDelete(xSemaphore);
+            xSemaphore = NULL;
+        }
+    }
+
+    return xSemaphore;
+}
+#endif
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 /**
  * 创建二值信号量
  */
 SemaphoreHandle_t htSemaphoreCreateBinary(void)
 {
-    QueueHandle_t xSemaphore;
-    
     /* 创建长度为1的队列，不存储实际数据 */
-    xSemaphore = htQueueCreate(1, 0);
-    
     /* 默认创建为空（不可获取）状态 */
     /* 注意：如果需要创建后立即可用，需要调用htSemaphoreGive() */
-    
-    return xSemaphore;
+    return htQueueCreate(1, 0);
 }
 
 /**
@@ -29,7 +67,6 @@ SemaphoreHandle_t htSemaphoreCreateBinary(void)
 SemaphoreHandle_t htSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount)
 {
     QueueHandle_t xSemaphore;
-    htQUEUE_t *pxQueue;
     
     /* 检查参数有效性 */
     if (uxMaxCount == 0 || uxInitialCount > uxMaxCount)
@@ -39,15 +76,7 @@ SemaphoreHandle_t htSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t
     
     /* 创建长度为uxMaxCount的队列，不存储实际数据 */
     xSemaphore = htQueueCreate(uxMaxCount, 0);
-    
-    if (xSemaphore != NULL)
-    {
-        pxQueue = (htQUEUE_t *)xSemaphore;
-        
-        /* 设置初始计数值 */
-        pxQueue->u.xSemaphore.uxSemaphoreCount = uxInitialCount;
-        pxQueue->uxMessagesWaiting = uxInitialCount;
-    }
+    prvSetInitialCount(xSemaphore, uxInitialCount);
     
     return xSemaphore;
 }
@@ -58,19 +87,10 @@ SemaphoreHandle_t htSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t
 SemaphoreHandle_t htSemaphoreCreateMutex(void)
 {
     QueueHandle_t xSemaphore;
-    htQUEUE_t *pxQueue;
     
-    /* 创建长度为1的队列，不存储实际数据 */
+    /* 创建长度为1的队列，不存储实际数据，互斥量初始为满状态 */
     xSemaphore = htQueueCreate(1, 0);
-    
-    if (xSemaphore != NULL)
-    {
-        pxQueue = (htQUEUE_t *)xSemaphore;
-        
-        /* 互斥量初始为满状态 */
-        pxQueue->u.xSemaphore.uxSemaphoreCount = 1;
-        pxQueue->uxMessagesWaiting = 1;
-    }
+    prvSetInitialCount(xSemaphore, 1);
     
     return xSemaphore;
 }
@@ -82,58 +102,100 @@ SemaphoreHandle_t htSemaphoreCreateRecursiveMutex(void)
 {
     /* 仅在configUSE_RECURSIVE_MUTEXES启用时可用 */
 #if configUSE_RECURSIVE_MUTEXES == 1
-    QueueHandle_t xSemaphore;
-    //htQUEUE_t *pxQueue;
-    htMutexHolder_t *pxMutexHolder;
-    
     /* 创建长度为1的队列，存储互斥量持有者信息 */
-    xSemaphore = htQueueCreate(1, sizeof(htMutexHolder_t));
-    
-    if (xSemaphore != NULL)
+    return prvInitialiseRecursiveMutex(htQueueCreate(1, sizeof(htMutexHolder_t)));
+#else
+    /* 递归互斥量未启用，返回NULL */
+    return NULL;
+#endif
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建二值信号量
+ */
+SemaphoreHandle_t htSemaphoreCreateBinaryStatic(htStaticSemaphore_t *pxSemaphoreBuffer)
+{
+    if (pxSemaphoreBuffer == NULL)
     {
-        //pxQueue = (htQUEUE_t *)xSemaphore;
-        
-        /* 分配互斥量持有者结构 */
-        pxMutexHolder = (htMutexHolder_t *)htPortMalloc(sizeof(htMutexHolder_t));
-        
-        if (pxMutexHolder != NULL)
-        {
-            /* 初始化互斥量持有者信息 */
-            pxMutexHolder->xTaskHandle = NULL;
-            pxMutexHolder->uxRecursiveCallCount = 0;
-            
-            /* 将持有者信息存入队列 */
-            if (htQueueSend(xSemaphore, pxMutexHolder, 0) != htPASS)
-            {
-                /* 发送失败，释放内存 */
-                htPortFree(pxMutexHolder);
-                htQueueDelete(xSemaphore);
-                xSemaphore = NULL;
-            }
-            
-            /* 不再需要临时持有者结构 */
-            htPortFree(pxMutexHolder);
-        }
-        else
-        {
-            /* 内存分配失败，释放队列 */
-            htQueueDelete(xSemaphore);
-            xSemaphore = NULL;
-        }
+        return NULL;
     }
-    
+
+    return htQueueCreateStatic(1, 0, NULL, &(pxSemaphoreBuffer->xQueue));
+}
+
+/**
+ * 使用调用者提供的存储区创建计数信号量
+ */
+SemaphoreHandle_t htSemaphoreCreateCountingStatic(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount,
+    htStaticSemaphore_t *pxSemaphoreBuffer)
+{
+    QueueHandle_t xSemaphore;
+
+    /* 检查参数有效性 */
+    if (uxMaxCount == 0 || uxInitialCount > uxMaxCount || pxSemaphoreBuffer == NULL)
+    {
+        return NULL;
+    }
+
+    xSemaphore = htQueueCreateStatic(uxMaxCount, 0, NULL, &(pxSemaphoreBuffer->xQueue));
+    prvSetInitialCount(xSemaphore, uxInitialCount);
+
+    return xSemaphore;
+}
+
+/**
+ * 使用调用者提供的存储区创建互斥量
+ */
+SemaphoreHandle_t htSemaphoreCreateMutexStatic(htStaticSemaphore_t *pxSemaphoreBuffer)
+{
+    QueueHandle_t xSemaphore;
+
+    if (pxSemaphoreBuffer == NULL)
+    {
+        return NULL;
+    }
+
+    xSemaphore = htQueueCreateStatic(1, 0, NULL, &(pxSemaphoreBuffer->xQueue));
+    prvSetInitialCount(xSemaphore, 1);
+
     return xSemaphore;
+}
+
+/**
+ * 使用调用者提供的存储区创建递归互斥量，持有者信息存放在pxSemaphoreBuffer->xMutexHolder中
+ */
+SemaphoreHandle_t htSemaphoreCreateRecursiveMutexStatic(htStaticSemaphore_t *pxSemaphoreBuffer)
+{
+#if configUSE_RECURSIVE_MUTEXES == 1
+    if (pxSemaphoreBuffer == NULL)
+    {
+        return NULL;
+    }
+
+    return prvInitialiseRecursiveMutex(htQueueCreateStatic(1, sizeof(htMutexHolder_t),
+        (uint8_t *)&(pxSemaphoreBuffer->xMutexHolder), &(pxSemaphoreBuffer->xQueue)));
 #else
-    /* 递归互斥量未启用，返回NULL */
+    (void)pxSemaphoreBuffer;
     return NULL;
 #endif
 }
+#endif
 
 /**
  * 删除信号量
  */
 void htSemaphoreDelete(SemaphoreHandle_t xSemaphore)
 {
+    if (xSemaphore != NULL)
+    {
+        /* 仍被持有的互斥量先从持有者的链表上摘下 */
+        htEnterCritical();
+        htWaitQueueSetOwner(&(xSemaphore->xTasksWaitingToReceive), NULL);
+        htExitCritical();
+    }
+
     /* 直接使用队列删除函数 */
     htQueueDelete(xSemaphore);
 }
@@ -213,89 +275,149 @@ BaseType_t htSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHi
 }
 
 /**
- * 互斥量获取
+ * 当前任务成为互斥量的持有者
+ * 登记到当前任务的持有链表；释放后被抢先获取时可能还有等待者，立即继承它们的优先级
+ * 调用者负责临界区保护
  */
+static void prvTakeOwnership(htQUEUE_t *pxQueue)
+{
+    htWaitQueueSetOwner(&(pxQueue->xTasksWaitingToReceive), pxCurrentTCB);
+    htTaskPriorityInherit(pxCurrentTCB, htWaitQueueGetTopPriority(&(pxQueue->xTasksWaitingToReceive)));
+}
 
+/**
+ * 当前任务释放互斥量：从持有链表上摘下，按仍持有的互斥量的等待者重新计算优先级
+ * 调用者负责临界区保护
+ */
+static void prvReleaseOwnership(htQUEUE_t *pxQueue)
+{
+    const UBaseType_t uxOldPriority = pxCurrentTCB->uxPriority;
+
+    htWaitQueueSetOwner(&(pxQueue->xTasksWaitingToReceive), NULL);
+    htTaskPriorityUpdate(pxCurrentTCB);
+
+    /* 优先级降低后可能有更高优先级的任务就绪 */
+    if (pxCurrentTCB->uxPriority < uxOldPriority)
+    {
+        htTaskYield();
+    }
+}
+
+/**
+ * 唤醒一个等待获取互斥量的任务，其优先级更高时请求任务切换
+ * 调用者负责临界区保护
+ */
+static void prvWakeMutexWaiter(htQUEUE_t *pxQueue)
+{
+    htTCB_t *pxTCB = htWaitQueueWakeOne(&(pxQueue->xTasksWaitingToReceive));
+
+    if (pxTCB != NULL && pxCurrentTCB != NULL && pxTCB->uxPriority > pxCurrentTCB->uxPriority)
+    {
+        htTaskYield();
+    }
+}
+
+/**
+ * 交出被删除任务持有的互斥量和递归互斥量
+ * 获取时它们的接收等待队列都登记在任务的pxMutexesHeld上(轻量互斥量已由htMutexReleaseAll()交出)，
+ * 恢复为可用后唤醒一个等待者，由它重试获取
+ * 在htTaskDelete()的临界区内调用，调度器已挂起
+ */
+void htSemaphoreReleaseAll(htTCB_t *pxTCB)
+{
+    htQUEUE_t *pxQueue;
+    htMutexHolder_t *pxMutexHolder;
+
+    while (pxTCB->pxMutexesHeld != NULL)
+    {
+        pxQueue = (htQUEUE_t *)((int8_t *)pxTCB->pxMutexesHeld - offsetof(htQUEUE_t, xTasksWaitingToReceive));
+        htWaitQueueSetOwner(&(pxQueue->xTasksWaitingToReceive), NULL);
+
+        if (pxQueue->uxItemSize == 0)
+        {
+            /* 互斥量：归还计数 */
+            pxQueue->u.xSemaphore.pxMutexHolder = NULL;
+            pxQueue->uxMessagesWaiting++;
+            pxQueue->u.xSemaphore.uxSemaphoreCount++;
+        }
+        else
+        {
+            /* 递归互斥量：持有者信息在存储区开头，清除持有者和递归计数 */
+            pxMutexHolder = (htMutexHolder_t *)pxQueue->pcHead;
+            pxMutexHolder->xTaskHandle = NULL;
+            pxMutexHolder->uxRecursiveCallCount = 0;
+        }
+
+        prvWakeMutexWaiter(pxQueue);
+    }
+}
+
+/**
+ * 互斥量获取
+ * 被其他任务持有时提升持有者优先级并阻塞，被唤醒后用剩余的等待时间重试
+ */
 BaseType_t htSemaphoreTakeMutex(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
 {
-    BaseType_t xReturn;
-    uint8_t ucBuffer[4]; /* 临时缓冲区，实际不使用 */
+    htQUEUE_t *pxQueue = (htQUEUE_t *)xSemaphore;
+    
     //检查参数有效性
-    if (xSemaphore == NULL)
+    if (pxQueue == NULL)
     {
         return htFAIL;
     }
+    
     /* 禁用中断 */
     htEnterCritical();
-    /* 互斥量不可用，且当前任务不是持有者，则需要等待 */
-    htMutexHolder_t xMutexHolder;
-    if (htQueuePeek(xSemaphore, &xMutexHolder, 0) == htPASS)
+    
+    for (;;)
     {
-        if (xMutexHolder.xTaskHandle != NULL && xMutexHolder.xTaskHandle != pxCurrentTCB)
+        /* 互斥量可用，直接获取并记录持有者 */
+        if (pxQueue->uxMessagesWaiting > 0)
         {
-            //优先级继承
-            if (xMutexHolder.xTaskHandle != NULL && xMutexHolder.xTaskHandle != pxCurrentTCB)
-            {
-                if (pxCurrentTCB->uxPriority > xMutexHolder.xTaskHandle->uxPriority)
-                {
-                    //记录原始优先级
-                    if (xMutexHolder.uxOriginalPriority == 0)
-                    {
-                        xMutexHolder.uxOriginalPriority = xMutexHolder.xTaskHandle->uxPriority;
-                    }
-                    xMutexHolder.xTaskHandle->uxPriority = pxCurrentTCB->uxPriority;
-                    //重新排序就绪列表
-                    htListRemove(&(xMutexHolder.xTaskHandle->xStateListItem));
-                    htListInsertEnd(&(pxReadyTasksLists[xMutexHolder.xTaskHandle->uxPriority]), &(xMutexHolder.xTaskHandle->xStateListItem));
-                }
-            }
-            /* 互斥量被其他任务持有，需要等待 */
-            if (xTicksToWait > 0)
-            {
-                /* 从就绪列表中移除当前任务 */
-                htListRemove(&(pxCurrentTCB->xStateListItem));
-                
-                /* 设置唤醒时间 */
-                TickType_t xTimeToWake = 0;
-                if (xTicksToWait != 0xFFFFFFFF) /* 0xFFFFFFFF表示永久等待 */
-                {
-                    xTimeToWake = xTickCount + xTicksToWait;
-                    htListSetItemValue(&(pxCurrentTCB->xEventListItem), xTimeToWake);
-                }
-                
-                /* 添加到接收等待队列 */
-                htListInsertEnd(&(((htQUEUE_t *)xSemaphore)->xTasksWaitingToReceive), &(pxCurrentTCB->xEventListItem));
-                
-                /* 标记任务为阻塞状态 */
-                pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
-                
-                /* 退出临界区并进行任务切换 */
-                htExitCritical();
-                htTaskYield();
-                
-                /* 任务被唤醒后继续执行，再次尝试获取 */
-                return htSemaphoreTakeMutex(xSemaphore, 0);
-            }
-            else
+            pxQueue->uxMessagesWaiting--;
+            pxQueue->u.xSemaphore.uxSemaphoreCount--;
+            pxQueue->u.xSemaphore.pxMutexHolder = pxCurrentTCB;
+            if (pxCurrentTCB != NULL)
             {
-                /* 不等待，直接失败 */
-                htExitCritical();
-                return htFAIL;
+                prvTakeOwnership(pxQueue);
             }
+            
+            htExitCritical();
+            return htPASS;
+        }
+        
+        /* 不等待，或调度器尚未运行 */
+        if (xTicksToWait == 0 || pxCurrentTCB == NULL)
+        {
+            break;
+        }
+        
+        /* 优先级继承(沿持有链传递)，然后阻塞直到互斥量被释放或超时 */
+        htTaskPriorityInherit(pxQueue->u.xSemaphore.pxMutexHolder, pxCurrentTCB->uxPriority);
+        if (htWaitQueueBlock(&(pxQueue->xTasksWaitingToReceive), &xTicksToWait) == htWAIT_TIMEOUT)
+        {
+            /* 持有者不再继承本任务的优先级 */
+            htTaskPriorityUpdate(pxQueue->u.xSemaphore.pxMutexHolder);
+            break;
         }
     }
-    /* 使用队列接收实现互斥量获取 */
-    xReturn = htQueueReceive(xSemaphore, ucBuffer, xTicksToWait);
-
+    
     /* 释放中断 */
     htExitCritical();
-
-    return xReturn;
+    
+    return htFAIL;
 }
 
-
-
-
+#if configUSE_RECURSIVE_MUTEXES == 1
+/**
+ * 获取递归互斥量的持有者信息
+ * 持有者信息创建时存入队列后一直留在存储区开头，直接原位读写
+ */
+static htMutexHolder_t *prvGetMutexHolder(htQUEUE_t *pxQueue)
+{
+    return (htMutexHolder_t *)pxQueue->pcHead;
+}
+#endif
 
 /**
  * 递归互斥量获取
@@ -303,9 +425,8 @@ BaseType_t htSemaphoreTakeMutex(SemaphoreHandle_t xSemaphore, TickType_t xTicksT
 BaseType_t htSemaphoreTakeRecursive(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
 {
 #if configUSE_RECURSIVE_MUTEXES == 1
-    BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xSemaphore;
-    htMutexHolder_t xMutexHolder;
+    htMutexHolder_t *pxMutexHolder;
     
     /* 检查参数有效性 */
     if (pxQueue == NULL)
@@ -316,84 +437,51 @@ BaseType_t htSemaphoreTakeRecursive(SemaphoreHandle_t xSemaphore, TickType_t xTi
     /* 禁用中断 */
     htEnterCritical();
     
-    /* 检查互斥量是否可用或当前任务是否持有者 */
-    if (htQueuePeek(xSemaphore, &xMutexHolder, 0) == htPASS)
+    pxMutexHolder = prvGetMutexHolder(pxQueue);
+    for (;;)
     {
-        //如果当前任务优先级高于持有者任务优先级，则优先级继承
-        if (xMutexHolder.xTaskHandle != NULL && xMutexHolder.xTaskHandle != pxCurrentTCB)
+        if (pxMutexHolder->xTaskHandle == NULL)
         {
-            if (pxCurrentTCB->uxPriority > xMutexHolder.xTaskHandle->uxPriority)
+            /* 首次获取 */
+            pxMutexHolder->xTaskHandle = pxCurrentTCB;
+            pxMutexHolder->uxRecursiveCallCount = 1;
+            if (pxCurrentTCB != NULL)
             {
-                //记录原始优先级
-                if (xMutexHolder.uxOriginalPriority == 0)
-                {
-                    xMutexHolder.uxOriginalPriority = xMutexHolder.xTaskHandle->uxPriority;
-                }
-                xMutexHolder.xTaskHandle->uxPriority = pxCurrentTCB->uxPriority;
-                //重新排序就绪列表
-                htListRemove(&(xMutexHolder.xTaskHandle->xStateListItem));
-                htListInsertEnd(&(pxReadyTasksLists[xMutexHolder.xTaskHandle->uxPriority]), &(xMutexHolder.xTaskHandle->xStateListItem));
+                prvTakeOwnership(pxQueue);
             }
-        }
-        /* 互斥量可用，检查是否已被当前任务持有 */
-        if (xMutexHolder.xTaskHandle == NULL || xMutexHolder.xTaskHandle == pxCurrentTCB)
-        {
-            /* 更新互斥量持有者信息 */
-            htQueueReceive(xSemaphore, &xMutexHolder, 0);
             
-            if (xMutexHolder.xTaskHandle == NULL)
-            {
-                /* 首次获取 */
-                xMutexHolder.xTaskHandle = pxCurrentTCB;
-                xMutexHolder.uxRecursiveCallCount = 1;
-            }
-            else
-            {
-                /* 递归获取 */
-                xMutexHolder.uxRecursiveCallCount++;
-            }
-            
-            /* 将更新后的持有者信息存回互斥量 */
-            htQueueSend(xSemaphore, &xMutexHolder, 0);
-            
-            xReturn = htPASS;
+            htExitCritical();
+            return htPASS;
         }
-        else if (xTicksToWait > 0)
+        
+        if (pxMutexHolder->xTaskHandle == pxCurrentTCB)
         {
-            /* 互斥量被其他任务持有，需要等待 */
-            /* 禁用中断 */
-            htEnterCritical();
-            
-            /* 从就绪列表中移除当前任务 */
-            htListRemove(&(pxCurrentTCB->xStateListItem));
-            
-            /* 设置唤醒时间 */
-            TickType_t xTimeToWake = 0;
-            if (xTicksToWait != 0xFFFFFFFF) /* 0xFFFFFFFF表示永久等待 */
-            {
-                xTimeToWake = xTickCount + xTicksToWait;
-                htListSetItemValue(&(pxCurrentTCB->xEventListItem), xTimeToWake);
-            }
+            /* 递归获取 */
+            pxMutexHolder->uxRecursiveCallCount++;
             
-            /* 添加到接收等待队列 */
-            htListInsertEnd(&(pxQueue->xTasksWaitingToReceive), &(pxCurrentTCB->xEventListItem));
-            
-            /* 标记任务为阻塞状态 */
-            pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
-            
-            /* 退出临界区并进行任务切换 */
             htExitCritical();
-            htTaskYield();
-            
-            /* 任务被唤醒后继续执行，再次尝试获取 */
-            return htSemaphoreTakeRecursive(xSemaphore, 0);
+            return htPASS;
+        }
+        
+        /* 被其他任务持有，不等待或调度器尚未运行 */
+        if (xTicksToWait == 0 || pxCurrentTCB == NULL)
+        {
+            break;
+        }
+        
+        /* 优先级继承(沿持有链传递)，然后阻塞直到互斥量被完全释放或超时 */
+        htTaskPriorityInherit(pxMutexHolder->xTaskHandle, pxCurrentTCB->uxPriority);
+        if (htWaitQueueBlock(&(pxQueue->xTasksWaitingToReceive), &xTicksToWait) == htWAIT_TIMEOUT)
+        {
+            htTaskPriorityUpdate(pxMutexHolder->xTaskHandle);
+            break;
         }
     }
     
     /* 退出临界区 */
     htExitCritical();
     
-    return xReturn;
+    return htFAIL;
 #else
     /* 递归互斥量未启用 */
     (void)xSemaphore;
@@ -406,39 +494,39 @@ BaseType_t htSemaphoreTakeRecursive(SemaphoreHandle_t xSemaphore, TickType_t xTi
 /**
  * 互斥量释放
  */
-
 BaseType_t htSemaphoreGiveMutex(SemaphoreHandle_t xSemaphore)
 {
-    BaseType_t xReturn;
-    uint8_t ucDummy = 0; /* 占位数据，实际内容无关紧要 */
+    BaseType_t xReturn = htFAIL;
+    htQUEUE_t *pxQueue = (htQUEUE_t *)xSemaphore;
+    
     //检查参数有效性
-    if (xSemaphore == NULL)
+    if (pxQueue == NULL)
     {
         return htFAIL;
     }
+    
     /* 禁用中断 */
     htEnterCritical();
-    /* 恢复原始优先级（如果有） */
-    htMutexHolder_t xMutexHolder;
-    if (htQueuePeek(xSemaphore, &xMutexHolder, 0) == htPASS)
+    
+    /* 只有持有者才能释放(调度器启动前持有者与当前任务均为NULL) */
+    if (pxQueue->u.xSemaphore.pxMutexHolder == pxCurrentTCB &&
+        pxQueue->uxMessagesWaiting < pxQueue->uxLength)
     {
-        if (xMutexHolder.xTaskHandle == pxCurrentTCB)
+        /* 恢复到基础优先级或仍持有的其他互斥量的等待者的优先级 */
+        if (pxCurrentTCB != NULL)
         {
-            if (xMutexHolder.uxOriginalPriority != 0)
-            {
-                xMutexHolder.xTaskHandle->uxPriority = xMutexHolder.uxOriginalPriority;
-                //重新排序就绪列表
-                htListRemove(&(xMutexHolder.xTaskHandle->xStateListItem));
-                htListInsertEnd(&(pxReadyTasksLists[xMutexHolder.xTaskHandle->uxPriority]), &(xMutexHolder.xTaskHandle->xStateListItem));
-                
-                xMutexHolder.uxOriginalPriority = 0; //重置原始优先级
-            }
+            prvReleaseOwnership(pxQueue);
         }
+        
+        pxQueue->u.xSemaphore.pxMutexHolder = NULL;
+        pxQueue->uxMessagesWaiting++;
+        pxQueue->u.xSemaphore.uxSemaphoreCount++;
+        
+        /* 唤醒一个等待者 */
+        prvWakeMutexWaiter(pxQueue);
+        
+        xReturn = htPASS;
     }
-   
-
-    /* 使用队列发送实现互斥量释放 */
-    xReturn = htQueueSend(xSemaphore, &ucDummy, 0);
     
     /* 释放中断 */
     htExitCritical();
@@ -456,7 +544,7 @@ BaseType_t htSemaphoreGiveRecursive(SemaphoreHandle_t xSemaphore)
 #if configUSE_RECURSIVE_MUTEXES == 1
     BaseType_t xReturn = htFAIL;
     htQUEUE_t *pxQueue = (htQUEUE_t *)xSemaphore;
-    htMutexHolder_t xMutexHolder;
+    htMutexHolder_t *pxMutexHolder;
     
     /* 检查参数有效性 */
     if (pxQueue == NULL)
@@ -468,37 +556,21 @@ BaseType_t htSemaphoreGiveRecursive(SemaphoreHandle_t xSemaphore)
     htEnterCritical();
     
     /* 检查互斥量是否由当前任务持有 */
-    if (htQueuePeek(xSemaphore, &xMutexHolder, 0) == htPASS)
+    pxMutexHolder = prvGetMutexHolder(pxQueue);
+    if (pxMutexHolder->xTaskHandle != NULL && pxMutexHolder->xTaskHandle == pxCurrentTCB)
     {
-        if (xMutexHolder.xTaskHandle == pxCurrentTCB)
+        /* 减少递归计数 */
+        pxMutexHolder->uxRecursiveCallCount--;
+        
+        if (pxMutexHolder->uxRecursiveCallCount == 0)
         {
-            /* 恢复原始优先级（如果有） */
-            if (xMutexHolder.uxOriginalPriority != 0)
-            {
-                xMutexHolder.xTaskHandle->uxPriority = xMutexHolder.uxOriginalPriority;
-                //重新排序就绪列表
-                htListRemove(&(xMutexHolder.xTaskHandle->xStateListItem));
-                htListInsertEnd(&(pxReadyTasksLists[xMutexHolder.xTaskHandle->uxPriority]), &(xMutexHolder.xTaskHandle->xStateListItem));
-                
-                xMutexHolder.uxOriginalPriority = 0; //重置原始优先级
-            }
-            /* 当前任务持有互斥量，更新持有者信息 */
-            htQueueReceive(xSemaphore, &xMutexHolder, 0);
-            
-            /* 减少递归计数 */
-            xMutexHolder.uxRecursiveCallCount--;
-            
-            if (xMutexHolder.uxRecursiveCallCount == 0)
-            {
-                /* 递归计数为0，互斥量完全释放 */
-                xMutexHolder.xTaskHandle = NULL;
-            }
-            
-            /* 将更新后的持有者信息存回互斥量 */
-            htQueueSend(xSemaphore, &xMutexHolder, 0);
-            
-            xReturn = htPASS;
+            /* 递归计数为0，互斥量完全释放：重新计算优先级并唤醒一个等待者 */
+            pxMutexHolder->xTaskHandle = NULL;
+            prvReleaseOwnership(pxQueue);
+            prvWakeMutexWaiter(pxQueue);
         }
+        
+        xReturn = htPASS;
     }
     
     /* 退出临界区 */
@@ -2,10 +2,14 @@
 #include "htmem.h"
 #include "htlist.h"
 #include "htscheduler.h"
+#include "httimewheel.h"
+#include "htwait.h"
+#include "htmutex.h"
+#include "htsemaphore.h"
+#include "htutils.h"
+#include "htPort.h"
 #include <stdio.h> // 添加 stdio 头文件解决 printf 未声明问题
 #include <string.h>
-#include "stm32f1xx_hal.h"
-#include "core_cm3.h" // 添加此头文件以提供NVIC函数和中断相关定义
 
 /* 全局变量 */
 htTCB_t *pxCurrentTCB = NULL; /* 当前运行的任务TCB */
@@ -14,15 +18,37 @@ TickType_t xTickCount = 0; /* 系统tick计数 */
 
 /* 任务就绪列表 */
 htList_t pxReadyTasksLists[configMAX_PRIORITIES];
-/* 延时任务列表 */
-htList_t xDelayedTaskList1;
-htList_t xDelayedTaskList2;
-htList_t *pxDelayedTaskList;
-htList_t *pxOverflowDelayedTaskList;
+/* 就绪优先级位图 */
+htPriorityBitmap_t xReadyPriorities;
+/* 延时任务定时轮 - 取代原来的两条按唤醒时间排序的延时列表 */
+htTimeWheel_t xDelayedTaskWheel;
 /* 挂起任务列表 */
 static htList_t xSuspendedTaskList;
+/* 待就绪列表：调度器挂起期间被唤醒的任务(xEventListItem)，恢复调度器时移入就绪列表 */
+static htList_t xPendingReadyList;
 // 所有任务列表
 htList_t pxAllocatedTasksList;
+/* 终止列表：已删除自身的任务(xStateListItem)，栈还在使用中，由空闲任务回收 */
+static htList_t xTasksWaitingTermination;
+static volatile UBaseType_t uxDeletedTasksWaitingCleanUp = 0;
+/* 空闲任务 */
+static htTCB_t *pxIdleTaskTCB = NULL;
+
+#if configGENERATE_RUN_TIME_STATS == 1
+/* 运行时间采样：某一秒边界时的累计值 */
+typedef struct htRunTimeSample {
+	uint64_t ullTotal; /* 所有任务累计运行时间 */
+	uint64_t ullIdle; /* 空闲任务累计运行时间 */
+} htRunTimeSample_t;
+
+static uint64_t ullTotalRunTime = 0; /* 所有任务累计运行时间 */
+static uint32_t ulLastRunTimeCount = 0; /* 上次记账时的计数器读数 */
+static TickType_t xLastRunTimeSampleTick = 0; /* 上次采样的tick */
+/* 最近configRUN_TIME_STATS_WINDOW秒的采样环，uxRunTimeSampleIndex指向最旧的采样；
+ * 多留一个采样，刚采样后最旧的采样正好在N秒前；未满一个窗口时最旧的采样为全0，即从启动开始统计 */
+static htRunTimeSample_t xRunTimeSamples[configRUN_TIME_STATS_WINDOW + 1];
+static UBaseType_t uxRunTimeSampleIndex = 0;
+#endif
 
 /**
  * 检查调度器是否需要切换任务
@@ -43,165 +69,240 @@ void prvInitialiseTaskLists(void)
 	for (uxPriority = 0; uxPriority < configMAX_PRIORITIES; uxPriority++) {
 		htListInit(&(pxReadyTasksLists[uxPriority]));
 	}
+	htBitmapInit(&xReadyPriorities);
 
-	/* 初始化延时任务列表 */
-	htListInit(&xDelayedTaskList1);
-	htListInit(&xDelayedTaskList2);
-	pxDelayedTaskList = &xDelayedTaskList1;
-	pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	/* 初始化延时任务定时轮 */
+	htTimeWheelInit(&xDelayedTaskWheel, xTickCount);
 
 	/* 初始化挂起任务列表 */
 	htListInit(&xSuspendedTaskList);
 
+	/* 初始化待就绪列表 */
+	htListInit(&xPendingReadyList);
+
 	/* 初始化所有任务列表 */
 	htListInit(&pxAllocatedTasksList);
+	htListInit(&xTasksWaitingTermination);
 }
 
 /**
- * 初始化任务栈
+ * 将任务加入其优先级对应的就绪列表末尾，并标记位图
+ * 调用者负责临界区保护
  */
-static StackType_t *prvInitialiseTaskStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+void htTaskAddToReadyList(htTCB_t *pxTCB)
 {
-	// 确保8字节对齐
-	pxTopOfStack = (StackType_t *)((((uint32_t)pxTopOfStack) & ~0x7UL));
+	htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), &(pxTCB->xStateListItem));
+	htBitmapSet(&xReadyPriorities, pxTCB->uxPriority);
+}
 
-	// 首先清零整个栈区域
-	memset((void *)((uint32_t)pxTopOfStack - 64), 0, 64);
+/**
+ * 将任务从其所在的状态列表中移除
+ * 若移出的是就绪列表且该列表变空，则清除位图中对应的位。
+ * 按容器地址而不是uxPriority计算位置，优先级继承修改过uxPriority时也正确。
+ * 调用者负责临界区保护
+ */
+void htTaskRemoveFromReadyList(htTCB_t *pxTCB)
+{
+	htList_t *pxList = htListGetItemContainer(&(pxTCB->xStateListItem));
 
-	// 构建异常框架 - 从底向上
-	*(--pxTopOfStack) = 0x01000000; /* xPSR - T位置位 */
-	*(--pxTopOfStack) = ((uint32_t)pxCode) | 1UL; /* PC指向任务函数，强制设置LSB确保Thumb模式 */
-	*(--pxTopOfStack) = 0xFFFFFFFEUL; /* LR - 异常返回标记 */
-	*(--pxTopOfStack) = 0; /* R12 */
-	*(--pxTopOfStack) = 0; /* R3 */
-	*(--pxTopOfStack) = 0; /* R2 */
-	*(--pxTopOfStack) = 0; /* R1 */
-	*(--pxTopOfStack) = (uint32_t)pvParameters; /* R0 - 任务参数 */
+	if (pxList == NULL) {
+		return;
+	}
 
-	// 构建软件保存的寄存器
-	*(--pxTopOfStack) = 0; /* R11 */
-	*(--pxTopOfStack) = 0; /* R10 */
-	*(--pxTopOfStack) = 0; /* R9 */
-	*(--pxTopOfStack) = 0; /* R8 */
-	*(--pxTopOfStack) = 0; /* R7 */
-	*(--pxTopOfStack) = 0; /* R6 */
-	*(--pxTopOfStack) = 0; /* R5 */
-	*(--pxTopOfStack) = 0; /* R4 */
+	if (htListRemove(&(pxTCB->xStateListItem)) == 0 && pxList >= &(pxReadyTasksLists[0]) &&
+			pxList < &(pxReadyTasksLists[configMAX_PRIORITIES])) {
+		htBitmapClear(&xReadyPriorities, (UBaseType_t)(pxList - pxReadyTasksLists));
+	}
+}
 
-	// 打印任务栈配置信息 (使用英文避免编码问题)
-	printf("Task stack setup: PC=0x%08lx (with Thumb bit), Param=0x%08lx, SP=%p\r\n", ((uint32_t)pxCode) | 1UL,
-			(uint32_t)pvParameters, pxTopOfStack);
+/**
+ * 解除阻塞：撤销超时并移入就绪列表
+ * 调度器挂起时只把事件列表项放入待就绪列表，不碰就绪列表和定时轮，
+ * 这样挂起调度器的长操作可以不关中断；任务保持阻塞状态，直到htSchedulerResume()处理。
+ * 可在任务或ISR中调用，调用者负责临界区保护，任务已不在任何等待队列中
+ */
+void htTaskUnblock(htTCB_t *pxTCB)
+{
+	if (htSchedulerIsSuspended() == htTRUE) {
+		htListInsertEnd(&xPendingReadyList, &(pxTCB->xEventListItem));
+		return;
+	}
 
-	return pxTopOfStack;
+	if (htListGetItemContainer(&(pxTCB->xStateListItem)) != NULL) {
+		htListRemove(&(pxTCB->xStateListItem));
+	}
+	pxTCB->uxTaskState = HT_TASK_READY;
+	htTaskAddToReadyList(pxTCB);
 }
 
 /**
- * 创建新任务 - 确保任务创建成功
+ * 把待就绪列表中的任务移入就绪列表，由htSchedulerResume()在调度器完全恢复后调用
+ * 调用者负责临界区保护
+ * @return 移入的任务数
  */
-BaseType_t htTaskCreate(TaskFunction_t pxTaskCode, const char *const pcName, const uint16_t usStackDepth,
-		void *const pvParameters, UBaseType_t uxPriority, TaskHandle_t *const pxCreatedTask)
+UBaseType_t htTaskProcessPendingReady(void)
 {
-	htTCB_t *pxNewTCB;
-	StackType_t *pxStack;
-	BaseType_t xReturn = htPASS;
+	htListItem_t *pxItem;
+	htTCB_t *pxTCB;
+	UBaseType_t uxMoved = 0;
 
+	while ((pxItem = htListGetHead(&xPendingReadyList)) != NULL) {
+		pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+		htListRemove(pxItem);
+		htTaskUnblock(pxTCB);
+		uxMoved++;
+	}
+
+	return uxMoved;
+}
+
+/**
+ * 初始化新任务的TCB和栈，并加入所有任务列表和就绪列表
+ * @param pxStack 栈存储区，共usStackDepth个字
+ * @param pxNewTCB TCB存储区
+ * @param ucStaticallyAllocated htTRUE表示存储区由调用者提供，删除任务时不释放
+ */
+static void prvInitialiseNewTask(TaskFunction_t pxTaskCode, const char *const pcName, const uint16_t usStackDepth,
+		void *const pvParameters, UBaseType_t uxPriority, StackType_t *pxStack, htTCB_t *pxNewTCB,
+		uint8_t ucStaticallyAllocated)
+{
 	/* 检查优先级范围 */
 	if (uxPriority >= configMAX_PRIORITIES) {
 		uxPriority = configMAX_PRIORITIES - 1;
 	}
 
-	/* 分配TCB内存 */
-	pxNewTCB = (htTCB_t *)htPortMalloc(sizeof(htTCB_t));
+	/* 整个栈填充为固定图案，之后按字扫描未被改写的部分即可得到栈使用高水位 */
+	for (uint16_t i = 0; i < usStackDepth; i++) {
+		pxStack[i] = (StackType_t)configSTACK_FILL_PATTERN;
+	}
 
-	if (pxNewTCB != NULL) {
-		/* 分配任务堆栈内存 */
-		// 确保分配的栈大小至少是128字节
-		uint16_t usActualStackDepth = usStackDepth;
-		if (usActualStackDepth < configMINIMAL_STACK_SIZE) {
-			usActualStackDepth = configMINIMAL_STACK_SIZE;
-		}
+	/* 初始化TCB内存 */
+	memset(pxNewTCB, 0, sizeof(htTCB_t));
+	pxNewTCB->ucStaticallyAllocated = ucStaticallyAllocated;
 
-		pxStack = (StackType_t *)htPortMalloc(usActualStackDepth * sizeof(StackType_t));
-
-		if (pxStack != NULL) {
-			/* 确保栈初始化为0，避免垃圾值 */
-			memset(pxStack, 0, usActualStackDepth * sizeof(StackType_t));
-
-			/* 初始化TCB内存 */
-			memset(pxNewTCB, 0, sizeof(htTCB_t));
-
-			/* 初始化堆栈 */
-			pxNewTCB->pxStack = pxStack;
-			pxNewTCB->uxStackDepth = usActualStackDepth;
-
-			/* 复制任务名称 */
-			strncpy(pxNewTCB->pcTaskName, pcName, configMAX_TASK_NAME_LEN - 1);
-			pxNewTCB->pcTaskName[configMAX_TASK_NAME_LEN - 1] = '\0';
-
-			/* 使用安全的栈初始化函数 */
-			pxNewTCB->pxTopOfStack =
-					prvInitialiseTaskStack(pxNewTCB->pxStack + usActualStackDepth - 1, pxTaskCode, pvParameters);
-
-			/* 输出初始化结果用于调试 */
-			printf("Task %s stack: base=%p, top=%p\r\n", pxNewTCB->pcTaskName, (void *)pxNewTCB->pxStack,
-					(void *)pxNewTCB->pxTopOfStack);
-
-			/* 初始化任务优先级 */
-			pxNewTCB->uxPriority = uxPriority;
-			pxNewTCB->uxBasePriority = uxPriority;
-
-			/* 初始化列表项 */
-			htListItemInit(&(pxNewTCB->xStateListItem));
-			htListItemInit(&(pxNewTCB->xEventListItem));
-			/* 添加到所有任务列表 */
-			/* 为所有任务列表分配独立的链表项（避免侵入冲突） */
-			htListItem_t *pxAllocItem = (htListItem_t *)htPortMalloc(sizeof(htListItem_t));
-			if (pxAllocItem != NULL) {
-				htListItemInit(pxAllocItem);
-				/* 所有任务列表中保存对 TCB 的所有权，以便信息查询 */
-				htListSetItemOwner(pxAllocItem, pxNewTCB);
-				/* 可选：将值设为优先级或其它标记 */
-				htListSetItemValue(pxAllocItem, configMAX_PRIORITIES - uxPriority);
-				htListInsertEnd(&pxAllocatedTasksList, pxAllocItem);
-			} else {
-				/* 分配失败则忽略，不影响任务创建 */
-			}
+	/* 初始化堆栈 */
+	pxNewTCB->pxStack = pxStack;
+	pxNewTCB->uxStackDepth = usStackDepth;
+	pxNewTCB->uxStackHighWaterMark = usStackDepth;
 
-			/* 设置列表项的所有者 */
-			htListSetItemOwner(&(pxNewTCB->xStateListItem), pxNewTCB);
-			htListSetItemOwner(&(pxNewTCB->xEventListItem), pxNewTCB);
+	/* 复制任务名称 */
+	strncpy(pxNewTCB->pcTaskName, pcName, configMAX_TASK_NAME_LEN - 1);
+	pxNewTCB->pcTaskName[configMAX_TASK_NAME_LEN - 1] = '\0';
 
-			/* 设置列表项值为优先级，用于优先级排序 */
-			htListSetItemValue(&(pxNewTCB->xStateListItem), configMAX_PRIORITIES - uxPriority);
+	/* 使用安全的栈初始化函数 */
+	pxNewTCB->pxTopOfStack = htPortInitialiseStack(pxNewTCB->pxStack + usStackDepth - 1, pxTaskCode, pvParameters);
 
-			/* 添加到就绪列表 */
-			pxNewTCB->uxTaskState = HT_TASK_READY;
-			htListInsertEnd(&(pxReadyTasksLists[uxPriority]), &(pxNewTCB->xStateListItem));
+#if configDEBUG_TASK_CREATE == 1
+	/* 输出初始化结果用于调试 */
+	printf("Task %s stack: base=%p, top=%p\r\n", pxNewTCB->pcTaskName, (void *)pxNewTCB->pxStack,
+			(void *)pxNewTCB->pxTopOfStack);
+#endif
 
-			/* 更新任务计数 */
-			uxCurrentNumberOfTasks++;
+	/* 初始化任务优先级 */
+	pxNewTCB->uxPriority = uxPriority;
+	pxNewTCB->uxBasePriority = uxPriority;
+#if configUSE_TIME_SLICING == 1
+	pxNewTCB->uxTimeSlice = configTIME_SLICE_TICKS;
+	pxNewTCB->uxTimeSliceLeft = configTIME_SLICE_TICKS;
+#endif
 
-			/* 如果创建的是第一个任务，设为当前任务 */
-			if (pxCurrentTCB == NULL) {
-				pxCurrentTCB = pxNewTCB;
-			}
+	/* 初始化列表项 */
+	htListItemInit(&(pxNewTCB->xStateListItem));
+	htListItemInit(&(pxNewTCB->xEventListItem));
+	htListItemInit(&(pxNewTCB->xAllListItem));
 
-			/* 返回任务句柄 */
-			if (pxCreatedTask != NULL) {
-				*pxCreatedTask = (TaskHandle_t)pxNewTCB;
-			}
-		} else {
-			/* 堆栈分配失败，释放TCB内存并返回失败 */
-			htPortFree(pxNewTCB);
-			xReturn = htFAIL;
-		}
-	} else {
-		xReturn = htFAIL;
+	/* 设置列表项的所有者 */
+	htListSetItemOwner(&(pxNewTCB->xStateListItem), pxNewTCB);
+	htListSetItemOwner(&(pxNewTCB->xEventListItem), pxNewTCB);
+	htListSetItemOwner(&(pxNewTCB->xAllListItem), pxNewTCB);
+
+	/* 设置列表项值为优先级，用于优先级排序 */
+	htListSetItemValue(&(pxNewTCB->xStateListItem), configMAX_PRIORITIES - uxPriority);
+	htListSetItemValue(&(pxNewTCB->xAllListItem), configMAX_PRIORITIES - uxPriority);
+
+	/* 挂起调度器期间中断不会访问就绪列表，插入各列表不需要关中断 */
+	htSchedulerSuspend();
+
+	/* 添加到所有任务列表，使用TCB内嵌的列表项，不需要额外分配 */
+	htListInsertEnd(&pxAllocatedTasksList, &(pxNewTCB->xAllListItem));
+
+	/* 添加到就绪列表 */
+	pxNewTCB->uxTaskState = HT_TASK_READY;
+	htTaskAddToReadyList(pxNewTCB);
+
+	/* 更新任务计数 */
+	uxCurrentNumberOfTasks++;
+
+	/* 如果创建的是第一个任务，设为当前任务 */
+	if (pxCurrentTCB == NULL) {
+		pxCurrentTCB = pxNewTCB;
 	}
 
-	return xReturn;
+	htSchedulerResume();
 }
 
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+/**
+ * 创建新任务 - TCB和栈从堆分配
+ */
+BaseType_t htTaskCreate(TaskFunction_t pxTaskCode, const char *const pcName, const uint16_t usStackDepth,
+		void *const pvParameters, UBaseType_t uxPriority, TaskHandle_t *const pxCreatedTask)
+{
+	htTCB_t *pxNewTCB;
+	StackType_t *pxStack;
+	uint16_t usActualStackDepth = usStackDepth;
+
+	// 确保分配的栈大小不小于configMINIMAL_STACK_SIZE
+	if (usActualStackDepth < configMINIMAL_STACK_SIZE) {
+		usActualStackDepth = configMINIMAL_STACK_SIZE;
+	}
+
+	/* 分配TCB内存 */
+	pxNewTCB = (htTCB_t *)htPortMalloc(sizeof(htTCB_t));
+	if (pxNewTCB == NULL) {
+		return htFAIL;
+	}
+
+	/* 分配任务堆栈内存 */
+	pxStack = (StackType_t *)htPortMalloc(usActualStackDepth * sizeof(StackType_t));
+	if (pxStack == NULL) {
+		/* 堆栈分配失败，释放TCB内存并返回失败 */
+		htPortFree(pxNewTCB);
+		return htFAIL;
+	}
+
+	prvInitialiseNewTask(pxTaskCode, pcName, usActualStackDepth, pvParameters, uxPriority, pxStack, pxNewTCB,
+			htFALSE);
+
+	/* 返回任务句柄 */
+	if (pxCreatedTask != NULL) {
+		*pxCreatedTask = (TaskHandle_t)pxNewTCB;
+	}
+
+	return htPASS;
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的TCB和栈创建任务
+ * 栈大小就是存储区大小，不按configMINIMAL_STACK_SIZE放大
+ */
+TaskHandle_t htTaskCreateStatic(TaskFunction_t pxTaskCode, const char *const pcName, const uint16_t usStackDepth,
+		void *const pvParameters, UBaseType_t uxPriority, StackType_t *const puxStackBuffer,
+		htTCB_t *const pxTaskBuffer)
+{
+	if (puxStackBuffer == NULL || pxTaskBuffer == NULL || usStackDepth == 0) {
+		return NULL;
+	}
+
+	prvInitialiseNewTask(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, puxStackBuffer, pxTaskBuffer,
+			htTRUE);
+
+	return (TaskHandle_t)pxTaskBuffer;
+}
+#endif
+
 /**
  * 增加系统时钟计数
  * 此函数用在htSchedulerTickHandler中以避免未使用警告
@@ -211,6 +312,99 @@ void htIncrementTick(void)
 	xTickCount++;
 }
 
+#if configIDLE_STACK_SCAN_PERIOD > 0
+/**
+ * 空闲任务周期性扫描所有任务的栈
+ * 剩余栈低于configSTACK_LOW_WATERMARK且比上次扫描更少时打印警告。
+ * 与回收已删除任务一样，每个任务只在挂起调度器时扫描，扫描之间恢复调度器，
+ * 警告在恢复后打印；其间有任务被删除时序号后移，可能漏扫一个任务，下个周期再补上
+ */
+static void prvIdleStackScan(void)
+{
+	static TickType_t xLastScanTick = 0;
+	htListItem_t *pxEnd = (htListItem_t *)&(pxAllocatedTasksList.xListEnd);
+	htListItem_t *pxItem;
+	htTCB_t *pxTCB;
+	char cName[configMAX_TASK_NAME_LEN];
+	UBaseType_t uxIndex;
+	UBaseType_t i;
+	UBaseType_t uxPrevious;
+	UBaseType_t uxFree;
+	UBaseType_t uxDepth;
+	BaseType_t xWarn;
+
+	if ((TickType_t)(xTickCount - xLastScanTick) < configIDLE_STACK_SCAN_PERIOD) {
+		return;
+	}
+	xLastScanTick = xTickCount;
+
+	for (uxIndex = 0;; uxIndex++) {
+		htSchedulerSuspend();
+		pxItem = pxEnd->pxNext;
+		for (i = 0; i < uxIndex && pxItem != pxEnd; i++) {
+			pxItem = pxItem->pxNext;
+		}
+		if (pxItem == pxEnd) {
+			htSchedulerResume();
+			break;
+		}
+
+		pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+		uxPrevious = pxTCB->uxStackHighWaterMark;
+		uxFree = htGetTaskStackHighWaterMark(pxTCB);
+		uxDepth = pxTCB->uxStackDepth;
+		xWarn = (uxFree < uxPrevious && uxFree < configSTACK_LOW_WATERMARK) ? htTRUE : htFALSE;
+		if (xWarn == htTRUE) {
+			memcpy(cName, pxTCB->pcTaskName, sizeof(cName));
+		}
+		htSchedulerResume();
+
+		if (xWarn == htTRUE) {
+			printf("WARNING: task %.*s stack low, %lu of %lu words free\r\n", (int)sizeof(cName), cName,
+					(unsigned long)uxFree, (unsigned long)uxDepth);
+		}
+	}
+}
+#endif
+
+/**
+ * 释放已删除任务的栈和TCB，该任务此时不能在运行
+ */
+static void prvDeleteTCB(htTCB_t *pxTCB)
+{
+	if (pxTCB->pxStack != NULL) {
+		htPortReleaseStack(pxTCB->pxTopOfStack);
+	}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+	/* 释放任务栈和TCB内存，静态创建的任务由调用者管理存储区 */
+	if (pxTCB->ucStaticallyAllocated == htFALSE) {
+		htPortFree(pxTCB->pxStack);
+		htPortFree(pxTCB);
+	}
+#endif
+}
+
+/**
+ * 回收终止列表中的任务，由空闲任务调用
+ * 终止列表只在挂起调度器时访问，每次取出一个任务后恢复调度器再释放，
+ * 一次回收很多任务时更高优先级的任务也能及时运行
+ */
+static void prvCheckTasksWaitingTermination(void)
+{
+	htListItem_t *pxItem;
+
+	while (uxDeletedTasksWaitingCleanUp > 0) {
+		htSchedulerSuspend();
+		pxItem = htListGetHead(&xTasksWaitingTermination);
+		htListRemove(pxItem);
+		uxDeletedTasksWaitingCleanUp--;
+		htSchedulerResume();
+
+		prvDeleteTCB((htTCB_t *)htListGetItemOwner(pxItem));
+	}
+}
+
 /**
  * 空闲任务函数 - 当没有其他任务准备运行时，运行此任务
  */
@@ -221,6 +415,26 @@ static void htprvIdleTask(void *pvParameters)
 
 	/* 空闲任务永远运行 */
 	for (;;) {
+		/* 先回收自删除的任务，再考虑睡眠 */
+		prvCheckTasksWaitingTermination();
+
+#if configUSE_TICKLESS_IDLE == 1
+		/* 无滴答空闲：先粗查一次，挂起调度器后再精确计算，防止计算期间发生任务切换 */
+		if (htTaskGetExpectedIdleTime() >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP) {
+			TickType_t xExpectedIdleTime;
+
+			htSchedulerSuspend();
+			xExpectedIdleTime = htTaskGetExpectedIdleTime();
+			if (xExpectedIdleTime >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP) {
+				htPortSuppressTicksAndSleep(xExpectedIdleTime);
+			}
+			htSchedulerResume();
+		}
+#endif
+
+#if configIDLE_STACK_SCAN_PERIOD > 0
+		prvIdleStackScan();
+#endif
 
 		/* 执行低功耗管理，可选择进入睡眠模式 */
 #if configUSE_IDLE_HOOK
@@ -245,14 +459,23 @@ static void htprvIdleTask(void *pvParameters)
 BaseType_t htprvCreateIdleTask(void)
 {
 	BaseType_t xReturn = htFAIL;
-	static htTCB_t *pxIdleTaskTCB = NULL;
 
 	/* 检查空闲任务是否已经创建 */
 	if (pxIdleTaskTCB == NULL) {
 		/* 创建空闲任务，使用最低优先级 */
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
 		xReturn = htTaskCreate(htprvIdleTask, "IDLE", configMINIMAL_STACK_SIZE, NULL,
 				HT_IDLE_TASK, /* 使用优先级0(最低) */
 				(TaskHandle_t *)&pxIdleTaskTCB);
+#else
+		/* 没有堆时使用内核自带的静态存储区 */
+		static htTCB_t xIdleTaskTCB;
+		static StackType_t xIdleTaskStack[configMINIMAL_STACK_SIZE];
+
+		pxIdleTaskTCB = (htTCB_t *)htTaskCreateStatic(htprvIdleTask, "IDLE", configMINIMAL_STACK_SIZE, NULL,
+				HT_IDLE_TASK, xIdleTaskStack, &xIdleTaskTCB);
+		xReturn = htPASS;
+#endif
 	} else {
 		/* 空闲任务已经存在 */
 		xReturn = htPASS;
@@ -272,55 +495,167 @@ void htTaskDelay(TickType_t xTicksToDelay)
 		return;
 	}
 
-	// 禁用中断来确保操作原子性
-	__disable_irq();
+	// 进入临界区来确保操作原子性
+	htEnterCritical();
 
 	// 验证必要的数据结构
-	if (pxDelayedTaskList == NULL || pxCurrentTCB == NULL) {
-		printf("ERROR: Delay list or current task invalid!\r\n");
-		__enable_irq();
+	if (pxCurrentTCB == NULL) {
+		printf("ERROR: Current task invalid!\r\n");
+		htExitCritical();
 		return;
 	}
 
-	// 计算任务唤醒时间
-	TickType_t xTimeToWake = xTickCount + xTicksToDelay;
+	// 放入定时轮 - O(1)，回绕由定时轮内部的无符号差值处理
+	htTaskPlaceOnDelayedList(xTicksToDelay);
 
-	// 从就绪列表中移除当前任务
-	if (pxCurrentTCB->xStateListItem.pxContainer) {
-		htListRemove(&(pxCurrentTCB->xStateListItem));
-	}
+	// 退出临界区
+	htExitCritical();
+	htTaskYield();
+}
 
-	// 设置唤醒时间值并进行按值插入
-	htListSetItemValue(&(pxCurrentTCB->xStateListItem), xTimeToWake);
+/**
+ * 将当前任务移出就绪列表并按超时放入定时轮
+ * 永久等待的任务不进入定时轮，只能由事件唤醒
+ */
+void htTaskPlaceOnDelayedList(TickType_t xTicksToWait)
+{
+	htTaskRemoveFromReadyList(pxCurrentTCB);
 
-	if (xTimeToWake > xTickCount) {
-		pxCurrentTCB->xStateListItem.pxContainer = pxDelayedTaskList;
-		htListInsert(pxDelayedTaskList, &(pxCurrentTCB->xStateListItem));
-	} else {
-		pxCurrentTCB->xStateListItem.pxContainer = pxOverflowDelayedTaskList;
-		htListInsert(pxOverflowDelayedTaskList, &(pxCurrentTCB->xStateListItem));
+	if (xTicksToWait != htBLOCKED_INDEFINITELY) {
+		htTimeWheelInsert(&xDelayedTaskWheel, &(pxCurrentTCB->xStateListItem), xTickCount + xTicksToWait);
 	}
 
-	// 更新任务状态
 	pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
+}
 
-	// 启用中断
-	__enable_irq();
-	htTaskYield();
+/**
+ * 延时到绝对时刻
+ * 用距上次唤醒经过的tick数与周期比较，tick回绕时仍然正确
+ */
+BaseType_t htTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement)
+{
+	TickType_t xTimeToWake;
+	BaseType_t xShouldDelay;
+
+	if (pxPreviousWakeTime == NULL || xTimeIncrement == 0) {
+		return htFAIL;
+	}
+
+	htEnterCritical();
+	xTimeToWake = *pxPreviousWakeTime + xTimeIncrement;
+	xShouldDelay = ((TickType_t)(xTickCount - *pxPreviousWakeTime) < xTimeIncrement) ? htTRUE : htFALSE;
+	*pxPreviousWakeTime = xTimeToWake;
+	if (xShouldDelay == htTRUE) {
+		htTaskPlaceOnDelayedList(xTimeToWake - xTickCount);
+	}
+	htExitCritical();
+
+	if (xShouldDelay == htTRUE) {
+		htTaskYield();
+		return htPASS;
+	}
+
+	return htFAIL;
+}
+
+#if configUSE_PERIODIC_TASKS == 1
+/**
+ * 把当前任务设为周期任务
+ */
+BaseType_t htTaskSetPeriodic(TickType_t xPeriod, TickType_t xRelativeDeadline)
+{
+	if (xPeriod == 0) {
+		return htFAIL;
+	}
+
+	htEnterCritical();
+	pxCurrentTCB->xPeriod = xPeriod;
+	pxCurrentTCB->xRelativeDeadline = (xRelativeDeadline == 0) ? xPeriod : xRelativeDeadline;
+	pxCurrentTCB->xReleaseTime = xTickCount;
+	memset(&(pxCurrentTCB->xPeriodicStats), 0, sizeof(htPeriodicStats_t));
+	pxCurrentTCB->xPeriodicStats.ulReleases = 1;
+	htExitCritical();
+
+	return htPASS;
+}
+
+/**
+ * 结束本周期，阻塞到下一个释放时刻，醒来后记录释放抖动
+ */
+BaseType_t htTaskWaitForNextPeriod(void)
+{
+	htTCB_t *pxTCB = pxCurrentTCB;
+	htPeriodicStats_t *pxStats = &(pxTCB->xPeriodicStats);
+	TickType_t xResponse;
+	TickType_t xJitter;
+	BaseType_t xReturn = htPASS;
+
+	if (pxTCB->xPeriod == 0) {
+		return htFAIL;
+	}
+
+	htEnterCritical();
+	xResponse = xTickCount - pxTCB->xReleaseTime;
+	if (xResponse > pxStats->xWorstResponseTime) {
+		pxStats->xWorstResponseTime = xResponse;
+	}
+	if (xResponse > pxTCB->xRelativeDeadline) {
+		pxStats->ulDeadlineMisses++;
+		xReturn = htFAIL;
+	}
+
+	/* 下一个释放时刻已过时跳过这些周期，每个计一次错过 */
+	pxTCB->xReleaseTime += pxTCB->xPeriod;
+	while ((TickType_t)(xTickCount - pxTCB->xReleaseTime - 1U) < 0x7FFFFFFFUL) {
+		pxTCB->xReleaseTime += pxTCB->xPeriod;
+		pxStats->ulDeadlineMisses++;
+	}
+	pxStats->ulReleases++;
+
+	/* 恰好在释放时刻完成时不阻塞，直接开始下一个周期 */
+	if (pxTCB->xReleaseTime != xTickCount) {
+		htTaskPlaceOnDelayedList(pxTCB->xReleaseTime - xTickCount);
+		htExitCritical();
+		htTaskYield();
+		htEnterCritical();
+	}
+
+	xJitter = xTickCount - pxTCB->xReleaseTime;
+	if (xJitter > pxStats->xMaxReleaseJitter) {
+		pxStats->xMaxReleaseJitter = xJitter;
+	}
+	htExitCritical();
+
+	return xReturn;
+}
+
+/**
+ * 读取周期任务的时序统计
+ */
+BaseType_t htTaskGetPeriodicStats(TaskHandle_t xTask, htPeriodicStats_t *pxStats)
+{
+	htTCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (htTCB_t *)xTask;
+
+	if (pxStats == NULL || pxTCB->xPeriod == 0) {
+		return htFAIL;
+	}
+
+	htEnterCritical();
+	*pxStats = pxTCB->xPeriodicStats;
+	htExitCritical();
+
+	return htPASS;
 }
+#endif
 
 /**
  * 任务调度函数
- * 让出CPU控制权，切换到其他任务
+ * 让出CPU控制权，同优先级有其他就绪任务时轮到下一个
  */
 void htTaskYield(void)
 {
 	/* 触发PendSV中断，进行上下文切换 */
-	*((volatile uint32_t *)0xE000ED04) = 0x10000000; /* 设置PENDSVSET位 */
-
-	//    /* 内存屏障，确保之前的写操作完成 */
-	//    __asm volatile ("dsb" ::: "memory");
-	//    __asm volatile ("isb");
+	htSchedulerRotate();
 }
 
 htList_t htTaskGetAllTaskInfo(void)
@@ -328,112 +663,358 @@ htList_t htTaskGetAllTaskInfo(void)
 	return pxAllocatedTasksList;
 }
 
+#if configUSE_TIME_SLICING == 1
 /**
- * Check and update delayed task list - fixed implementation for accurate timing
+ * 设置任务的时间片长度
+ * @param xTask 任务，NULL表示当前任务
+ * @param uxTicks 时间片长度(tick)，0表示configTIME_SLICE_TICKS
  */
-void htTaskCheckDelayedTasks(void)
+void htTaskSetTimeSlice(TaskHandle_t xTask, UBaseType_t uxTicks)
 {
-	// 确保列表有效
-	if (pxDelayedTaskList == NULL && pxOverflowDelayedTaskList == NULL) {
+	htTCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (htTCB_t *)xTask;
+
+	htEnterCritical();
+	pxTCB->uxTimeSlice = (uxTicks == 0) ? configTIME_SLICE_TICKS : uxTicks;
+	htExitCritical();
+}
+
+/**
+ * 获取任务的时间片长度(tick)
+ * @param xTask 任务，NULL表示当前任务
+ */
+UBaseType_t htTaskGetTimeSlice(TaskHandle_t xTask)
+{
+	htTCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (htTCB_t *)xTask;
+
+	return pxTCB->uxTimeSlice;
+}
+
+/**
+ * 时间片计时：同优先级还有其他就绪任务时，当前任务每个tick消耗一格，用完后轮到下一个
+ * 在滴答中断中调用，调用者负责临界区保护
+ */
+static void prvTimeSliceTick(void)
+{
+	htList_t *pxList = &(pxReadyTasksLists[pxCurrentTCB->uxPriority]);
+
+	if (htListGetItemContainer(&(pxCurrentTCB->xStateListItem)) != pxList ||
+			htListGetCurrentNumberOfItems(pxList) < 2) {
 		return;
 	}
 
-	// 获取当前滴答计数
-	TickType_t xCurrentTickCount = xTickCount;
-
-	// 如果列表为空，直接返回
-	if (pxDelayedTaskList->uxNumberOfItems == 0 && pxOverflowDelayedTaskList->uxNumberOfItems == 0) {
+	if (pxCurrentTCB->uxTimeSliceLeft > 1) {
+		pxCurrentTCB->uxTimeSliceLeft--;
 		return;
 	}
-	// 处理延时到期的任务 - 采用循环检查所有到期任务
-	htListItem_t *pxItem;
-	htTCB_t *pxTCB;
-	TickType_t xItemValue;
-	BaseType_t xListItemRemoved = htFALSE; // 标记是否从列表中移除了项目
 
-	// 检查所有已到期的任务
-	do {
-		xListItemRemoved = htFALSE;
+	htSchedulerRotate();
+}
+#endif
 
-		// 获取延时列表中的第一个项目
-		pxItem = htListGetHead(pxDelayedTaskList);
-		if (pxItem == NULL) {
-			// 列表为空，退出循环
-			break;
-		}
+/**
+ * 获取当前任务句柄
+ */
+TaskHandle_t htTaskGetCurrentTaskHandle(void)
+{
+	return (TaskHandle_t)pxCurrentTCB;
+}
 
-		// 获取此任务的唤醒时间
-		xItemValue = htListGetItemValue(pxItem);
-
-		// 如果到达或超过唤醒时间
-		if (xItemValue <= xCurrentTickCount) {
-			// 获取任务控制块
-			pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
-			if (pxTCB != NULL) {
-				// 从延时列表移除任务
-				htListRemove(pxItem);
-				xListItemRemoved = htTRUE;
-
-				// 将任务添加回就绪列表
-				if (pxTCB->uxPriority < configMAX_PRIORITIES) {
-					// 更新任务状态
-					pxTCB->uxTaskState = HT_TASK_READY;
-
-					// 设置就绪列表为容器并添加到列表
-					pxItem->pxContainer = &(pxReadyTasksLists[pxTCB->uxPriority]);
-					htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), pxItem);
-				}
-			} else {
-				// 无效任务，移除并继续
-				htListRemove(pxItem);
-				xListItemRemoved = htTRUE;
-			}
-		}
+/**
+ * 修改任务的当前优先级：就绪/运行中的任务在就绪列表中换位，等待中的任务在等待列表中换位
+ * 调用者负责临界区保护
+ */
+static void prvSetEffectivePriority(htTCB_t *pxTCB, UBaseType_t uxPriority)
+{
+	if (pxTCB->uxTaskState == HT_TASK_READY || pxTCB->uxTaskState == HT_TASK_RUNNING) {
+		htTaskRemoveFromReadyList(pxTCB);
+		pxTCB->uxPriority = uxPriority;
+		htTaskAddToReadyList(pxTCB);
+	} else {
+		pxTCB->uxPriority = uxPriority;
+		htWaitQueueReposition(pxTCB);
+	}
+}
 
-		// 如果从列表中移除了项目，重新检查，因为可能有多个项目到期
-	} while (xListItemRemoved == htTRUE);
-	xListItemRemoved = htFALSE; // 标记是否从列表中移除了项目
+/**
+ * 阻塞在互斥量上的任务所等待的持有者，没有时返回NULL
+ */
+static htTCB_t *prvGetBlockingOwner(const htTCB_t *pxTCB)
+{
+	return (pxTCB->pxWaitQueue != NULL) ? pxTCB->pxWaitQueue->pxOwner : NULL;
+}
 
-	do {
-		xListItemRemoved = htFALSE;
+/**
+ * 优先级继承
+ * 持有链上每个任务都提升到uxPriority，遇到优先级已不低于它的任务时停止：
+ * 该任务之后的链在它被提升时已经处理过
+ */
+void htTaskPriorityInherit(htTCB_t *pxOwner, UBaseType_t uxPriority)
+{
+	while (pxOwner != NULL && pxOwner->uxPriority < uxPriority) {
+		prvSetEffectivePriority(pxOwner, uxPriority);
+		pxOwner = prvGetBlockingOwner(pxOwner);
+	}
+}
 
-		// 获取延时列表中的第一个项目
-		pxItem = htListGetHead(pxOverflowDelayedTaskList);
-		if (pxItem == NULL) {
-			// 列表为空，退出循环
+/**
+ * 重新计算优先级
+ * 优先级不变时停止；死锁成环时最多沿链走任务数那么多步
+ */
+void htTaskPriorityUpdate(htTCB_t *pxTCB)
+{
+	htWaitQueue_t *pxHeld;
+	UBaseType_t uxPriority;
+	UBaseType_t uxWaiter;
+	UBaseType_t uxSteps = 0;
+
+	while (pxTCB != NULL && uxSteps++ < uxCurrentNumberOfTasks) {
+		uxPriority = pxTCB->uxBasePriority;
+		for (pxHeld = pxTCB->pxMutexesHeld; pxHeld != NULL; pxHeld = pxHeld->pxNextHeld) {
+			uxWaiter = htWaitQueueGetTopPriority(pxHeld);
+			if (uxWaiter > uxPriority) {
+				uxPriority = uxWaiter;
+			}
+		}
+
+		if (uxPriority == pxTCB->uxPriority) {
 			break;
 		}
 
-		// 获取此任务的唤醒时间
-		xItemValue = htListGetItemValue(pxItem);
-
-		// 如果到达或超过唤醒时间
-		if (xItemValue <= xCurrentTickCount) {
-			// 获取任务控制块
-			pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
-			if (pxTCB != NULL) {
-				// 从延时列表移除任务
-				htListRemove(pxItem);
-				xListItemRemoved = htTRUE;
-
-				// 将任务添加回就绪列表
-				if (pxTCB->uxPriority < configMAX_PRIORITIES) {
-					// 更新任务状态
-					pxTCB->uxTaskState = HT_TASK_READY;
-
-					// 设置就绪列表为容器并添加到列表
-					pxItem->pxContainer = &(pxReadyTasksLists[pxTCB->uxPriority]);
-					htListInsertEnd(&(pxReadyTasksLists[pxTCB->uxPriority]), pxItem);
-				}
-			} else {
-				// 无效任务，移除并继续
-				htListRemove(pxItem);
-				xListItemRemoved = htTRUE;
-			}
+		prvSetEffectivePriority(pxTCB, uxPriority);
+		pxTCB = prvGetBlockingOwner(pxTCB);
+	}
+}
+
+/**
+ * 延时到期回调 - 将任务移回就绪列表
+ * 在等待队列上阻塞的任务同时从等待队列移除，唤醒原因为超时
+ */
+static void prvDelayedTaskExpired(htListItem_t *pxItem)
+{
+	htTCB_t *pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+
+	if (pxTCB != NULL && pxTCB->uxPriority < configMAX_PRIORITIES) {
+		htWaitQueueRemove(pxTCB);
+		pxTCB->xWaitResult = htWAIT_TIMEOUT;
+		pxTCB->uxTaskState = HT_TASK_READY;
+		htTaskAddToReadyList(pxTCB);
+	}
+}
+
+/**
+ * 检查延时任务 - 定时轮追到xTickCount，每tick只处理到期槽
+ * 无滴答睡眠后一次补偿多个tick时，中间无事件的tick被直接跳过
+ */
+void htTaskCheckDelayedTasks(void)
+{
+	(void)htTimeWheelAdvance(&xDelayedTaskWheel, xTickCount - xDelayedTaskWheel.xTime, prvDelayedTaskExpired);
+}
+
+/**
+ * 计算空闲任务可以睡眠的tick数
+ * 有高于空闲优先级的任务就绪，或空闲优先级上还有其他任务需要时间片时返回0。
+ * 结果不晚于最早的延时到期时间（可能因定时轮下放而略早，醒来后会再次进入睡眠）。
+ * @return 可睡眠的tick数，没有任何延时任务时返回htBLOCKED_INDEFINITELY
+ */
+TickType_t htTaskGetExpectedIdleTime(void)
+{
+	if (htTaskConfirmSleepModeStatus() == htFALSE) {
+		return 0;
+	}
+
+	/* 调度器挂起期间的滴答只计数，定时轮可能落后于xTickCount */
+	const TickType_t xLag = xTickCount - xDelayedTaskWheel.xTime;
+	const TickType_t xNext = htTimeWheelNextEvent(&xDelayedTaskWheel);
+
+	return (xNext > xLag) ? (xNext - xLag) : 0;
+}
+
+/**
+ * 确认仍可睡眠 - 移植层关中断后、真正睡眠前调用
+ * 在计算睡眠时间之后有中断使任务就绪，则必须放弃本次睡眠
+ * @return htTRUE表示可以睡眠
+ */
+BaseType_t htTaskConfirmSleepModeStatus(void)
+{
+	if (htTaskGetTopReadyPriority() > HT_IDLE_TASK) {
+		return htFALSE;
+	}
+
+	if (htListGetCurrentNumberOfItems(&(pxReadyTasksLists[HT_IDLE_TASK])) > 1) {
+		return htFALSE;
+	}
+
+	/* 挂起调度器期间中断唤醒的任务还在待就绪列表中 */
+	if (htListGetCurrentNumberOfItems(&xPendingReadyList) > 0) {
+		return htFALSE;
+	}
+
+	return htTRUE;
+}
+
+#if configCHECK_FOR_STACK_OVERFLOW > 0
+/**
+ * 栈溢出处理：调用应用钩子，未启用钩子时打印任务名后停机
+ * @param pxTCB 溢出的任务
+ */
+static void prvStackOverflow(htTCB_t *pxTCB)
+{
+#if configUSE_STACK_OVERFLOW_HOOK == 1
+	vApplicationStackOverflowHook((TaskHandle_t)pxTCB, pxTCB->pcTaskName);
+#else
+	printf("[STACK] task %s overflowed its stack\r\n", pxTCB->pcTaskName);
+	for (;;) {
+	}
+#endif
+}
+
+/**
+ * 检查切出任务的栈是否溢出
+ * 级别1比较保存的栈指针与TCB中的栈区；级别2还检查栈底configSTACK_CANARY_WORDS个字是否仍是填充图案，
+ * 栈指针已经退回栈区内、但之前越过栈底写坏相邻内存的情况也能发现
+ */
+void htTaskCheckForStackOverflow(void)
+{
+	htTCB_t *pxTCB = pxCurrentTCB;
+#if configCHECK_FOR_STACK_OVERFLOW > 1
+	UBaseType_t i;
+#endif
+
+	if (pxTCB == NULL || pxTCB->pxStack == NULL) {
+		return;
+	}
+
+	if (pxTCB->pxTopOfStack < pxTCB->pxStack || pxTCB->pxTopOfStack >= pxTCB->pxStack + pxTCB->uxStackDepth) {
+		prvStackOverflow(pxTCB);
+		return;
+	}
+
+#if configCHECK_FOR_STACK_OVERFLOW > 1
+	for (i = 0; i < configSTACK_CANARY_WORDS; i++) {
+		if (pxTCB->pxStack[i] != (StackType_t)configSTACK_FILL_PATTERN) {
+			prvStackOverflow(pxTCB);
+			return;
 		}
+	}
+#endif
+}
+#endif
+
+#if configGENERATE_RUN_TIME_STATS == 1
+/**
+ * 把上次记账以来的计数器增量计入当前任务
+ * 计数器为32位，只要两次记账间隔小于一个回绕周期，无符号差值就是正确的增量
+ */
+void htTaskAccountRunTime(void)
+{
+	const uint32_t ulNow = htPortGetRunTimeCounter();
+	const uint32_t ulElapsed = ulNow - ulLastRunTimeCount;
+
+	ulLastRunTimeCount = ulNow;
+	ullTotalRunTime += ulElapsed;
+	if (pxCurrentTCB != NULL) {
+		pxCurrentTCB->ullRunTimeCounter += ulElapsed;
+	}
+}
+
+/**
+ * 滴答中记账，并在每个秒边界记录一次窗口采样
+ * 无滴答睡眠一次跨过多秒时只记一个采样，窗口相应变长
+ */
+static void prvRunTimeTick(void)
+{
+	htRunTimeSample_t *pxSample;
+
+	htTaskAccountRunTime();
+
+	if ((TickType_t)(xTickCount - xLastRunTimeSampleTick) < configTICK_RATE_HZ) {
+		return;
+	}
+	xLastRunTimeSampleTick = xTickCount;
+
+	pxSample = &xRunTimeSamples[uxRunTimeSampleIndex];
+	pxSample->ullTotal = ullTotalRunTime;
+	pxSample->ullIdle = (pxIdleTaskTCB != NULL) ? pxIdleTaskTCB->ullRunTimeCounter : 0;
+
+	uxRunTimeSampleIndex++;
+	if (uxRunTimeSampleIndex > configRUN_TIME_STATS_WINDOW) {
+		uxRunTimeSampleIndex = 0;
+	}
+}
+
+/**
+ * 获取任务累计运行时间（包含当前任务尚未记账的部分）
+ */
+uint64_t htTaskGetRunTimeCounter(TaskHandle_t xTask)
+{
+	htTCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (htTCB_t *)xTask;
+	uint64_t ullRunTime;
+
+	if (pxTCB == NULL) {
+		return 0;
+	}
+
+	htEnterCritical();
+	htTaskAccountRunTime();
+	ullRunTime = pxTCB->ullRunTimeCounter;
+	htExitCritical();
+
+	return ullRunTime;
+}
+
+/**
+ * 获取所有任务累计运行时间之和
+ */
+uint64_t htTaskGetTotalRunTime(void)
+{
+	uint64_t ullRunTime;
+
+	htEnterCritical();
+	htTaskAccountRunTime();
+	ullRunTime = ullTotalRunTime;
+	htExitCritical();
+
+	return ullRunTime;
+}
+
+/**
+ * 获取最近一个统计窗口内的总运行时间和空闲任务运行时间
+ * @param pullTotal 返回窗口内的总运行时间
+ * @param pullIdle 返回窗口内空闲任务的运行时间
+ */
+void htTaskGetRunTimeWindow(uint64_t *pullTotal, uint64_t *pullIdle)
+{
+	const htRunTimeSample_t *pxOldest;
+	uint64_t ullIdle;
+
+	htEnterCritical();
+	htTaskAccountRunTime();
+	pxOldest = &xRunTimeSamples[uxRunTimeSampleIndex];
+	ullIdle = (pxIdleTaskTCB != NULL) ? pxIdleTaskTCB->ullRunTimeCounter : 0;
+	*pullTotal = ullTotalRunTime - pxOldest->ullTotal;
+	*pullIdle = ullIdle - pxOldest->ullIdle;
+	htExitCritical();
+}
+#endif
 
-		// 如果从列表中移除了项目，重新检查，因为可能有多个项目到期
-	} while (xListItemRemoved == htTRUE);
+/**
+ * 无滴答睡眠醒来后补偿tick计数
+ * 由移植层调用，期间到期的延时任务被移回就绪列表
+ * @param xTicksToJump 睡眠期间流逝的整tick数
+ */
+void htTaskStepTick(TickType_t xTicksToJump)
+{
+	htEnterCritical();
+	xTickCount += xTicksToJump;
+	/* 与滴答中断一样，调度器挂起时(空闲任务的无滴答睡眠)只累加计数：睡眠中被中断唤醒的任务还在
+	 * 待就绪列表里，超时项仍在定时轮中，由htSchedulerResume()先移入待就绪任务再追上定时轮 */
+	if (htSchedulerIsSuspended() == htFALSE) {
+		htTaskCheckDelayedTasks();
+	}
+#if configGENERATE_RUN_TIME_STATS == 1
+	prvRunTimeTick();
+#endif
+	htExitCritical();
 }
 
 /**
@@ -441,32 +1022,54 @@ void htTaskCheckDelayedTasks(void)
  */
 void htTaskTickInc(void)
 {
-	// 确保原子操作
-	__disable_irq();
+	// 确保原子操作，滴答中断可能嵌套在其他中断中，退出时恢复原屏蔽状态
+	UBaseType_t uxSavedMask = htEnterCriticalFromISR();
 
 	// 递增系统滴答计数
 	xTickCount++;
 
-	// 检查延时任务
-	htTaskCheckDelayedTasks();
+#if configUSE_TICK_HOOK == 1
+	// 应用滴答钩子，在到期处理之前调用
+	vApplicationTickHook();
+#endif
+
+	// 检查延时任务，调度器挂起时推迟到htSchedulerResume()，由定时轮一次追上
+	if (htSchedulerIsSuspended() == htFALSE) {
+		htTaskCheckDelayedTasks();
+	}
+
+#if configGENERATE_RUN_TIME_STATS == 1
+	// 运行时间记账，保证32位计数器在回绕前被读到
+	prvRunTimeTick();
+#endif
 
 	// 如果当前任务有效，检查是否需要调度
-	if (pxCurrentTCB != NULL) {
+	if (pxCurrentTCB != NULL && htSchedulerIsSuspended() == htFALSE) {
 		if (htSchedulerNeedsSwitch()) {
 			// 触发PendSV中断进行任务切换
-			SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+			htPortYield();
+		}
+#if configUSE_PREEMPTION == 1 && configUSE_TIME_SLICING == 1
+		else {
+			// 同优先级轮转
+			prvTimeSliceTick();
 		}
+#endif
 	}
-	// 重新启用中断
-	__enable_irq();
+	// 恢复中断屏蔽状态
+	htExitCriticalFromISR(uxSavedMask);
 }
 
 /**
  * 删除任务
+ * 删除其他任务时立即释放其栈和TCB；任务删除自身时仍运行在自己的栈上，
+ * 先放入终止列表，切换出去之后由空闲任务回收
  */
 void htTaskDelete(TaskHandle_t xTaskToDelete)
 {
 	htTCB_t *pxTCB;
+	htTCB_t *pxOwner;
+	BaseType_t xDeleteSelf;
 
 	/* 如果参数为NULL，则删除当前任务 */
 	if (xTaskToDelete == NULL) {
@@ -474,34 +1077,250 @@ void htTaskDelete(TaskHandle_t xTaskToDelete)
 	} else {
 		pxTCB = (htTCB_t *)xTaskToDelete;
 	}
+	xDeleteSelf = (pxTCB == pxCurrentTCB) ? htTRUE : htFALSE;
+
+	htSchedulerSuspend();
 
-	/* 先禁用中断 */
+	/* 从中断也会访问的列表中移除任务 */
 	htEnterCritical();
+	htTaskRemoveFromReadyList(pxTCB);
+	/* 正在等待互斥量时，持有者不再继承它的优先级 */
+	pxOwner = prvGetBlockingOwner(pxTCB);
+	htWaitQueueRemove(pxTCB);
+	htTaskPriorityUpdate(pxOwner);
+	if (htListGetItemContainer(&(pxTCB->xEventListItem)) != NULL) {
+		/* 还在待就绪列表中 */
+		htListRemove(&(pxTCB->xEventListItem));
+	}
+#if configUSE_MUTEXES == 1
+	/* 仍持有的轻量互斥量交给等待者 */
+	htMutexReleaseAll(pxTCB);
+#endif
+	/* 仍持有的互斥量和递归互斥量恢复为可用，不再指向被删除的任务 */
+	htSemaphoreReleaseAll(pxTCB);
+	htExitCritical();
 
-	/* 从任何列表中移除任务 */
-	htListRemove(&(pxTCB->xStateListItem));
-	htListRemove(&(pxTCB->xEventListItem));
-	/* 从所有任务列表中移除 */
-	htListRemove(&(pxTCB->xStateListItem));
-	htListRemove(&(pxTCB->xEventListItem));
+	/* 所有任务列表只在挂起调度器时访问，栈扫描等遍历不会再访问已删除的任务 */
+	htListRemove(&(pxTCB->xAllListItem));
 
 	/* 递减任务计数器 */
 	uxCurrentNumberOfTasks--;
 
-	/* 恢复中断 */
+	if (xDeleteSelf == htTRUE) {
+		pxTCB->uxTaskState = HT_TASK_DELETED;
+		htListInsertEnd(&xTasksWaitingTermination, &(pxTCB->xStateListItem));
+		uxDeletedTasksWaitingCleanUp++;
+	}
+
+	htSchedulerResume();
+
+	if (xDeleteSelf == htTRUE) {
+		/* 切换出去后不会再回到这里 */
+		htTaskYield();
+	} else {
+		prvDeleteTCB(pxTCB);
+	}
+}
+
+#if configUSE_TASK_NOTIFICATIONS == 1
+
+/* 通知槽状态 */
+#define htNOTIFY_NOT_WAITING 0 /* 没有等待，也没有未取走的通知 */
+#define htNOTIFY_WAITING 1 /* 任务正在等待该槽的通知 */
+#define htNOTIFY_RECEIVED 2 /* 有未取走的通知 */
+
+/**
+ * 更新通知值，目标任务正在等待该槽时将其唤醒
+ * 被唤醒任务的优先级高于当前任务时置位*pxHigherPriorityTaskWoken
+ * 调用者负责临界区保护
+ * @return htFAIL表示HT_NOTIFY_NO_OVERWRITE遇到未取走的通知
+ */
+static BaseType_t prvTaskNotify(htTCB_t *pxTCB, UBaseType_t uxIndex, uint32_t ulValue, htNotifyAction_t eAction,
+		BaseType_t *pxHigherPriorityTaskWoken)
+{
+	const uint8_t ucOriginalState = pxTCB->ucNotifyState[uxIndex];
+
+	switch (eAction) {
+		case HT_NOTIFY_SET_BITS:
+			pxTCB->ulNotifiedValue[uxIndex] |= ulValue;
+			break;
+		case HT_NOTIFY_INCREMENT:
+			pxTCB->ulNotifiedValue[uxIndex]++;
+			break;
+		case HT_NOTIFY_OVERWRITE:
+			pxTCB->ulNotifiedValue[uxIndex] = ulValue;
+			break;
+		case HT_NOTIFY_NO_OVERWRITE:
+			if (ucOriginalState == htNOTIFY_RECEIVED) {
+				return htFAIL;
+			}
+			pxTCB->ulNotifiedValue[uxIndex] = ulValue;
+			break;
+		case HT_NOTIFY_NO_ACTION:
+		default:
+			break;
+	}
+
+	pxTCB->ucNotifyState[uxIndex] = htNOTIFY_RECEIVED;
+
+	/* 目标任务在等待这个槽：撤销超时并移回就绪列表 */
+	if (ucOriginalState == htNOTIFY_WAITING && pxTCB->uxTaskState == HT_TASK_BLOCKED) {
+		pxTCB->xWaitResult = htWAIT_SIGNALLED;
+		htTaskUnblock(pxTCB);
+
+		if (pxCurrentTCB != NULL && pxTCB->uxPriority > pxCurrentTCB->uxPriority) {
+			*pxHigherPriorityTaskWoken = htTRUE;
+		}
+	}
+
+	return htPASS;
+}
+
+/**
+ * 当前任务阻塞等待某个通知槽，直到收到通知或超时
+ * 必须在(仅一层)临界区内调用，返回时仍在临界区内
+ */
+static void prvTaskNotifyBlock(UBaseType_t uxIndex, TickType_t xTicksToWait)
+{
+	pxCurrentTCB->ucNotifyState[uxIndex] = htNOTIFY_WAITING;
+	htTaskPlaceOnDelayedList(xTicksToWait);
+
+	htTaskYield();
 	htExitCritical();
 
-	/* 如果删除的是当前任务，需要调度另一个任务 */
-	if (pxTCB == pxCurrentTCB) {
-		/* 强制任务切换 */
+	/* 收到通知或超时后从这里继续，结果由通知槽状态区分 */
+	htEnterCritical();
+}
+
+/**
+ * 向任务发送通知
+ * @param xTaskToNotify 目标任务
+ * @param uxIndexToNotify 通知槽
+ * @param ulValue 通知值，含义由eAction决定
+ * @param eAction 通知动作
+ * @return htPASS，HT_NOTIFY_NO_OVERWRITE遇到未取走的通知或参数无效时返回htFAIL
+ */
+BaseType_t htTaskNotifyIndexed(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+		htNotifyAction_t eAction)
+{
+	BaseType_t xReturn;
+	BaseType_t xYieldRequired = htFALSE;
+
+	if (xTaskToNotify == NULL || uxIndexToNotify >= configTASK_NOTIFICATION_ARRAY_ENTRIES) {
+		return htFAIL;
+	}
+
+	htEnterCritical();
+	xReturn = prvTaskNotify((htTCB_t *)xTaskToNotify, uxIndexToNotify, ulValue, eAction, &xYieldRequired);
+	if (xYieldRequired == htTRUE) {
 		htTaskYield();
 	}
+	htExitCritical();
 
-	/* 释放任务栈和TCB内存 */
-	if (pxTCB->pxStack != NULL) {
-		htPortFree(pxTCB->pxStack);
+	return xReturn;
+}
+
+/**
+ * 从ISR中向任务发送通知 - 不经过队列对象，也不复制数据
+ * @param pxHigherPriorityTaskWoken 唤醒了更高优先级任务时置为htTRUE，可为NULL
+ */
+BaseType_t htTaskNotifyIndexedFromISR(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+		htNotifyAction_t eAction, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	BaseType_t xWoken = htFALSE;
+	BaseType_t xReturn;
+	UBaseType_t uxSavedMask;
+
+	if (pxHigherPriorityTaskWoken != NULL) {
+		*pxHigherPriorityTaskWoken = htFALSE;
 	}
-	htPortFree(pxTCB);
+
+	if (xTaskToNotify == NULL || uxIndexToNotify >= configTASK_NOTIFICATION_ARRAY_ENTRIES) {
+		return htFAIL;
+	}
+
+	uxSavedMask = htEnterCriticalFromISR();
+	xReturn = prvTaskNotify((htTCB_t *)xTaskToNotify, uxIndexToNotify, ulValue, eAction, &xWoken);
+	htExitCriticalFromISR(uxSavedMask);
+	if (pxHigherPriorityTaskWoken != NULL) {
+		*pxHigherPriorityTaskWoken = xWoken;
+	}
+
+	return xReturn;
+}
+
+/**
+ * 等待通知
+ * @param uxIndexToWaitOn 通知槽
+ * @param ulBitsToClearOnEntry 没有未取走的通知时，进入等待前清除的位
+ * @param ulBitsToClearOnExit 收到通知后返回前清除的位
+ * @param pulNotificationValue 返回清除前的通知值，可为NULL
+ * @param xTicksToWait 最长等待tick数
+ * @return htPASS表示收到通知，htFAIL表示超时
+ */
+BaseType_t htTaskNotifyWaitIndexed(UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry,
+		uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait)
+{
+	BaseType_t xReturn = htFAIL;
+
+	if (pxCurrentTCB == NULL || uxIndexToWaitOn >= configTASK_NOTIFICATION_ARRAY_ENTRIES) {
+		return htFAIL;
+	}
+
+	htEnterCritical();
+
+	if (pxCurrentTCB->ucNotifyState[uxIndexToWaitOn] != htNOTIFY_RECEIVED) {
+		pxCurrentTCB->ulNotifiedValue[uxIndexToWaitOn] &= ~ulBitsToClearOnEntry;
+		if (xTicksToWait > 0) {
+			prvTaskNotifyBlock(uxIndexToWaitOn, xTicksToWait);
+		}
+	}
+
+	if (pulNotificationValue != NULL) {
+		*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[uxIndexToWaitOn];
+	}
+
+	if (pxCurrentTCB->ucNotifyState[uxIndexToWaitOn] == htNOTIFY_RECEIVED) {
+		pxCurrentTCB->ulNotifiedValue[uxIndexToWaitOn] &= ~ulBitsToClearOnExit;
+		xReturn = htPASS;
+	}
+	pxCurrentTCB->ucNotifyState[uxIndexToWaitOn] = htNOTIFY_NOT_WAITING;
+
+	htExitCritical();
+
+	return xReturn;
+}
+
+/**
+ * 把通知值当作计数信号量获取
+ * @param uxIndexToWaitOn 通知槽
+ * @param xClearCountOnExit htTRUE时返回前清零(二值信号量语义)，否则减1(计数信号量语义)
+ * @param xTicksToWait 通知值为0时最长等待tick数
+ * @return 减1或清零前的通知值，超时返回0
+ */
+uint32_t htTaskNotifyTakeIndexed(UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+	uint32_t ulReturn;
+
+	if (pxCurrentTCB == NULL || uxIndexToWaitOn >= configTASK_NOTIFICATION_ARRAY_ENTRIES) {
+		return 0;
+	}
+
+	htEnterCritical();
+
+	if (pxCurrentTCB->ulNotifiedValue[uxIndexToWaitOn] == 0 && xTicksToWait > 0) {
+		prvTaskNotifyBlock(uxIndexToWaitOn, xTicksToWait);
+	}
+
+	ulReturn = pxCurrentTCB->ulNotifiedValue[uxIndexToWaitOn];
+	if (ulReturn != 0) {
+		pxCurrentTCB->ulNotifiedValue[uxIndexToWaitOn] = (xClearCountOnExit != htFALSE) ? 0 : ulReturn - 1;
+	}
+	pxCurrentTCB->ucNotifyState[uxIndexToWaitOn] = htNOTIFY_NOT_WAITING;
+
+	htExitCritical();
+
+	return ulReturn;
 }
 
-/* */
+#endif /* configUSE_TASK_NOTIFICATIONS */
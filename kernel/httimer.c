@@ -0,0 +1,464 @@
+#include "httimer.h"
+#include "httask.h"
+#include "htqueue.h"
+#include "htmem.h"
+#include "httimewheel.h"
+
+#if configUSE_TIMERS == 1
+
+/* 定时器状态标志 */
+#define htTIMER_AUTO_RELOAD  0x01U /* 自动重载 */
+#define htTIMER_ACTIVE       0x02U /* 已启动 */
+#define htTIMER_STATIC       0x04U /* 存储区由调用者提供，删除时不释放 */
+
+/* 守护任务命令 */
+#define htTIMER_CMD_START          0 /* 启动/复位，xValue为发出命令时的tick */
+#define htTIMER_CMD_STOP           1 /* 停止 */
+#define htTIMER_CMD_CHANGE_PERIOD  2 /* 修改周期并重新启动，xValue为新周期 */
+#define htTIMER_CMD_DELETE         3 /* 停止并释放 */
+
+/* 命令队列中的消息 */
+typedef struct htTimerCommand
+{
+    BaseType_t xCommand;   /* 命令 */
+    htTimer_t *pxTimer;    /* 目标定时器 */
+    TickType_t xValue;     /* 命令参数 */
+} htTimerCommand_t;
+
+/* 活动定时器，只由守护任务访问 */
+static htTimeWheel_t xActiveTimerWheel;
+/* 本批到期的定时器 */
+static htList_t xExpiredTimerList;
+/* 命令队列 */
+static QueueHandle_t xTimerQueue = NULL;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0
+/* 没有堆时命令队列和守护任务使用静态存储区 */
+static htStaticQueue_t xTimerQueueBuffer;
+static uint8_t ucTimerQueueStorage[configTIMER_QUEUE_LENGTH * sizeof(htTimerCommand_t)];
+static htTCB_t xTimerTaskTCB;
+static StackType_t xTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+#endif
+
+/**
+ * 初始化定时器服务的数据结构（只执行一次）
+ */
+static BaseType_t prvTimerInit(void)
+{
+    if (xTimerQueue == NULL)
+    {
+        htTimeWheelInit(&xActiveTimerWheel, xTickCount);
+        htListInit(&xExpiredTimerList);
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+        xTimerQueue = htQueueCreate(configTIMER_QUEUE_LENGTH, sizeof(htTimerCommand_t));
+#else
+        xTimerQueue = htQueueCreateStatic(configTIMER_QUEUE_LENGTH, sizeof(htTimerCommand_t), ucTimerQueueStorage,
+            &xTimerQueueBuffer);
+#endif
+    }
+
+    return (xTimerQueue != NULL) ? htPASS : htFAIL;
+}
+
+/**
+ * 判断时间xTime是否在xNow之后，tick回绕时仍然正确
+ */
+static BaseType_t prvTimeIsAfter(TickType_t xTime, TickType_t xNow)
+{
+    return ((TickType_t)(xTime - xNow - 1U) < 0x7FFFFFFFUL) ? htTRUE : htFALSE;
+}
+
+/**
+ * 定时轮到期回调 - 先收集到本批列表，整批处理
+ */
+static void prvTimerExpired(htListItem_t *pxItem)
+{
+    htListInsertEnd(&xExpiredTimerList, pxItem);
+}
+
+/**
+ * 处理一个到期的定时器：自动重载的定时器先重新放入定时轮再回调，
+ * 守护任务被耽搁而错过的周期逐个补上回调
+ */
+static void prvTimerFire(htTimer_t *pxTimer, TickType_t xExpiry, TickType_t xNow)
+{
+    if ((pxTimer->ucStatus & htTIMER_AUTO_RELOAD) != 0)
+    {
+        for (;;)
+        {
+            xExpiry += pxTimer->xTimerPeriod;
+            if (prvTimeIsAfter(xExpiry, xNow) == htTRUE)
+            {
+                htTimeWheelInsert(&xActiveTimerWheel, &(pxTimer->xTimerListItem), xExpiry);
+                break;
+            }
+            pxTimer->pxCallbackFunction(pxTimer);
+        }
+    }
+    else
+    {
+        pxTimer->ucStatus &= (uint8_t)~htTIMER_ACTIVE;
+    }
+
+    pxTimer->pxCallbackFunction(pxTimer);
+}
+
+/**
+ * 把定时轮推进到当前tick，并依次回调期间到期的所有定时器
+ * @return 当前tick
+ */
+static TickType_t prvProcessExpiredTimers(void)
+{
+    const TickType_t xNow = xTickCount;
+    htListItem_t *pxItem;
+
+    (void)htTimeWheelAdvance(&xActiveTimerWheel, xNow - xActiveTimerWheel.xTime, prvTimerExpired);
+
+    while ((pxItem = htListGetHead(&xExpiredTimerList)) != NULL)
+    {
+        htListRemove(pxItem);
+        prvTimerFire((htTimer_t *)htListGetItemOwner(pxItem), htListGetItemValue(pxItem), xNow);
+    }
+
+    return xNow;
+}
+
+/**
+ * 从xStartTime起按周期启动定时器，已经到期时立即处理
+ */
+static void prvTimerActivate(htTimer_t *pxTimer, TickType_t xStartTime, TickType_t xNow)
+{
+    const TickType_t xExpiry = xStartTime + pxTimer->xTimerPeriod;
+
+    pxTimer->ucStatus |= htTIMER_ACTIVE;
+
+    if (prvTimeIsAfter(xExpiry, xNow) == htTRUE)
+    {
+        htTimeWheelInsert(&xActiveTimerWheel, &(pxTimer->xTimerListItem), xExpiry);
+    }
+    else
+    {
+        /* 命令在队列中等待期间已经到期 */
+        prvTimerFire(pxTimer, xExpiry, xNow);
+    }
+}
+
+/**
+ * 执行一条命令
+ */
+static void prvProcessCommand(const htTimerCommand_t *pxCommand)
+{
+    htTimer_t *pxTimer = pxCommand->pxTimer;
+    /* 先处理到当前时间，保证定时轮时间与xNow一致 */
+    const TickType_t xNow = prvProcessExpiredTimers();
+
+    /* 无论什么命令，先从定时轮上摘下来 */
+    if (htListGetItemContainer(&(pxTimer->xTimerListItem)) != NULL)
+    {
+        htListRemove(&(pxTimer->xTimerListItem));
+    }
+
+    switch (pxCommand->xCommand)
+    {
+        case htTIMER_CMD_START:
+            prvTimerActivate(pxTimer, pxCommand->xValue, xNow);
+            break;
+
+        case htTIMER_CMD_CHANGE_PERIOD:
+            pxTimer->xTimerPeriod = pxCommand->xValue;
+            prvTimerActivate(pxTimer, xNow, xNow);
+            break;
+
+        case htTIMER_CMD_STOP:
+            pxTimer->ucStatus &= (uint8_t)~htTIMER_ACTIVE;
+            break;
+
+        case htTIMER_CMD_DELETE:
+            pxTimer->ucStatus &= (uint8_t)~htTIMER_ACTIVE;
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+            if ((pxTimer->ucStatus & htTIMER_STATIC) == 0)
+            {
+                htPortFree(pxTimer);
+            }
+#endif
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * 定时器守护任务
+ * 没有命令时睡到定时轮上的下一个事件，醒来后整批处理到期的定时器
+ */
+static void prvTimerTask(void *pvParameters)
+{
+    htTimerCommand_t xCommand;
+    TickType_t xNextEvent;
+    TickType_t xLate;
+
+    (void)pvParameters;
+
+    for (;;)
+    {
+        (void)prvProcessExpiredTimers();
+
+        /* 计算下一个事件时扣除处理期间已经流逝的tick */
+        xNextEvent = htTimeWheelNextEvent(&xActiveTimerWheel);
+        if (xNextEvent != htBLOCKED_INDEFINITELY)
+        {
+            xLate = xTickCount - xActiveTimerWheel.xTime;
+            xNextEvent = (xNextEvent > xLate) ? (xNextEvent - xLate) : 0;
+        }
+
+        if (htQueueReceive(xTimerQueue, &xCommand, xNextEvent) == htPASS)
+        {
+            /* 一次取完队列中积压的命令 */
+            do
+            {
+                prvProcessCommand(&xCommand);
+            } while (htQueueReceive(xTimerQueue, &xCommand, 0) == htPASS);
+        }
+    }
+}
+
+/**
+ * 发送命令到守护任务
+ */
+static BaseType_t prvSendCommand(htTimer_t *pxTimer, BaseType_t xCommand, TickType_t xValue, TickType_t xTicksToWait)
+{
+    htTimerCommand_t xMessage;
+
+    if (pxTimer == NULL || xTimerQueue == NULL)
+    {
+        return htFAIL;
+    }
+
+    xMessage.xCommand = xCommand;
+    xMessage.pxTimer = pxTimer;
+    xMessage.xValue = xValue;
+
+    return htQueueSend(xTimerQueue, &xMessage, xTicksToWait);
+}
+
+/**
+ * 从ISR发送命令到守护任务
+ */
+static BaseType_t prvSendCommandFromISR(htTimer_t *pxTimer, BaseType_t xCommand, TickType_t xValue,
+    BaseType_t *pxHigherPriorityTaskWoken)
+{
+    htTimerCommand_t xMessage;
+
+    if (pxTimer == NULL || xTimerQueue == NULL)
+    {
+        return htFAIL;
+    }
+
+    xMessage.xCommand = xCommand;
+    xMessage.pxTimer = pxTimer;
+    xMessage.xValue = xValue;
+
+    return htQueueSendFromISR(xTimerQueue, &xMessage, pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 创建定时器守护任务
+ */
+BaseType_t htTimerCreateTimerTask(void)
+{
+    if (prvTimerInit() != htPASS)
+    {
+        return htFAIL;
+    }
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+    return htTaskCreate(prvTimerTask, "TIMER", configTIMER_TASK_STACK_DEPTH, NULL, configTIMER_TASK_PRIORITY, NULL);
+#else
+    return (htTaskCreateStatic(prvTimerTask, "TIMER", configTIMER_TASK_STACK_DEPTH, NULL, configTIMER_TASK_PRIORITY,
+        xTimerTaskStack, &xTimerTaskTCB) != NULL) ? htPASS : htFAIL;
+#endif
+}
+
+/**
+ * 初始化定时器结构
+ */
+static void prvInitialiseNewTimer(const char *pcTimerName, TickType_t xTimerPeriod, BaseType_t xAutoReload,
+    void *pvTimerID, htTimerCallback_t pxCallbackFunction, htTimer_t *pxTimer)
+{
+    pxTimer->pcTimerName = pcTimerName;
+    pxTimer->xTimerPeriod = xTimerPeriod;
+    pxTimer->pvTimerID = pvTimerID;
+    pxTimer->pxCallbackFunction = pxCallbackFunction;
+    pxTimer->ucStatus = (xAutoReload != htFALSE) ? htTIMER_AUTO_RELOAD : 0U;
+    htListItemInit(&(pxTimer->xTimerListItem));
+    htListSetItemOwner(&(pxTimer->xTimerListItem), pxTimer);
+}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 1
+/**
+ * 创建定时器
+ */
+TimerHandle_t htTimerCreate(const char *pcTimerName, TickType_t xTimerPeriod, BaseType_t xAutoReload,
+    void *pvTimerID, htTimerCallback_t pxCallbackFunction)
+{
+    htTimer_t *pxTimer;
+
+    /* 检查参数有效性 */
+    if (xTimerPeriod == 0 || pxCallbackFunction == NULL || prvTimerInit() != htPASS)
+    {
+        return NULL;
+    }
+
+    pxTimer = (htTimer_t *)htPortMalloc(sizeof(htTimer_t));
+
+    if (pxTimer != NULL)
+    {
+        prvInitialiseNewTimer(pcTimerName, xTimerPeriod, xAutoReload, pvTimerID, pxCallbackFunction, pxTimer);
+    }
+
+    return pxTimer;
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+/**
+ * 使用调用者提供的存储区创建定时器
+ */
+TimerHandle_t htTimerCreateStatic(const char *pcTimerName, TickType_t xTimerPeriod, BaseType_t xAutoReload,
+    void *pvTimerID, htTimerCallback_t pxCallbackFunction, htStaticTimer_t *pxTimerBuffer)
+{
+    /* 检查参数有效性 */
+    if (xTimerPeriod == 0 || pxCallbackFunction == NULL || pxTimerBuffer == NULL || prvTimerInit() != htPASS)
+    {
+        return NULL;
+    }
+
+    prvInitialiseNewTimer(pcTimerName, xTimerPeriod, xAutoReload, pvTimerID, pxCallbackFunction, pxTimerBuffer);
+    pxTimerBuffer->ucStatus |= htTIMER_STATIC;
+
+    return pxTimerBuffer;
+}
+#endif
+
+/**
+ * 启动定时器，从调用时刻起计时；已启动的定时器重新计时
+ */
+BaseType_t htTimerStart(TimerHandle_t xTimer, TickType_t xTicksToWait)
+{
+    return prvSendCommand(xTimer, htTIMER_CMD_START, xTickCount, xTicksToWait);
+}
+
+/**
+ * 停止定时器
+ */
+BaseType_t htTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait)
+{
+    return prvSendCommand(xTimer, htTIMER_CMD_STOP, 0, xTicksToWait);
+}
+
+/**
+ * 复位定时器，等同于从调用时刻重新启动
+ */
+BaseType_t htTimerReset(TimerHandle_t xTimer, TickType_t xTicksToWait)
+{
+    return prvSendCommand(xTimer, htTIMER_CMD_START, xTickCount, xTicksToWait);
+}
+
+/**
+ * 修改周期，定时器随之以新周期重新启动
+ */
+BaseType_t htTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait)
+{
+    if (xNewPeriod == 0)
+    {
+        return htFAIL;
+    }
+
+    return prvSendCommand(xTimer, htTIMER_CMD_CHANGE_PERIOD, xNewPeriod, xTicksToWait);
+}
+
+/**
+ * 删除定时器，由守护任务停止并释放
+ */
+BaseType_t htTimerDelete(TimerHandle_t xTimer, TickType_t xTicksToWait)
+{
+    return prvSendCommand(xTimer, htTIMER_CMD_DELETE, 0, xTicksToWait);
+}
+
+/**
+ * 从ISR中启动定时器
+ */
+BaseType_t htTimerStartFromISR(TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return prvSendCommandFromISR(xTimer, htTIMER_CMD_START, xTickCount, pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 从ISR中停止定时器
+ */
+BaseType_t htTimerStopFromISR(TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return prvSendCommandFromISR(xTimer, htTIMER_CMD_STOP, 0, pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 从ISR中复位定时器
+ */
+BaseType_t htTimerResetFromISR(TimerHandle_t xTimer, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return prvSendCommandFromISR(xTimer, htTIMER_CMD_START, xTickCount, pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 从ISR中修改周期
+ */
+BaseType_t htTimerChangePeriodFromISR(TimerHandle_t xTimer, TickType_t xNewPeriod,
+    BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (xNewPeriod == 0)
+    {
+        return htFAIL;
+    }
+
+    return prvSendCommandFromISR(xTimer, htTIMER_CMD_CHANGE_PERIOD, xNewPeriod, pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 获取用户标识
+ */
+void *htTimerGetTimerID(TimerHandle_t xTimer)
+{
+    return (xTimer != NULL) ? xTimer->pvTimerID : NULL;
+}
+
+/**
+ * 获取定时器名称
+ */
+const char *htTimerGetName(TimerHandle_t xTimer)
+{
+    return (xTimer != NULL) ? xTimer->pcTimerName : NULL;
+}
+
+/**
+ * 获取周期
+ */
+TickType_t htTimerGetPeriod(TimerHandle_t xTimer)
+{
+    return (xTimer != NULL) ? xTimer->xTimerPeriod : 0;
+}
+
+/**
+ * 查询定时器是否已启动（反映守护任务已处理的命令）
+ */
+BaseType_t htTimerIsTimerActive(TimerHandle_t xTimer)
+{
+    if (xTimer == NULL)
+    {
+        return htFALSE;
+    }
+
+    return ((xTimer->ucStatus & htTIMER_ACTIVE) != 0) ? htTRUE : htFALSE;
+}
+
+#endif /* configUSE_TIMERS */
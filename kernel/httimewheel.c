@@ -0,0 +1,223 @@
+/**
+ * @file httimewheel.c
+ * @brief 分级定时轮实现
+ *
+ * 以SLOT_BITS=4、LEVELS=4为例，唤醒时间距当前时间的tick数delta决定所在级：
+ *   delta < 2^4  -> 第0级，槽 = 唤醒时间[3:0]
+ *   delta < 2^8  -> 第1级，槽 = 唤醒时间[7:4]
+ *   delta < 2^12 -> 第2级，槽 = 唤醒时间[11:8]
+ *   delta < 2^16 -> 第3级，槽 = 唤醒时间[15:12]
+ *   其余         -> 溢出列表
+ * 当时间的低(SLOT_BITS*L)位归零时，第L级的当前槽被下放：其中每项按新的delta重新插入，
+ * 必然落入更低的级，直至第0级到期。每项最多被下放LEVELS-1次，故到期处理为均摊O(1)。
+ */
+#include "httimewheel.h"
+
+/**
+ * 按唤醒时间把列表项放入对应的级和槽
+ * delta为0的项放入第0级当前槽，用于下放后立即在本tick到期
+ */
+static void prvTimeWheelPlace(htTimeWheel_t *pxWheel, htListItem_t *pxItem)
+{
+	const TickType_t xWakeTime = htListGetItemValue(pxItem);
+	const TickType_t xDelta = xWakeTime - pxWheel->xTime;
+	TickType_t xRemain = xDelta >> configTIMEWHEEL_SLOT_BITS;
+	UBaseType_t uxLevel = 0;
+	UBaseType_t uxSlot;
+
+	/* 找到满足 delta < 2^(SLOT_BITS*(L+1)) 的最低级 */
+	while (xRemain != 0 && uxLevel < (configTIMEWHEEL_LEVELS - 1)) {
+		xRemain >>= configTIMEWHEEL_SLOT_BITS;
+		uxLevel++;
+	}
+
+#if htTIMEWHEEL_RANGE_BITS < 32
+	if (xRemain != 0) {
+		/* 超出定时轮范围，等顶级转完一圈再分配 */
+		htListInsertEnd(&(pxWheel->xOverflow), pxItem);
+		return;
+	}
+#endif
+
+	uxSlot = (UBaseType_t)((xWakeTime >> (configTIMEWHEEL_SLOT_BITS * uxLevel)) & htTIMEWHEEL_SLOT_MASK);
+	htListInsertEnd(&(pxWheel->xSlots[uxLevel][uxSlot]), pxItem);
+}
+
+/**
+ * 下放一个槽：取出其中所有项并按当前时间重新插入
+ */
+static void prvTimeWheelCascade(htTimeWheel_t *pxWheel, htList_t *pxList)
+{
+	htListItem_t *pxItem;
+
+	while ((pxItem = htListGetHead(pxList)) != NULL) {
+		htListRemove(pxItem);
+		prvTimeWheelPlace(pxWheel, pxItem);
+	}
+}
+
+#if htTIMEWHEEL_RANGE_BITS < 32
+/**
+ * 重新分配溢出列表：已进入定时轮范围的项移入各级槽，其余留在溢出列表
+ * 每项每2^RANGE_BITS个tick才被检查一次
+ */
+static void prvTimeWheelCascadeOverflow(htTimeWheel_t *pxWheel)
+{
+	const htListItem_t *pxEnd = (const htListItem_t *)&(pxWheel->xOverflow.xListEnd);
+	htListItem_t *pxItem = pxWheel->xOverflow.xListEnd.pxNext;
+	htListItem_t *pxNext;
+
+	while (pxItem != pxEnd) {
+		pxNext = pxItem->pxNext;
+		if (((htListGetItemValue(pxItem) - pxWheel->xTime) >> htTIMEWHEEL_RANGE_BITS) == 0) {
+			htListRemove(pxItem);
+			prvTimeWheelPlace(pxWheel, pxItem);
+		}
+		pxItem = pxNext;
+	}
+}
+#endif
+
+/**
+ * 初始化定时轮
+ */
+void htTimeWheelInit(htTimeWheel_t *pxWheel, TickType_t xNow)
+{
+	UBaseType_t uxLevel;
+	UBaseType_t uxSlot;
+
+	pxWheel->xTime = xNow;
+	for (uxLevel = 0; uxLevel < configTIMEWHEEL_LEVELS; uxLevel++) {
+		for (uxSlot = 0; uxSlot < htTIMEWHEEL_SLOTS; uxSlot++) {
+			htListInit(&(pxWheel->xSlots[uxLevel][uxSlot]));
+		}
+	}
+#if htTIMEWHEEL_RANGE_BITS < 32
+	htListInit(&(pxWheel->xOverflow));
+#endif
+}
+
+/**
+ * 插入列表项 - O(1)
+ */
+void htTimeWheelInsert(htTimeWheel_t *pxWheel, htListItem_t *pxItem, TickType_t xWakeTime)
+{
+	/* 当前tick的槽已经处理过，唤醒时间为当前时间的项推迟到下一个tick */
+	if (xWakeTime == pxWheel->xTime) {
+		xWakeTime++;
+	}
+
+	htListSetItemValue(pxItem, xWakeTime);
+	prvTimeWheelPlace(pxWheel, pxItem);
+}
+
+/**
+ * 定时轮前进一个tick
+ */
+UBaseType_t htTimeWheelTick(htTimeWheel_t *pxWheel, htTimeWheelExpired_t pxExpired)
+{
+	UBaseType_t uxExpired = 0;
+	UBaseType_t uxLevel;
+	UBaseType_t uxSlot;
+	htList_t *pxList;
+	htListItem_t *pxItem;
+
+	pxWheel->xTime++;
+
+	/* 低一级转完一圈时下放高一级的当前槽，逐级向上 */
+	if ((pxWheel->xTime & htTIMEWHEEL_SLOT_MASK) == 0) {
+		for (uxLevel = 1; uxLevel < configTIMEWHEEL_LEVELS; uxLevel++) {
+			uxSlot = (UBaseType_t)((pxWheel->xTime >> (configTIMEWHEEL_SLOT_BITS * uxLevel)) & htTIMEWHEEL_SLOT_MASK);
+			prvTimeWheelCascade(pxWheel, &(pxWheel->xSlots[uxLevel][uxSlot]));
+			if (uxSlot != 0) {
+				break;
+			}
+		}
+#if htTIMEWHEEL_RANGE_BITS < 32
+		/* 顶级也转完一圈 */
+		if (uxLevel == configTIMEWHEEL_LEVELS) {
+			prvTimeWheelCascadeOverflow(pxWheel);
+		}
+#endif
+	}
+
+	/* 第0级当前槽中的项全部在本tick到期 */
+	pxList = &(pxWheel->xSlots[0][pxWheel->xTime & htTIMEWHEEL_SLOT_MASK]);
+	while ((pxItem = htListGetHead(pxList)) != NULL) {
+		htListRemove(pxItem);
+		uxExpired++;
+		if (pxExpired != NULL) {
+			pxExpired(pxItem);
+		}
+	}
+
+	return uxExpired;
+}
+
+/**
+ * 距离下一个需要处理的tick的tick数
+ * 第L级槽s在时间t被处理，t满足 t的低(SLOT_BITS*L)位为0 且 t的第L级索引为s，
+ * 即从当前索引cur起第 ((s - cur - 1) & MASK) + 1 次进位时。
+ */
+TickType_t htTimeWheelNextEvent(htTimeWheel_t *pxWheel)
+{
+	TickType_t xNearest = htBLOCKED_INDEFINITELY;
+	TickType_t xDelta;
+	TickType_t xBase;
+	UBaseType_t uxLevel;
+	UBaseType_t uxSlot;
+	UBaseType_t uxShift;
+	UBaseType_t uxCurrent;
+
+	for (uxLevel = 0; uxLevel < configTIMEWHEEL_LEVELS; uxLevel++) {
+		uxShift = configTIMEWHEEL_SLOT_BITS * uxLevel;
+		xBase = pxWheel->xTime >> uxShift;
+		uxCurrent = (UBaseType_t)(xBase & htTIMEWHEEL_SLOT_MASK);
+		/* 从当前槽的下一个开始找第一个非空槽，即为本级最早的事件 */
+		for (uxSlot = 1; uxSlot <= htTIMEWHEEL_SLOTS; uxSlot++) {
+			if (htListGetCurrentNumberOfItems(
+						&(pxWheel->xSlots[uxLevel][(uxCurrent + uxSlot) & htTIMEWHEEL_SLOT_MASK])) != 0) {
+				xDelta = ((xBase + uxSlot) << uxShift) - pxWheel->xTime;
+				if (xDelta < xNearest) {
+					xNearest = xDelta;
+				}
+				break;
+			}
+		}
+	}
+
+#if htTIMEWHEEL_RANGE_BITS < 32
+	if (htListGetCurrentNumberOfItems(&(pxWheel->xOverflow)) != 0) {
+		xDelta = (1UL << htTIMEWHEEL_RANGE_BITS) - (pxWheel->xTime & ((1UL << htTIMEWHEEL_RANGE_BITS) - 1UL));
+		if (xDelta < xNearest) {
+			xNearest = xDelta;
+		}
+	}
+#endif
+
+	return xNearest;
+}
+
+/**
+ * 定时轮一次前进多个tick
+ */
+UBaseType_t htTimeWheelAdvance(htTimeWheel_t *pxWheel, TickType_t xTicks, htTimeWheelExpired_t pxExpired)
+{
+	UBaseType_t uxExpired = 0;
+	TickType_t xNext;
+
+	while (xTicks > 0) {
+		xNext = htTimeWheelNextEvent(pxWheel);
+		if (xNext > xTicks) {
+			/* 剩余的tick内没有槽需要处理 */
+			pxWheel->xTime += xTicks;
+			break;
+		}
+		/* 跳到事件前一个tick，再正常处理事件所在的tick */
+		pxWheel->xTime += xNext - 1;
+		xTicks -= xNext;
+		uxExpired += htTimeWheelTick(pxWheel, pxExpired);
+	}
+
+	return uxExpired;
+}
@@ -1,7 +1,8 @@
 #include "htutils.h"
 #include "htos.h"
 #include "httask.h"
-#include "stm32f1xx_hal.h" // 添加此行以解决HAL_Delay未声明警告
+#include "htscheduler.h"
+#include <stdio.h>
 
 
 /**
@@ -27,43 +28,147 @@ uint32_t htTicksToTime(TickType_t ticks)
 
 /**
  * 获取任务堆栈使用高水位标记
- * @param xTask 要检查的任务句柄
- * @return 堆栈使用高水位标记（以字为单位）
+ * 栈向下增长，从栈底(pxStack)向上逐字比较，仍是填充图案的字从未被使用过
+ * @param xTask 要检查的任务句柄，NULL表示当前任务
+ * @return 任务运行以来栈剩余空间的最小值（以字为单位）
  */
 UBaseType_t htGetTaskStackHighWaterMark(TaskHandle_t xTask)
 {
-    /* 防止未使用参数警告 */
-    (void)xTask;
-    
-    /* 简化实现，实际应该检查堆栈模式 */
-    return 0;
+    htTCB_t *pxTCB = (xTask == NULL) ? pxCurrentTCB : (htTCB_t *)xTask;
+    const StackType_t *pxWord;
+    UBaseType_t uxFree = 0;
+
+    if (pxTCB == NULL || pxTCB->pxStack == NULL) {
+        return 0;
+    }
+
+    pxWord = pxTCB->pxStack;
+    while (uxFree < pxTCB->uxStackDepth && *pxWord == (StackType_t)configSTACK_FILL_PATTERN) {
+        pxWord++;
+        uxFree++;
+    }
+
+    pxTCB->uxStackHighWaterMark = uxFree;
+
+    return uxFree;
+}
+
+/**
+ * 根据峰值用量计算建议的栈大小
+ * 峰值加configSTACK_REPORT_MARGIN百分比的余量，按8字(32字节)向上取整，不小于configMINIMAL_STACK_SIZE
+ * @param uxUsed 峰值用量（字）
+ * @return 建议的usStackDepth（字）
+ */
+UBaseType_t htGetRecommendedStackDepth(UBaseType_t uxUsed)
+{
+    UBaseType_t uxDepth = uxUsed + (uxUsed * configSTACK_REPORT_MARGIN + 99U) / 100U;
+
+    uxDepth = (uxDepth + 7U) & ~(UBaseType_t)7U;
+    if (uxDepth < configMINIMAL_STACK_SIZE) {
+        uxDepth = configMINIMAL_STACK_SIZE;
+    }
+
+    return uxDepth;
+}
+
+/**
+ * 打印所有任务的栈使用报告
+ * 每个任务给出栈大小、峰值用量、最小剩余和建议的usStackDepth，最后汇总可节省的堆内存。
+ * 峰值只反映到目前为止实际走过的路径，应在覆盖了各任务最深调用路径的压力测试之后调用。
+ */
+void htStackReport(void)
+{
+    htListItem_t *pxEnd = (htListItem_t *)&(pxAllocatedTasksList.xListEnd);
+    htListItem_t *pxItem;
+    htTCB_t *pxTCB;
+    UBaseType_t uxFree;
+    UBaseType_t uxUsed;
+    UBaseType_t uxRecommended;
+    uint32_t ulSavedWords = 0;
+
+    printf("%-16s %6s %6s %6s %6s\r\n", "task", "depth", "used", "free", "advise");
+
+    htSchedulerSuspend();
+    for (pxItem = pxEnd->pxNext; pxItem != pxEnd; pxItem = pxItem->pxNext) {
+        pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+        uxFree = htGetTaskStackHighWaterMark(pxTCB);
+        uxUsed = pxTCB->uxStackDepth - uxFree;
+        uxRecommended = htGetRecommendedStackDepth(uxUsed);
+        if (uxRecommended < pxTCB->uxStackDepth) {
+            ulSavedWords += pxTCB->uxStackDepth - uxRecommended;
+        }
+
+        printf("%-16s %6lu %6lu %6lu %6lu\r\n", pxTCB->pcTaskName, (unsigned long)pxTCB->uxStackDepth,
+            (unsigned long)uxUsed, (unsigned long)uxFree, (unsigned long)uxRecommended);
+    }
+    htSchedulerResume();
+
+    printf("trimming to advised depths frees %lu bytes of heap\r\n",
+        (unsigned long)(ulSavedWords * sizeof(StackType_t)));
 }
 
 /**
  * 获取CPU使用率
- * @return CPU使用百分比（0-100）
+ * @return 最近configRUN_TIME_STATS_WINDOW秒内的CPU使用百分比（0-100）
  */
 uint32_t htGetCPUUsage(void)
 {
-    /* 需要基于空闲任务运行时间计算 */
+    /* 空闲任务之外的时间都算作负载 */
     return 100 - htGetIdleRunTimePercent();
 }
 
 /**
  * 获取空闲任务运行时间百分比
- * @return 空闲任务运行时间百分比（0-100）
+ * @return 最近configRUN_TIME_STATS_WINDOW秒内空闲任务运行时间百分比（0-100），
+ *         未启用运行时间统计时返回100
  */
 uint32_t htGetIdleRunTimePercent(void)
 {
-    /* 简化实现 */
+#if configGENERATE_RUN_TIME_STATS == 1
+    uint64_t ullTotal;
+    uint64_t ullIdle;
+
+    htTaskGetRunTimeWindow(&ullTotal, &ullIdle);
+    if (ullTotal == 0) {
+        return 100;
+    }
+
+    return (uint32_t)((ullIdle * 100U) / ullTotal);
+#else
+    return 100;
+#endif
+}
+
+/**
+ * 获取任务运行时间百分比
+ * @param xTask 任务句柄，NULL表示当前任务
+ * @return 从启动到现在该任务占用的运行时间百分比（0-100）
+ */
+uint32_t htGetTaskRunTimePercent(TaskHandle_t xTask)
+{
+#if configGENERATE_RUN_TIME_STATS == 1
+    uint64_t ullTotal = htTaskGetTotalRunTime();
+
+    if (ullTotal == 0) {
+        return 0;
+    }
+
+    return (uint32_t)((htTaskGetRunTimeCounter(xTask) * 100U) / ullTotal);
+#else
+    (void)xTask;
     return 0;
+#endif
 }
 
 /**
  * 获取系统总运行时间计数
- * @return 系统运行时间计数
+ * @return 从启动到现在所有任务累计的运行时间（移植层计数器单位）
  */
 uint64_t htGetRunTimeCounter(void)
 {
+#if configGENERATE_RUN_TIME_STATS == 1
+    return htTaskGetTotalRunTime();
+#else
     return 0;
+#endif
 }
@@ -0,0 +1,215 @@
+/**
+ * @file htwait.c
+ * @brief 等待队列实现
+ */
+#include "htwait.h"
+#include "httask.h"
+#include "htscheduler.h"
+
+/**
+ * 按唤醒顺序把任务的事件列表项放入等待列表
+ * 优先级模式下从表尾向前找到第一个键值不大于自己的项并插在其后，
+ * 同优先级保持先来先醒，与更低优先级的等待者数量成正比，表头始终是最高优先级。
+ */
+static void prvWaitQueueInsert(htWaitQueue_t *pxWaitQueue, htTCB_t *pxTCB)
+{
+	htList_t *pxList = &(pxWaitQueue->xTasks);
+	htListItem_t *pxNewItem = &(pxTCB->xEventListItem);
+	htListItem_t *pxEnd = (htListItem_t *)&(pxList->xListEnd);
+	htListItem_t *pxIterator;
+	TickType_t xKey;
+
+	if (pxWaitQueue->uxOrder == htWAIT_ORDER_FIFO) {
+		htListInsertEnd(pxList, pxNewItem);
+		return;
+	}
+
+	xKey = htWAIT_PRIORITY_KEY(pxTCB->uxPriority);
+	htListSetItemValue(pxNewItem, xKey);
+
+	for (pxIterator = pxEnd->pxPrevious; pxIterator != pxEnd && pxIterator->xItemValue > xKey;
+			pxIterator = pxIterator->pxPrevious) {
+		/* 跳过更低优先级的等待者 */
+	}
+
+	pxNewItem->pxNext = pxIterator->pxNext;
+	pxNewItem->pxPrevious = pxIterator;
+	pxIterator->pxNext->pxPrevious = pxNewItem;
+	pxIterator->pxNext = pxNewItem;
+	pxNewItem->pxContainer = pxList;
+	(pxList->uxNumberOfItems)++;
+}
+
+/**
+ * 初始化等待队列
+ */
+void htWaitQueueInit(htWaitQueue_t *pxWaitQueue)
+{
+	htListInit(&(pxWaitQueue->xTasks));
+	pxWaitQueue->uxOrder = htWAIT_ORDER_PRIORITY;
+	pxWaitQueue->pxOwner = NULL;
+	pxWaitQueue->pxNextHeld = NULL;
+}
+
+/**
+ * 设置唤醒顺序
+ */
+void htWaitQueueSetOrder(htWaitQueue_t *pxWaitQueue, UBaseType_t uxOrder)
+{
+	pxWaitQueue->uxOrder = uxOrder;
+}
+
+/**
+ * 查询是否有任务在等待
+ */
+BaseType_t htWaitQueueIsEmpty(htWaitQueue_t *pxWaitQueue)
+{
+	return (htListGetCurrentNumberOfItems(&(pxWaitQueue->xTasks)) == 0) ? htTRUE : htFALSE;
+}
+
+/**
+ * 阻塞当前任务直到被唤醒或超时
+ */
+BaseType_t htWaitQueueBlock(htWaitQueue_t *pxWaitQueue, TickType_t *pxTicksToWait)
+{
+	const TickType_t xEnterTime = xTickCount;
+	TickType_t xElapsed;
+	BaseType_t xResult;
+
+	/* 默认按超时处理，事件唤醒时由唤醒方改写 */
+	pxCurrentTCB->xWaitResult = htWAIT_TIMEOUT;
+	pxCurrentTCB->pxWaitQueue = pxWaitQueue;
+	prvWaitQueueInsert(pxWaitQueue, pxCurrentTCB);
+
+	/* 移出就绪列表并放入定时轮 */
+	htTaskPlaceOnDelayedList(*pxTicksToWait);
+
+	/* 退出临界区时挂起的PendSV立即执行，任务在此处切出 */
+	htTaskYield();
+	htExitCritical();
+
+	/* 被唤醒或超时后从这里继续 */
+	htEnterCritical();
+
+	xResult = pxCurrentTCB->xWaitResult;
+	if (xResult == htWAIT_TIMEOUT) {
+		*pxTicksToWait = 0;
+	} else if (*pxTicksToWait != htBLOCKED_INDEFINITELY) {
+		xElapsed = xTickCount - xEnterTime;
+		*pxTicksToWait = (xElapsed < *pxTicksToWait) ? (*pxTicksToWait - xElapsed) : 0;
+	}
+
+	return xResult;
+}
+
+/**
+ * 唤醒等待队列中的第一个任务
+ */
+htTCB_t *htWaitQueueWakeOne(htWaitQueue_t *pxWaitQueue)
+{
+	htListItem_t *pxItem = htListGetHead(&(pxWaitQueue->xTasks));
+	htTCB_t *pxTCB;
+
+	if (pxItem == NULL) {
+		return NULL;
+	}
+
+	pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+	htWaitQueueWakeTask(pxTCB);
+
+	return pxTCB;
+}
+
+/**
+ * 唤醒等待队列中的指定任务
+ */
+void htWaitQueueWakeTask(htTCB_t *pxTCB)
+{
+	htWaitQueueRemove(pxTCB);
+
+	/* 撤销超时并移入就绪列表，调度器挂起时先进入待就绪列表 */
+	pxTCB->xWaitResult = htWAIT_SIGNALLED;
+	htTaskUnblock(pxTCB);
+}
+
+/**
+ * 把任务从它所在的等待队列中移除
+ */
+void htWaitQueueRemove(htTCB_t *pxTCB)
+{
+	if (pxTCB->pxWaitQueue == NULL) {
+		return;
+	}
+
+	htListRemove(&(pxTCB->xEventListItem));
+	pxTCB->pxWaitQueue = NULL;
+}
+
+/**
+ * 等待中的任务优先级改变后调整其在等待列表中的位置
+ */
+void htWaitQueueReposition(htTCB_t *pxTCB)
+{
+	htWaitQueue_t *pxWaitQueue = pxTCB->pxWaitQueue;
+
+	if (pxWaitQueue == NULL || pxWaitQueue->uxOrder == htWAIT_ORDER_FIFO) {
+		return;
+	}
+
+	htListRemove(&(pxTCB->xEventListItem));
+	prvWaitQueueInsert(pxWaitQueue, pxTCB);
+}
+
+/**
+ * 设置互斥量等待队列的持有者
+ */
+void htWaitQueueSetOwner(htWaitQueue_t *pxWaitQueue, htTCB_t *pxOwner)
+{
+	htWaitQueue_t **ppxLink;
+
+	if (pxWaitQueue->pxOwner == pxOwner) {
+		return;
+	}
+
+	if (pxWaitQueue->pxOwner != NULL) {
+		for (ppxLink = &(pxWaitQueue->pxOwner->pxMutexesHeld); *ppxLink != NULL;
+				ppxLink = &((*ppxLink)->pxNextHeld)) {
+			if (*ppxLink == pxWaitQueue) {
+				*ppxLink = pxWaitQueue->pxNextHeld;
+				break;
+			}
+		}
+	}
+
+	pxWaitQueue->pxOwner = pxOwner;
+	pxWaitQueue->pxNextHeld = NULL;
+	if (pxOwner != NULL) {
+		pxWaitQueue->pxNextHeld = pxOwner->pxMutexesHeld;
+		pxOwner->pxMutexesHeld = pxWaitQueue;
+	}
+}
+
+/**
+ * 查询等待者中的最高优先级
+ * 按优先级排列时表头即最高；按到达顺序排列时需要遍历
+ */
+UBaseType_t htWaitQueueGetTopPriority(htWaitQueue_t *pxWaitQueue)
+{
+	htList_t *pxList = &(pxWaitQueue->xTasks);
+	const htListItem_t *pxEnd = (const htListItem_t *)&(pxList->xListEnd);
+	htListItem_t *pxItem;
+	htTCB_t *pxTCB;
+	UBaseType_t uxTop = 0;
+
+	for (pxItem = pxList->xListEnd.pxNext; pxItem != pxEnd; pxItem = pxItem->pxNext) {
+		pxTCB = (htTCB_t *)htListGetItemOwner(pxItem);
+		if (pxTCB->uxPriority > uxTop) {
+			uxTop = pxTCB->uxPriority;
+		}
+		if (pxWaitQueue->uxOrder == htWAIT_ORDER_PRIORITY) {
+			break;
+		}
+	}
+
+	return uxTop;
+}
@@ -1,18 +1,120 @@
 /**
  * @file htPort.h
  * @brief Cortex-M 特定的移植层定义
+ *
+ * 内核只通过本文件访问硬件：中断屏蔽、触发任务切换、初始化任务栈、启动调度器。
+ * 器件头文件只在这里包含，内核源文件不再直接包含stm32/CMSIS头文件。
  */
 #ifndef HT_PORT_H
 #define HT_PORT_H
 
 #include <stdint.h>
+#include "httypes.h"
+#include "stm32f1xx.h"
+#include "core_cm3.h"
 
+/* SysTick的优先级(BASEPRI格式)，必须在内核可屏蔽的范围内 */
+#ifndef htPORT_SYSTICK_PRIORITY
+#define htPORT_SYSTICK_PRIORITY 0x70
+#endif
 
+#if htPORT_SYSTICK_PRIORITY < configMAX_SYSCALL_INTERRUPT_PRIORITY
+#error "htPORT_SYSTICK_PRIORITY must not be above configMAX_SYSCALL_INTERRUPT_PRIORITY"
+#endif
+
+/* BASEPRI格式的优先级转换为NVIC_SetPriority()使用的优先级编号 */
+#define htPortPriorityToNVIC(ucPriority) ((uint32_t)(ucPriority) >> (8U - __NVIC_PRIO_BITS))
+
+/**
+ * 中断屏蔽：把BASEPRI抬到configMAX_SYSCALL_INTERRUPT_PRIORITY
+ * 只屏蔽会调用内核API的中断，更高优先级的中断(如电机控制PWM)在内核临界区中照常响应。
+ * 任务中通过htEnterCritical()/htExitCritical()嵌套使用，不要直接调用。
+ */
+static __inline void htPortDisableInterrupts(void)
+{
+    __set_BASEPRI(configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    __DSB();
+    __ISB();
+}
+
+static __inline void htPortEnableInterrupts(void)
+{
+    __set_BASEPRI(0);
+}
+
+/**
+ * 中断中屏蔽：保存当前BASEPRI后抬到上限，供FromISR接口使用
+ * 中断可能嵌套在另一个已抬高BASEPRI的中断里，退出时必须恢复原值而不是清零
+ * @return 原来的BASEPRI
+ */
+static __inline UBaseType_t htPortSetInterruptMaskFromISR(void)
+{
+    UBaseType_t uxSaved = (UBaseType_t)__get_BASEPRI();
+
+    __set_BASEPRI(configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    __DSB();
+    __ISB();
+
+    return uxSaved;
+}
+
+static __inline void htPortClearInterruptMaskFromISR(UBaseType_t uxSaved)
+{
+    __set_BASEPRI(uxSaved);
+}
+
+/**
+ * 原子比较交换：*puxTarget等于uxExpected时改为uxNew，LDREX/STREX实现，不屏蔽中断
+ * 两条指令之间发生异常时独占监视器被清除，STREX失败后重试
+ * @return 交换成功返回htTRUE
+ */
+static __inline BaseType_t htPortCompareAndSwap(volatile uintptr_t *puxTarget, uintptr_t uxExpected, uintptr_t uxNew)
+{
+    do
+    {
+        if (__LDREXW((volatile uint32_t *)puxTarget) != uxExpected)
+        {
+            __CLREX();
+            return htFALSE;
+        }
+    } while (__STREXW(uxNew, (volatile uint32_t *)puxTarget) != 0U);
+
+    __DMB();
+
+    return htTRUE;
+}
+
+/* 请求任务切换：挂起PendSV，中断打开后在最低优先级执行 */
+#define htPortYield() (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+
+/* 释放任务栈前的移植层清理，Cortex-M上任务上下文全部保存在任务栈中，无需处理 */
+#define htPortReleaseStack(pxTopOfStack) ((void)(pxTopOfStack))
+
+/**
+ * 在任务栈顶构造初始异常栈帧
+ * @param pxTopOfStack 任务栈最高地址处的字
+ * @param pxCode 任务函数
+ * @param pvParameters 任务参数
+ * @return 保存到TCB的栈指针
+ */
+StackType_t *htPortInitialiseStack(StackType_t *pxTopOfStack, void (*pxCode)(void *), void *pvParameters);
+
+/**
+ * 启动调度器：设置PendSV/SysTick优先级并切到pxCurrentTCB，正常情况下不返回
+ * @return 启动失败时返回htFAIL
+ */
+BaseType_t htPortStartScheduler(void);
+
+/**
+ * 停止调度器，目标板上无法回到main，关掉滴答后停在此处
+ */
+void htPortEndScheduler(void);
 
 /**
  * 启动第一个任务
  */
 void vPortStartFirstTask(void);
+#define htPortStartFirstTask vPortStartFirstTask
 
 /**
  * PendSV中断处理函数
@@ -26,4 +128,24 @@ void PendSV_Handler(void);
  */
 void SVC_Handler(void);
 
+/**
+ * 无滴答空闲：停掉周期性滴答睡眠最多xExpectedIdleTime个tick
+ * 由空闲任务在调度器挂起时调用（configUSE_TICKLESS_IDLE == 1）。
+ * 移植层须在关中断后调用htTaskConfirmSleepModeStatus()确认仍可睡眠，
+ * 醒来后用htTaskStepTick()补上睡眠期间流逝的整tick数。
+ * 主机/仿真移植层实现此函数即可在测试中检查tick补偿。
+ *
+ * @param xExpectedIdleTime 预计空闲的tick数
+ */
+void htPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+
+/**
+ * 运行时间统计计数器（configGENERATE_RUN_TIME_STATS == 1）
+ * 内核在每次任务切换和每个滴答读取计数器，把增量累计到各任务的64位计数中，
+ * 因此计数器只需32位，两个滴答之间不回绕即可。分辨率越高统计越准：
+ * Cortex-M3使用DWT周期计数器，主机移植层使用单调时钟。
+ */
+void htPortConfigureRunTimeCounter(void);
+uint32_t htPortGetRunTimeCounter(void);
+
 #endif /* HT_PORT_H */
@@ -1,8 +1,11 @@
 #include "httask.h"
+#include "htscheduler.h"
+#include "htPort.h"
 #include "stm32f1xx.h" // Device specific header file
 #include "stm32f1xx_hal.h" // HAL library
 #include "core_cm3.h" // Cortex-M3 core definitions
 #include <stdio.h> // For debug output
+#include <string.h>
 #include "gpio.h" // GPIO definitions
 #include "../../Trace/coredump/inc/coredump.h" // CoreDump support
 
@@ -13,6 +16,79 @@ extern int armv7m_hard_fault_exception_hook(void *context);
 /* Task switching control */
 extern htTCB_t *pxCurrentTCB;
 
+/**
+ * 初始化任务栈
+ */
+StackType_t *htPortInitialiseStack(StackType_t *pxTopOfStack, void (*pxCode)(void *), void *pvParameters)
+{
+    // 确保8字节对齐
+    pxTopOfStack = (StackType_t *)((((uint32_t)pxTopOfStack) & ~0x7UL));
+
+    // 首先清零整个栈区域
+    memset((void *)((uint32_t)pxTopOfStack - 64), 0, 64);
+
+    // 构建异常框架 - 从底向上
+    *(--pxTopOfStack) = 0x01000000; /* xPSR - T位置位 */
+    *(--pxTopOfStack) = ((uint32_t)pxCode) | 1UL; /* PC指向任务函数，强制设置LSB确保Thumb模式 */
+    *(--pxTopOfStack) = 0xFFFFFFFEUL; /* LR - 异常返回标记 */
+    *(--pxTopOfStack) = 0; /* R12 */
+    *(--pxTopOfStack) = 0; /* R3 */
+    *(--pxTopOfStack) = 0; /* R2 */
+    *(--pxTopOfStack) = 0; /* R1 */
+    *(--pxTopOfStack) = (uint32_t)pvParameters; /* R0 - 任务参数 */
+
+    // 构建软件保存的寄存器
+    *(--pxTopOfStack) = 0; /* R11 */
+    *(--pxTopOfStack) = 0; /* R10 */
+    *(--pxTopOfStack) = 0; /* R9 */
+    *(--pxTopOfStack) = 0; /* R8 */
+    *(--pxTopOfStack) = 0; /* R7 */
+    *(--pxTopOfStack) = 0; /* R6 */
+    *(--pxTopOfStack) = 0; /* R5 */
+    *(--pxTopOfStack) = 0; /* R4 */
+
+    // 打印任务栈配置信息 (使用英文避免编码问题)
+    printf("Task stack setup: PC=0x%08lx (with Thumb bit), Param=0x%08lx, SP=%p\r\n", ((uint32_t)pxCode) | 1UL,
+            (uint32_t)pvParameters, pxTopOfStack);
+
+    return pxTopOfStack;
+}
+
+/**
+ * 启动调度器
+ */
+BaseType_t htPortStartScheduler(void)
+{
+    // 设置关键中断优先级，NVIC_SetPriority()的参数是优先级编号，需要从BASEPRI格式换算
+    NVIC_SetPriority(PendSV_IRQn, htPortPriorityToNVIC(configKERNEL_INTERRUPT_PRIORITY)); // 最低优先级
+    NVIC_SetPriority(SysTick_IRQn, htPortPriorityToNVIC(htPORT_SYSTICK_PRIORITY)); // 在内核可屏蔽范围内
+
+    /* 重置临界区嵌套计数器 */
+    uxCriticalNesting = 0;
+
+    // 确保所有中断已正确配置
+    __enable_irq();
+    __DSB();
+    __ISB();
+
+    /* 启动第一个任务 - 这个函数通常不会返回 */
+    htPortStartFirstTask();
+
+    /* 如果到达这里，说明启动失败 */
+    return htFAIL;
+}
+
+/**
+ * 停止调度器
+ */
+void htPortEndScheduler(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    __disable_irq();
+    for (;;) {
+    }
+}
+
 /**
  * Simplified first task start function - using Keil assembly style
  */
@@ -100,68 +176,49 @@ __asm void PendSV_Handler(void)
     /* 确保我们的LR在返回时包含异常返回值 */
     mov r0, lr
 
-    /* 禁用中断以保持原子性 */
-    cpsid i
+    /* 屏蔽可调用内核API的中断以保持原子性，更高优先级的中断不受影响 */
+    mov r0, #configMAX_SYSCALL_INTERRUPT_PRIORITY
+    msr basepri, r0
+    dsb
+    isb
 
     /* 检查pxCurrentTCB是否为NULL */
     ldr r3, =pxCurrentTCB
     ldr r2, [r3]
     cbz r2, PendSV_NoSave
 
-    /* 保存上下文: 获取当前任务栈顶 */
+    /* 保存上下文: 获取当前任务栈顶，保存核心寄存器 */
     mrs r1, psp
-
-    /* 检查栈地址有效性：必须在0x20000000-0x20200000范围内 */
-    ldr r12, =0x20000000
-    cmp r1, r12
-    blt PendSV_StackError
-
-    ldr r12, =0x20200000
-    cmp r1, r12
-    bge PendSV_StackError
-
-    /* 栈地址有效，保存核心寄存器 */
     stmdb r1!, {r4-r11}
 
-    /* 将更新后的栈指针保存回TCB */
+    /* 将更新后的栈指针保存回TCB，htTaskSwitchContext()按TCB中的栈区检查是否溢出 */
     str r1, [r2]
 
 PendSV_NoSave
-    /* 保证安全的上下文切换 */
-    push {r3, lr}
+    /* 保证安全的上下文切换，r2保留切换前的TCB，r12只用于保持8字节对齐 */
+    push {r2, r3, r12, lr}
     bl htTaskSwitchContext
-    pop {r3, lr}
+    pop {r2, r3, r12, lr}
 
     /* 获取新的当前任务 */
     ldr r1, [r3]
     cbz r1, PendSV_Exit
 
-    /* 加载新任务栈 */
-    ldr r0, [r1]
-
-    /* 检查栈地址有效性 */
-    ldr r12, =0x20000000
-    cmp r0, r12
-    blt PendSV_StackError
-
-    ldr r12, =0x20200000
-    cmp r0, r12
-    bge PendSV_StackError
+    /* 选中的仍是原任务：r4-r11和PSP都没有改动，不必恢复，直接返回 */
+    cmp r1, r2
+    beq PendSV_Exit
 
-    /* 栈地址有效，恢复核心寄存器 */
+    /* 加载新任务栈，恢复核心寄存器 */
+    ldr r0, [r1]
     ldmia r0!, {r4-r11}
 
-    /* 更新进程栈指针 */
+    /* 更新进程栈指针，返回线程模式时由EXC_RETURN选择PSP，不需要再写CONTROL */
     msr psp, r0
 
-    /* 确保使用PSP */
-    mov r0, #2
-    msr control, r0
-    isb
-
 PendSV_Exit
     /* 重新启用中断 */
-    cpsie i
+    mov r0, #0
+    msr basepri, r0
 
     /* 确保返回使用进程栈 */
     orr lr, lr, #0xD
@@ -169,16 +226,7 @@ PendSV_Exit
     /* 返回到线程模式 */
     bx lr
 
-PendSV_StackError
-    /* 栈地址无效 - 使用长跳转方式而不是直接跳转 */
-    mov r0, #0
-    mov r1, #0
-    mov r2, #0
-
-    /* 使用LDR + BX序列而不是直接B指令 */
-    ldr r12, =HardFault_Handler_C
-    bx r12
-		nop
+    nop
 }
 
 /**
@@ -255,3 +303,103 @@ __asm void HardFault_Handler(void)
     b HardFault_Handler_C   /* Jump to C handler */
 }
 
+
+#if configUSE_TICKLESS_IDLE == 1
+/**
+ * 无滴答空闲 - 把SysTick重装值改为一次长睡眠，WFI醒来后补偿tick
+ * SysTick为24位计数器，单次最长睡眠 0xFFFFFF / 每tick计数 个tick
+ */
+void htPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    const uint32_t ulCountsPerTick = SystemCoreClock / configTICK_RATE_HZ;
+    const uint32_t ulMaxSuppressedTicks = 0xFFFFFFUL / ulCountsPerTick;
+    uint32_t ulReloadValue;
+    uint32_t ulCompleteTickPeriods;
+    uint32_t ulCompletedDecrements;
+
+    if (xExpectedIdleTime > ulMaxSuppressedTicks) {
+        xExpectedIdleTime = ulMaxSuppressedTicks;
+    }
+
+    /* 停止SysTick，本tick剩余计数 + 其余整tick计数即为新的重装值 */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    ulReloadValue = SysTick->VAL + (ulCountsPerTick * (xExpectedIdleTime - 1UL));
+
+    /* 这里必须用PRIMASK关中断而不是htEnterCritical()：被BASEPRI屏蔽的中断不能把内核从WFI唤醒，
+     * 滴答和外设中断都在屏蔽范围内。htTaskStepTick()内部的临界区只改BASEPRI，不会提前开中断 */
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (htTaskConfirmSleepModeStatus() == htFALSE) {
+        /* 计算之后有任务就绪，放弃睡眠：用剩余计数继续当前tick */
+        SysTick->LOAD = SysTick->VAL;
+        SysTick->VAL = 0UL;
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        SysTick->LOAD = ulCountsPerTick - 1UL;
+        __enable_irq();
+        return;
+    }
+
+    SysTick->LOAD = ulReloadValue;
+    SysTick->VAL = 0UL;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    /* 短暂开中断让唤醒源的中断先执行；若是SysTick到期，它会计入最后一个tick */
+    __enable_irq();
+    __DSB();
+    __ISB();
+    __disable_irq();
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0UL) {
+        /* SysTick到期唤醒，滴答中断已计入1个tick，本周期剩余计数继续作为下一个tick */
+        uint32_t ulCalculatedLoadValue = (ulCountsPerTick - 1UL) - (ulReloadValue - SysTick->VAL);
+
+        if (ulCalculatedLoadValue > ulCountsPerTick) {
+            ulCalculatedLoadValue = ulCountsPerTick - 1UL;
+        }
+        SysTick->LOAD = ulCalculatedLoadValue;
+        ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
+    } else {
+        /* 其他中断提前唤醒，按已经走过的计数折算整tick数 */
+        ulCompletedDecrements = (xExpectedIdleTime * ulCountsPerTick) - SysTick->VAL;
+        ulCompleteTickPeriods = ulCompletedDecrements / ulCountsPerTick;
+        SysTick->LOAD = ((ulCompleteTickPeriods + 1UL) * ulCountsPerTick) - ulCompletedDecrements;
+    }
+
+    /* 用调整后的重装值跑完当前tick，之后恢复每tick一次中断 */
+    SysTick->VAL = 0UL;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+#if configGENERATE_RUN_TIME_STATS == 1
+    /* WFI期间内核时钟停止，周期计数器不走，把睡掉的整tick补给空闲任务 */
+    DWT->CYCCNT += ulCompleteTickPeriods * ulCountsPerTick;
+#endif
+    htTaskStepTick(ulCompleteTickPeriods);
+    SysTick->LOAD = ulCountsPerTick - 1UL;
+
+    __enable_irq();
+}
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if configGENERATE_RUN_TIME_STATS == 1
+/**
+ * 运行时间统计计数器 - 使用DWT周期计数器，72MHz下约60秒回绕一次
+ */
+void htPortConfigureRunTimeCounter(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t htPortGetRunTimeCounter(void)
+{
+    return DWT->CYCCNT;
+}
+#endif /* configGENERATE_RUN_TIME_STATS */
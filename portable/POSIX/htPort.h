@@ -0,0 +1,85 @@
+/**
+ * @file htPort.h
+ * @brief POSIX 主机移植层定义 - 整个内核作为一个Linux进程运行
+ *
+ * - 任务切换：每个任务一个ucontext，运行在独立的主机栈上（内核分配的任务栈只用于保存上下文指针）
+ * - 滴答：ITIMER_REAL定时器产生的SIGALRM，信号处理函数相当于SysTick中断
+ * - 中断屏蔽：屏蔽SIGALRM；中断屏蔽期间请求的任务切换推迟到开中断时执行，与PendSV一致
+ * - htTaskEndScheduler()之后htStartScheduler()返回到调用者，便于测试和性能回归
+ *
+ * 仿真模式(htPORT_SIMULATION=1，接口见htSim.h)：不使用SIGALRM，tick只在所有任务都阻塞、
+ * 空闲任务运行时前进，并直接跳到下一个到期事件；中断只能由脚本在指定tick注入，
+ * 每次调度决策都被记录，同一场景每次运行结果完全一致。
+ *
+ * 所有任务运行在同一个主机线程中，任务代码里调用printf等非异步信号安全的库函数时，
+ * 被滴答抢占后切到另一个也在使用同一函数的任务可能出错，测试任务应尽量少做此类调用。
+ */
+#ifndef HT_PORT_H
+#define HT_PORT_H
+
+#include <stdint.h>
+#include "httypes.h"
+
+/* 虚拟时间仿真模式 */
+#ifndef htPORT_SIMULATION
+#define htPORT_SIMULATION 0
+#endif
+
+/* 每个任务的主机栈大小(字节)，与内核的usStackDepth无关 */
+#ifndef htPORT_HOST_STACK_SIZE
+#define htPORT_HOST_STACK_SIZE (256 * 1024)
+#endif
+
+/* 中断屏蔽：屏蔽/解除屏蔽滴答信号，在滴答处理函数中调用时不起作用 */
+void htPortDisableInterrupts(void);
+void htPortEnableInterrupts(void);
+
+/**
+ * 中断中屏蔽，供FromISR接口使用；在任务中调用时与htPortDisableInterrupts()相同
+ * @return 调用前是否已屏蔽，传给htPortClearInterruptMaskFromISR()
+ */
+UBaseType_t htPortSetInterruptMaskFromISR(void);
+void htPortClearInterruptMaskFromISR(UBaseType_t uxSaved);
+
+/**
+ * 原子比较交换：*puxTarget等于uxExpected时改为uxNew，用C11内存模型的__atomic内建函数实现
+ * @return 交换成功返回htTRUE
+ */
+static inline BaseType_t htPortCompareAndSwap(volatile uintptr_t *puxTarget, uintptr_t uxExpected, uintptr_t uxNew)
+{
+    return __atomic_compare_exchange_n(puxTarget, &uxExpected, uxNew, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ?
+        htTRUE : htFALSE;
+}
+
+/* 请求任务切换：中断开着时立即切换，否则推迟到开中断或滴答处理结束时 */
+void htPortYield(void);
+
+/**
+ * 为任务分配主机栈和上下文，上下文指针保存在内核任务栈顶
+ * @param pxTopOfStack 任务栈最高地址处的字
+ * @param pxCode 任务函数
+ * @param pvParameters 任务参数
+ * @return 保存到TCB的栈指针
+ */
+StackType_t *htPortInitialiseStack(StackType_t *pxTopOfStack, void (*pxCode)(void *), void *pvParameters);
+
+/* 释放htPortInitialiseStack()分配的主机栈，不能用于正在运行的任务 */
+void htPortReleaseStack(StackType_t *pxTopOfStack);
+
+/**
+ * 启动滴答定时器并切到pxCurrentTCB
+ * @return 任务调用htTaskEndScheduler()之后返回htPASS
+ */
+BaseType_t htPortStartScheduler(void);
+
+/* 停止滴答定时器并回到htPortStartScheduler()的调用者 */
+void htPortEndScheduler(void);
+
+/* 无滴答空闲：停掉定时器睡眠，醒来后按实际流逝时间补偿tick；仿真模式下推进虚拟时钟 */
+void htPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+
+/* 运行时间统计计数器：单调时钟，单位微秒；仿真模式下为虚拟tick数 */
+void htPortConfigureRunTimeCounter(void);
+uint32_t htPortGetRunTimeCounter(void);
+
+#endif /* HT_PORT_H */
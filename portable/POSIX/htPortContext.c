@@ -0,0 +1,547 @@
+/**
+ * @file htPortContext.c
+ * @brief POSIX 主机移植层 - ucontext任务切换、SIGALRM滴答、信号屏蔽模拟中断屏蔽
+ *
+ * htPORT_SIMULATION=1时不安装滴答信号，由空闲任务推进虚拟时钟并注入脚本中断，见htSim.h
+ */
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include "httask.h"
+#include "htscheduler.h"
+#include "htPort.h"
+#include "htSim.h"
+
+#if htPORT_SIMULATION == 1 && (configUSE_TICKLESS_IDLE != 1 || configEXPECTED_IDLE_TIME_BEFORE_SLEEP != 1)
+#error "htPORT_SIMULATION requires configUSE_TICKLESS_IDLE=1 and configEXPECTED_IDLE_TIME_BEFORE_SLEEP=1"
+#endif
+
+/* 模拟SysTick的信号 */
+#define htPORT_TICK_SIGNAL SIGALRM
+
+/* 每个任务的主机上下文，和它的主机栈放在同一块映射内存的开头 */
+typedef struct htPortContext {
+    ucontext_t xContext; /* 保存的寄存器和信号屏蔽字 */
+    void (*pxCode)(void *); /* 任务函数 */
+    void *pvParameters; /* 任务参数 */
+    size_t uxMapSize; /* 映射内存大小 */
+} htPortContext_t;
+
+/* 内核任务栈顶保存的上下文指针 */
+#define prvContextOf(pxTCB) (*(htPortContext_t **)((pxTCB)->pxTopOfStack))
+
+/* htPortStartScheduler()调用者的上下文，停止调度器时回到这里 */
+static ucontext_t xSchedulerContext;
+/* 正在执行滴答处理函数 */
+static volatile sig_atomic_t xInInterrupt = 0;
+/* 任务代码屏蔽了中断 */
+static volatile sig_atomic_t xInterruptsMasked = 0;
+/* 有推迟的任务切换，相当于挂起的PendSV */
+static volatile sig_atomic_t xSwitchPending = 0;
+
+#if htPORT_SIMULATION == 1
+/* 脚本中断 */
+typedef struct htSimISREntry {
+    TickType_t xTick; /* 注入时刻 */
+    htSimISR_t pxHandler; /* 处理函数 */
+    void *pvParameter; /* 参数 */
+    UBaseType_t uxId; /* 登记顺序号 */
+} htSimISREntry_t;
+
+/* 按注入时刻排序的待执行中断，同一时刻按登记顺序 */
+static htSimISREntry_t xSimISRs[htSIM_MAX_ISRS];
+static UBaseType_t uxSimISRCount = 0;
+static UBaseType_t uxSimISRNextId = 0;
+static TickType_t xSimEndTick = 0;
+static htSimEvent_t xSimTrace[htSIM_TRACE_LENGTH];
+static UBaseType_t uxSimTraceCount = 0;
+
+/* xTime是否晚于xNow，按回绕安全的方式比较 */
+static BaseType_t prvTimeIsAfter(TickType_t xTime, TickType_t xNow)
+{
+    return ((TickType_t)(xTime - xNow - 1U) < 0x7FFFFFFFUL) ? htTRUE : htFALSE;
+}
+
+static void prvSimRecord(UBaseType_t uxType, htTCB_t *pxFrom, htTCB_t *pxTo, UBaseType_t uxId)
+{
+    htSimEvent_t *pxEvent;
+
+    if (uxSimTraceCount >= htSIM_TRACE_LENGTH) {
+        return;
+    }
+
+    pxEvent = &xSimTrace[uxSimTraceCount++];
+    pxEvent->xTick = xTickCount;
+    pxEvent->uxType = uxType;
+    pxEvent->xFrom = (TaskHandle_t)pxFrom;
+    pxEvent->xTo = (TaskHandle_t)pxTo;
+    pxEvent->uxId = uxId;
+}
+#endif /* htPORT_SIMULATION */
+
+static void prvTickSignalSet(sigset_t *pxSet)
+{
+    sigemptyset(pxSet);
+    sigaddset(pxSet, htPORT_TICK_SIGNAL);
+}
+
+/**
+ * 任务切换：选出下一个任务并切换主机上下文
+ * 必须在滴答信号被屏蔽时调用；被切出的任务从swapcontext()返回时继续运行
+ */
+static void prvSwitchContext(void)
+{
+    htTCB_t *pxPrevious = pxCurrentTCB;
+
+    xSwitchPending = 0;
+    htTaskSwitchContext();
+
+    if (pxCurrentTCB != pxPrevious) {
+#if htPORT_SIMULATION == 1
+        prvSimRecord(htSIM_EVENT_SWITCH, pxPrevious, pxCurrentTCB, 0);
+#endif
+        (void)swapcontext(&(prvContextOf(pxPrevious)->xContext), &(prvContextOf(pxCurrentTCB)->xContext));
+    }
+}
+
+/**
+ * 模拟SysTick中断
+ * 处理结束时执行滴答中请求的任务切换；被切出的任务之后从这里返回，信号屏蔽字随之恢复
+ */
+static void prvTickHandler(int iSignal)
+{
+    (void)iSignal;
+
+    xInInterrupt = 1;
+    htTaskTickInc();
+    xInInterrupt = 0;
+
+    if (xSwitchPending) {
+        xInterruptsMasked = 1;
+        prvSwitchContext();
+        xInterruptsMasked = 0;
+    }
+}
+
+/**
+ * 所有任务的入口
+ * 新任务以屏蔽中断的状态切入，先开中断再调用任务函数，任务函数返回时删除任务
+ */
+static void prvTaskEntry(void)
+{
+    htPortContext_t *pxContext = prvContextOf(pxCurrentTCB);
+
+    htPortEnableInterrupts();
+    pxContext->pxCode(pxContext->pvParameters);
+    htTaskDelete(NULL);
+}
+
+void htPortDisableInterrupts(void)
+{
+    sigset_t xSet;
+
+    if (xInInterrupt) {
+        return;
+    }
+
+    prvTickSignalSet(&xSet);
+    (void)sigprocmask(SIG_BLOCK, &xSet, NULL);
+    xInterruptsMasked = 1;
+}
+
+void htPortEnableInterrupts(void)
+{
+    sigset_t xSet;
+
+    if (xInInterrupt) {
+        return;
+    }
+
+    /* 与Cortex-M上挂起的PendSV一样，开中断前先完成被推迟的任务切换 */
+    while (xSwitchPending) {
+        prvSwitchContext();
+    }
+
+    xInterruptsMasked = 0;
+    prvTickSignalSet(&xSet);
+    (void)sigprocmask(SIG_UNBLOCK, &xSet, NULL);
+}
+
+UBaseType_t htPortSetInterruptMaskFromISR(void)
+{
+    UBaseType_t uxWasMasked = (UBaseType_t)xInterruptsMasked;
+
+    htPortDisableInterrupts();
+
+    return uxWasMasked;
+}
+
+void htPortClearInterruptMaskFromISR(UBaseType_t uxSaved)
+{
+    /* 调用前已屏蔽时保持屏蔽，由外层负责恢复 */
+    if (uxSaved == 0) {
+        htPortEnableInterrupts();
+    }
+}
+
+void htPortYield(void)
+{
+    xSwitchPending = 1;
+
+    if (xInInterrupt || xInterruptsMasked) {
+        return;
+    }
+
+    htPortDisableInterrupts();
+    htPortEnableInterrupts();
+}
+
+/**
+ * 初始化任务栈
+ */
+StackType_t *htPortInitialiseStack(StackType_t *pxTopOfStack, void (*pxCode)(void *), void *pvParameters)
+{
+    const size_t uxHeaderSize = (sizeof(htPortContext_t) + 15U) & ~(size_t)15U;
+    const size_t uxMapSize = uxHeaderSize + htPORT_HOST_STACK_SIZE;
+    htPortContext_t *pxContext;
+    void *pvMap;
+
+    pvMap = mmap(NULL, uxMapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (pvMap == MAP_FAILED) {
+        fprintf(stderr, "htPortInitialiseStack: cannot map %lu bytes for task stack\n", (unsigned long)uxMapSize);
+        abort();
+    }
+
+    pxContext = (htPortContext_t *)pvMap;
+    pxContext->pxCode = pxCode;
+    pxContext->pvParameters = pvParameters;
+    pxContext->uxMapSize = uxMapSize;
+
+    (void)getcontext(&(pxContext->xContext));
+    pxContext->xContext.uc_stack.ss_sp = (char *)pvMap + uxHeaderSize;
+    pxContext->xContext.uc_stack.ss_size = htPORT_HOST_STACK_SIZE;
+    pxContext->xContext.uc_link = NULL;
+    /* 以屏蔽滴答的状态切入，由prvTaskEntry()在新栈上开中断，切换过程中不会被滴答打断 */
+    sigaddset(&(pxContext->xContext.uc_sigmask), htPORT_TICK_SIGNAL);
+    makecontext(&(pxContext->xContext), prvTaskEntry, 0);
+
+    /* 在内核任务栈顶保存上下文指针 */
+    pxTopOfStack = (StackType_t *)(((uintptr_t)(pxTopOfStack + 1) - sizeof(htPortContext_t *)) &
+            ~(uintptr_t)(sizeof(htPortContext_t *) - 1U));
+    *(htPortContext_t **)pxTopOfStack = pxContext;
+
+    return pxTopOfStack;
+}
+
+void htPortReleaseStack(StackType_t *pxTopOfStack)
+{
+    htPortContext_t *pxContext = *(htPortContext_t **)pxTopOfStack;
+
+    if (pxCurrentTCB != NULL && pxCurrentTCB->pxTopOfStack == pxTopOfStack) {
+        return;
+    }
+
+    (void)munmap(pxContext, pxContext->uxMapSize);
+}
+
+/**
+ * 启动调度器
+ */
+BaseType_t htPortStartScheduler(void)
+{
+    struct sigaction xAction;
+    struct sigaction xOldAction;
+    struct itimerval xTimer;
+    sigset_t xSet;
+    sigset_t xOldMask;
+
+    prvTickSignalSet(&xSet);
+    (void)sigprocmask(SIG_BLOCK, &xSet, &xOldMask);
+
+    memset(&xAction, 0, sizeof(xAction));
+    xAction.sa_handler = prvTickHandler;
+    xAction.sa_flags = SA_RESTART;
+    sigemptyset(&xAction.sa_mask);
+    (void)sigaction(htPORT_TICK_SIGNAL, &xAction, &xOldAction);
+
+    uxCriticalNesting = 0;
+    xInInterrupt = 0;
+    xInterruptsMasked = 1;
+    xSwitchPending = 0;
+
+    memset(&xTimer, 0, sizeof(xTimer));
+#if htPORT_SIMULATION == 1
+    /* 虚拟时钟只由空闲任务推进，不启动滴答定时器 */
+    prvSimRecord(htSIM_EVENT_SWITCH, NULL, pxCurrentTCB, 0);
+#else
+    xTimer.it_interval.tv_usec = 1000000 / configTICK_RATE_HZ;
+    xTimer.it_value = xTimer.it_interval;
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+#endif
+
+    /* 切到第一个任务，htPortEndScheduler()之后从这里返回 */
+    (void)swapcontext(&xSchedulerContext, &(prvContextOf(pxCurrentTCB)->xContext));
+
+    memset(&xTimer, 0, sizeof(xTimer));
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+    (void)sigaction(htPORT_TICK_SIGNAL, &xOldAction, NULL);
+    xInterruptsMasked = 0;
+    (void)sigprocmask(SIG_SETMASK, &xOldMask, NULL);
+
+    return htPASS;
+}
+
+/**
+ * 停止调度器
+ * 各任务的主机栈不释放，测试应在子进程中运行每个调度场景
+ */
+void htPortEndScheduler(void)
+{
+    struct itimerval xTimer;
+
+    htPortDisableInterrupts();
+    memset(&xTimer, 0, sizeof(xTimer));
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+    (void)setcontext(&xSchedulerContext);
+}
+
+#if htPORT_SIMULATION == 1
+/**
+ * 执行所有注入时刻不晚于当前tick的脚本中断
+ * 在模拟的中断上下文中运行，请求的任务切换记为挂起，由调用者处理
+ */
+static void prvSimRunDueISRs(void)
+{
+    htSimISREntry_t xEntry;
+    UBaseType_t i;
+
+    while (uxSimISRCount > 0 && prvTimeIsAfter(xSimISRs[0].xTick, xTickCount) == htFALSE) {
+        xEntry = xSimISRs[0];
+        uxSimISRCount--;
+        for (i = 0; i < uxSimISRCount; i++) {
+            xSimISRs[i] = xSimISRs[i + 1U];
+        }
+
+        prvSimRecord(htSIM_EVENT_ISR, NULL, NULL, xEntry.uxId);
+        xInInterrupt = 1;
+        xEntry.pxHandler(xEntry.pvParameter);
+        xInInterrupt = 0;
+    }
+}
+
+/**
+ * 推进虚拟时钟 - 空闲任务在挂起调度器的状态下调用
+ * 跳到最早的延时到期、脚本中断或结束时刻中最近的一个，中间的tick一次补偿，
+ * 最后一个tick走滴答中断路径，随后执行到期的脚本中断。
+ * 中断请求的切换因调度器挂起而记为xYieldPending，空闲任务恢复调度器时完成切换。
+ */
+void htPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    TickType_t xAdvance = xExpectedIdleTime;
+    TickType_t xUntilISR;
+
+    if (uxSimISRCount > 0) {
+        /* 时刻已过的中断立即执行 */
+        xUntilISR = (prvTimeIsAfter(xSimISRs[0].xTick, xTickCount) == htTRUE) ? (xSimISRs[0].xTick - xTickCount) : 0;
+        if (xUntilISR < xAdvance) {
+            xAdvance = xUntilISR;
+        }
+    }
+
+    if (xSimEndTick != 0) {
+        if (prvTimeIsAfter(xSimEndTick, xTickCount) == htFALSE) {
+            prvSimRecord(htSIM_EVENT_END, NULL, NULL, 0);
+            htPortEndScheduler();
+        }
+        if (xSimEndTick - xTickCount < xAdvance) {
+            xAdvance = xSimEndTick - xTickCount;
+        }
+    }
+
+    if (xAdvance == htBLOCKED_INDEFINITELY) {
+        /* 所有任务都无限期阻塞，也没有待注入的中断 */
+        prvSimRecord(htSIM_EVENT_END, NULL, NULL, 0);
+        htPortEndScheduler();
+    }
+
+    if (xAdvance > 1U) {
+        htTaskStepTick(xAdvance - 1U);
+    }
+
+    htPortDisableInterrupts();
+    if (xAdvance > 0U) {
+        xInInterrupt = 1;
+        htTaskTickInc();
+        xInInterrupt = 0;
+    }
+    prvSimRunDueISRs();
+    htPortEnableInterrupts();
+}
+
+/**
+ * 当前任务占用CPU n个虚拟tick
+ * 每个tick走滴答中断路径，随后执行到期的脚本中断；开中断时完成其中请求的切换，
+ * 任务被抢占或时间片用完时剩余的tick等它再次运行后继续消耗
+ */
+void htSimBusy(TickType_t xTicks)
+{
+    while (xTicks > 0U) {
+        htPortDisableInterrupts();
+        if (xSimEndTick != 0 && prvTimeIsAfter(xSimEndTick, xTickCount) == htFALSE) {
+            /* 一直有任务在运行时空闲任务不会检查结束时刻 */
+            prvSimRecord(htSIM_EVENT_END, NULL, NULL, 0);
+            htPortEndScheduler();
+        }
+        xInInterrupt = 1;
+        htTaskTickInc();
+        xInInterrupt = 0;
+        prvSimRunDueISRs();
+        htPortEnableInterrupts();
+        xTicks--;
+    }
+}
+
+/**
+ * 登记脚本中断
+ */
+BaseType_t htSimScheduleISR(TickType_t xTick, htSimISR_t pxHandler, void *pvParameter)
+{
+    UBaseType_t i;
+
+    htPortDisableInterrupts();
+    if (uxSimISRCount >= htSIM_MAX_ISRS) {
+        htPortEnableInterrupts();
+        return htFAIL;
+    }
+
+    /* 插在所有时刻不晚于它的中断之后 */
+    for (i = uxSimISRCount; i > 0 && prvTimeIsAfter(xSimISRs[i - 1U].xTick, xTick) == htTRUE; i--) {
+        xSimISRs[i] = xSimISRs[i - 1U];
+    }
+    xSimISRs[i].xTick = xTick;
+    xSimISRs[i].pxHandler = pxHandler;
+    xSimISRs[i].pvParameter = pvParameter;
+    xSimISRs[i].uxId = uxSimISRNextId++;
+    uxSimISRCount++;
+    htPortEnableInterrupts();
+
+    return htPASS;
+}
+
+/**
+ * 设置结束时刻
+ */
+void htSimSetEndTick(TickType_t xEndTick)
+{
+    xSimEndTick = xEndTick;
+}
+
+/**
+ * 获取跟踪记录
+ */
+UBaseType_t htSimGetTrace(const htSimEvent_t **ppxEvents)
+{
+    *ppxEvents = xSimTrace;
+    return uxSimTraceCount;
+}
+
+/**
+ * 打印跟踪记录
+ */
+void htSimPrintTrace(void)
+{
+    const htSimEvent_t *pxEvent;
+    UBaseType_t i;
+
+    for (i = 0; i < uxSimTraceCount; i++) {
+        pxEvent = &xSimTrace[i];
+        switch (pxEvent->uxType) {
+        case htSIM_EVENT_SWITCH:
+            printf("%10lu  switch %s -> %s\n", (unsigned long)pxEvent->xTick,
+                (pxEvent->xFrom != NULL) ? ((htTCB_t *)pxEvent->xFrom)->pcTaskName : "-",
+                ((htTCB_t *)pxEvent->xTo)->pcTaskName);
+            break;
+        case htSIM_EVENT_ISR:
+            printf("%10lu  isr    #%lu\n", (unsigned long)pxEvent->xTick, (unsigned long)pxEvent->uxId);
+            break;
+        default:
+            printf("%10lu  end\n", (unsigned long)pxEvent->xTick);
+            break;
+        }
+    }
+}
+
+#elif configUSE_TICKLESS_IDLE == 1
+/**
+ * 无滴答空闲 - 停掉定时器睡够预计时间，按单调时钟实际流逝的整tick数补偿
+ */
+void htPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    const long lTickNanoseconds = 1000000000L / configTICK_RATE_HZ;
+    struct itimerval xTimer;
+    struct timespec xStart;
+    struct timespec xEnd;
+    struct timespec xSleep;
+    long long llElapsed;
+    TickType_t xCompleteTicks;
+
+    htEnterCritical();
+    if (htTaskConfirmSleepModeStatus() == htFALSE) {
+        htExitCritical();
+        return;
+    }
+
+    memset(&xTimer, 0, sizeof(xTimer));
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+
+    xSleep.tv_sec = (time_t)(((long long)xExpectedIdleTime * lTickNanoseconds) / 1000000000LL);
+    xSleep.tv_nsec = (long)(((long long)xExpectedIdleTime * lTickNanoseconds) % 1000000000LL);
+    (void)clock_gettime(CLOCK_MONOTONIC, &xStart);
+    (void)nanosleep(&xSleep, NULL);
+    (void)clock_gettime(CLOCK_MONOTONIC, &xEnd);
+
+    llElapsed = (long long)(xEnd.tv_sec - xStart.tv_sec) * 1000000000LL + (xEnd.tv_nsec - xStart.tv_nsec);
+    xCompleteTicks = (TickType_t)(llElapsed / lTickNanoseconds);
+    if (xCompleteTicks > xExpectedIdleTime) {
+        xCompleteTicks = xExpectedIdleTime;
+    }
+    if (xCompleteTicks > 0) {
+        htTaskStepTick(xCompleteTicks);
+    }
+
+    xTimer.it_interval.tv_usec = 1000000 / configTICK_RATE_HZ;
+    xTimer.it_value = xTimer.it_interval;
+    (void)setitimer(ITIMER_REAL, &xTimer, NULL);
+
+    htExitCritical();
+}
+#endif /* htPORT_SIMULATION / configUSE_TICKLESS_IDLE */
+
+#if configGENERATE_RUN_TIME_STATS == 1
+/**
+ * 运行时间统计计数器 - 单调时钟的微秒数，约71分钟回绕一次
+ * 仿真模式下任务代码不消耗虚拟时间，计数器取虚拟tick数，统计结果同样可重复
+ */
+void htPortConfigureRunTimeCounter(void)
+{
+}
+
+uint32_t htPortGetRunTimeCounter(void)
+{
+#if htPORT_SIMULATION == 1
+    return (uint32_t)xTickCount;
+#else
+    struct timespec xNow;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &xNow);
+
+    return (uint32_t)((uint64_t)xNow.tv_sec * 1000000U + (uint64_t)xNow.tv_nsec / 1000U);
+#endif
+}
+#endif /* configGENERATE_RUN_TIME_STATS */
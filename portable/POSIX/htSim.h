@@ -0,0 +1,82 @@
+/**
+ * @file htSim.h
+ * @brief 虚拟时间调度仿真 - POSIX移植层的确定性运行模式
+ *
+ * 以 htPORT_SIMULATION=1、configUSE_TICKLESS_IDLE=1、configEXPECTED_IDLE_TIME_BEFORE_SLEEP=1
+ * 编译内核和移植层后：
+ * - 任务代码不消耗虚拟时间，只有所有任务都阻塞时空闲任务才推进时钟，
+ *   并一次跳到最早的延时到期或脚本中断时刻，仿真数小时只需数毫秒
+ * - 需要占用CPU的任务调用htSimBusy()逐tick消耗虚拟时间，期间按真实滴答处理抢占和时间片轮转
+ * - 推进的最后一个tick按真实滴答中断处理(htTaskTickInc)，之后依次执行该时刻的脚本中断，
+ *   中断里可以调用FromISR接口，请求的任务切换在中断结束后发生
+ * - 每次任务切换和中断都记录在跟踪缓冲区中，可逐条断言，也可整体比较两次运行是否一致
+ * - 所有任务都无限期阻塞且没有待注入的中断，或虚拟时间到达结束时刻时，htOSStart()返回
+ *
+ * 处于空闲优先级的用户任务得不到运行(空闲任务推进时钟前不让出)，场景中的任务应使用更高的优先级。
+ */
+#ifndef HT_SIM_H
+#define HT_SIM_H
+
+#include "httypes.h"
+
+/* 跟踪缓冲区容量(条)，写满后丢弃之后的记录 */
+#ifndef htSIM_TRACE_LENGTH
+#define htSIM_TRACE_LENGTH 1024
+#endif
+
+/* 最多可登记的脚本中断数 */
+#ifndef htSIM_MAX_ISRS
+#define htSIM_MAX_ISRS 64
+#endif
+
+/* 跟踪事件类型 */
+#define htSIM_EVENT_SWITCH 0 /* 任务切换：xFrom -> xTo，调度器启动时xFrom为NULL */
+#define htSIM_EVENT_ISR 1 /* 执行脚本中断，uxId为登记顺序号 */
+#define htSIM_EVENT_END 2 /* 仿真结束 */
+
+/* 跟踪事件 */
+typedef struct htSimEvent {
+    TickType_t xTick; /* 发生时的虚拟tick */
+    UBaseType_t uxType; /* htSIM_EVENT_xxx */
+    TaskHandle_t xFrom; /* 切出的任务 */
+    TaskHandle_t xTo; /* 切入的任务 */
+    UBaseType_t uxId; /* 中断登记号 */
+} htSimEvent_t;
+
+/* 脚本中断处理函数，在模拟的中断上下文中执行 */
+typedef void (*htSimISR_t)(void *pvParameter);
+
+/**
+ * 登记一次脚本中断，可在htOSStart()之前或任务/中断中调用
+ * 同一时刻的多个中断按登记顺序执行；时刻已过的中断在下一次空闲时立即执行
+ * @param xTick 注入时刻(虚拟tick)
+ * @param pxHandler 中断处理函数
+ * @param pvParameter 传给处理函数的参数
+ * @return htPASS表示登记成功，中断表已满返回htFAIL
+ */
+BaseType_t htSimScheduleISR(TickType_t xTick, htSimISR_t pxHandler, void *pvParameter);
+
+/**
+ * 当前任务占用CPU xTicks个虚拟tick，只能在任务中调用
+ * 每个tick按滴答中断处理并执行到期的脚本中断，任务可能因此被抢占或轮转出去，
+ * 只有本任务运行的tick计入xTicks；虚拟时间到达结束时刻时结束仿真
+ */
+void htSimBusy(TickType_t xTicks);
+
+/**
+ * 设置结束时刻：虚拟时间到达该tick且所有任务都阻塞时结束仿真
+ * @param xEndTick 结束时刻，0表示只在没有任何待发生事件时结束
+ */
+void htSimSetEndTick(TickType_t xEndTick);
+
+/**
+ * 获取跟踪记录
+ * @param ppxEvents 返回跟踪缓冲区
+ * @return 有效的记录条数
+ */
+UBaseType_t htSimGetTrace(const htSimEvent_t **ppxEvents);
+
+/* 逐行打印跟踪记录，用于定位回归 */
+void htSimPrintTrace(void);
+
+#endif /* HT_SIM_H */
@@ -0,0 +1,187 @@
+#include "unity.h"
+#include "htbitmap.h"
+
+/* 两级优先级位图：以-DconfigMAX_PRIORITIES=256编译，每次置位/清位后检查最高优先级 */
+
+#if configMAX_PRIORITIES != 256
+#error "test_bitmap需要以-DconfigMAX_PRIORITIES=256编译"
+#endif
+
+static htPriorityBitmap_t xBitmap;
+static int iReference[configMAX_PRIORITIES];
+
+/* 按参考数组线性查找最高优先级，-1表示为空 */
+static int prvReferenceHighest(void)
+{
+	int i;
+
+	for (i = configMAX_PRIORITIES - 1; i >= 0; i--) {
+		if (iReference[i] != 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void prvSet(UBaseType_t uxPriority)
+{
+	htBitmapSet(&xBitmap, uxPriority);
+	iReference[uxPriority] = 1;
+}
+
+static void prvClear(UBaseType_t uxPriority)
+{
+	htBitmapClear(&xBitmap, uxPriority);
+	iReference[uxPriority] = 0;
+}
+
+/* 位图与参考数组一致：最高优先级、是否为空，一级位图的每一位对应二级字是否非空 */
+static int prvConsistent(void)
+{
+	int iHighest = prvReferenceHighest();
+	UBaseType_t uxWord;
+
+	if (iHighest < 0) {
+		if (htBitmapIsEmpty(&xBitmap) != htTRUE || htBitmapGetHighest(&xBitmap) != 0) {
+			return 0;
+		}
+	} else if (htBitmapIsEmpty(&xBitmap) != htFALSE ||
+			htBitmapGetHighest(&xBitmap) != (UBaseType_t)iHighest) {
+		return 0;
+	}
+
+	for (uxWord = 0; uxWord < htBITMAP_WORDS; uxWord++) {
+		if (((xBitmap.ulGroups >> uxWord) & 1UL) != (xBitmap.ulWords[uxWord] != 0 ? 1UL : 0UL)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void prvReset(void)
+{
+	int i;
+
+	htBitmapInit(&xBitmap);
+	for (i = 0; i < configMAX_PRIORITIES; i++) {
+		iReference[i] = 0;
+	}
+}
+
+/* 简单的线性同余伪随机数，保证结果可复现 */
+static uint32_t ulSeed = 2024;
+static uint32_t prvRand(void)
+{
+	ulSeed = ulSeed * 1103515245UL + 12345UL;
+	return ulSeed >> 8;
+}
+
+void test_empty_bitmap(void)
+{
+	prvReset();
+	TEST_ASSERT(htBitmapIsEmpty(&xBitmap) == htTRUE);
+	TEST_ASSERT_EQUAL(0, htBitmapGetHighest(&xBitmap));
+	TEST_ASSERT_EQUAL(0, xBitmap.ulGroups);
+}
+
+/* 组边界上的单个优先级 */
+void test_single_priority_at_group_edges(void)
+{
+	const UBaseType_t uxEdges[] = { 0, 31, 32, 63, 64, 224, 255 };
+	UBaseType_t i;
+
+	prvReset();
+	for (i = 0; i < sizeof(uxEdges) / sizeof(uxEdges[0]); i++) {
+		prvSet(uxEdges[i]);
+		TEST_ASSERT_EQUAL(uxEdges[i], htBitmapGetHighest(&xBitmap));
+		TEST_ASSERT_EQUAL(1UL << (uxEdges[i] >> 5), xBitmap.ulGroups);
+		prvClear(uxEdges[i]);
+		TEST_ASSERT(prvConsistent());
+		TEST_ASSERT(htBitmapIsEmpty(&xBitmap) == htTRUE);
+	}
+}
+
+/* 跨组置位后从高到低逐个清位，最高优先级依次回落 */
+void test_highest_follows_sets_and_clears_across_groups(void)
+{
+	prvReset();
+	prvSet(0);
+	TEST_ASSERT_EQUAL(0, htBitmapGetHighest(&xBitmap));
+	prvSet(31);
+	TEST_ASSERT_EQUAL(31, htBitmapGetHighest(&xBitmap));
+	prvSet(32);
+	TEST_ASSERT_EQUAL(32, htBitmapGetHighest(&xBitmap));
+	prvSet(255);
+	TEST_ASSERT_EQUAL(255, htBitmapGetHighest(&xBitmap));
+	TEST_ASSERT_EQUAL((1UL << 7) | (1UL << 1) | 1UL, xBitmap.ulGroups);
+
+	/* 低位置位不影响最高优先级 */
+	prvSet(100);
+	TEST_ASSERT_EQUAL(255, htBitmapGetHighest(&xBitmap));
+
+	prvClear(255);
+	TEST_ASSERT_EQUAL(100, htBitmapGetHighest(&xBitmap));
+	prvClear(100);
+	TEST_ASSERT_EQUAL(32, htBitmapGetHighest(&xBitmap));
+	prvClear(32);
+	TEST_ASSERT_EQUAL(31, htBitmapGetHighest(&xBitmap));
+	TEST_ASSERT_EQUAL(0x00000001UL, xBitmap.ulGroups);
+	prvClear(31);
+	TEST_ASSERT_EQUAL(0, htBitmapGetHighest(&xBitmap));
+	TEST_ASSERT(htBitmapIsEmpty(&xBitmap) == htFALSE);
+	prvClear(0);
+	TEST_ASSERT(htBitmapIsEmpty(&xBitmap) == htTRUE);
+}
+
+/* 同组内还有其他优先级时，一级位图的组位保留 */
+void test_group_bit_kept_while_word_not_empty(void)
+{
+	prvReset();
+	prvSet(32);
+	prvSet(63);
+	prvClear(63);
+	TEST_ASSERT_EQUAL(32, htBitmapGetHighest(&xBitmap));
+	TEST_ASSERT_EQUAL(1UL << 1, xBitmap.ulGroups);
+
+	/* 重复清位不影响其他优先级 */
+	prvClear(63);
+	TEST_ASSERT_EQUAL(32, htBitmapGetHighest(&xBitmap));
+	prvClear(32);
+	TEST_ASSERT_EQUAL(0, xBitmap.ulGroups);
+	TEST_ASSERT(prvConsistent());
+}
+
+/* 随机置位/清位，每一步都与线性查找结果一致 */
+void test_random_sets_and_clears_match_linear_scan(void)
+{
+	int iMismatches = 0;
+	int i;
+
+	prvReset();
+	for (i = 0; i < 20000; i++) {
+		UBaseType_t uxPriority = prvRand() % configMAX_PRIORITIES;
+
+		if ((prvRand() & 1U) != 0) {
+			prvSet(uxPriority);
+		} else {
+			prvClear(uxPriority);
+		}
+		if (!prvConsistent()) {
+			iMismatches++;
+		}
+	}
+	TEST_ASSERT_EQUAL(0, iMismatches);
+}
+
+int main(void)
+{
+	UnityBegin("test_bitmap.c");
+
+	RUN_TEST(test_empty_bitmap);
+	RUN_TEST(test_single_priority_at_group_edges);
+	RUN_TEST(test_highest_follows_sets_and_clears_across_groups);
+	RUN_TEST(test_group_bit_kept_while_word_not_empty);
+	RUN_TEST(test_random_sets_and_clears_match_linear_scan);
+
+	return UnityEnd();
+}
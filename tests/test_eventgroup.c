@@ -0,0 +1,202 @@
+#include <stdlib.h>
+#include "unity.h"
+#include "hteventgroup.h"
+
+/*
+ * 事件组测试：任务切换相关函数用桩代替。
+ * htEventGroupWaitBits()在桩环境中阻塞后立即返回，任务留在等待列表中，
+ * 这样可以让多个"任务"同时等待，再检查一次置位唤醒了哪些任务。
+ */
+
+#define MAX_TASKS 8
+
+htTCB_t *pxCurrentTCB = NULL;
+TickType_t xTickCount = 0;
+
+static htTCB_t xTasks[MAX_TASKS];
+static int iWokenCount;
+
+void htEnterCritical(void)
+{
+}
+
+void htExitCritical(void)
+{
+}
+
+UBaseType_t htEnterCriticalFromISR(void)
+{
+	return 0;
+}
+
+void htExitCriticalFromISR(UBaseType_t uxSavedMask)
+{
+	(void)uxSavedMask;
+}
+
+void htTaskYield(void)
+{
+}
+
+void htTaskPlaceOnDelayedList(TickType_t xTicksToWait)
+{
+	(void)xTicksToWait;
+	pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
+}
+
+void htTaskUnblock(htTCB_t *pxTCB)
+{
+	(void)pxTCB;
+	iWokenCount++;
+}
+
+void *htPortMalloc(size_t xWantedSize)
+{
+	return malloc(xWantedSize);
+}
+
+void htPortFree(void *pv)
+{
+	free(pv);
+}
+
+static EventGroupHandle_t prvSetUp(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_TASKS; i++) {
+		htListItemInit(&(xTasks[i].xStateListItem));
+		htListItemInit(&(xTasks[i].xEventListItem));
+		htListSetItemOwner(&(xTasks[i].xEventListItem), &xTasks[i]);
+		xTasks[i].pxWaitQueue = NULL;
+		xTasks[i].uxPriority = 1;
+		xTasks[i].uxTaskState = HT_TASK_RUNNING;
+	}
+	iWokenCount = 0;
+	pxCurrentTCB = NULL;
+
+	return htEventGroupCreate();
+}
+
+/* 让任务i开始等待 */
+static void prvWait(EventGroupHandle_t xGroup, int i, EventBits_t uxBits, BaseType_t xClear, BaseType_t xAll)
+{
+	pxCurrentTCB = &xTasks[i];
+	(void)htEventGroupWaitBits(xGroup, uxBits, xClear, xAll, 100);
+	pxCurrentTCB = NULL;
+}
+
+static int prvIsWaiting(int i)
+{
+	return xTasks[i].pxWaitQueue != NULL;
+}
+
+void test_condition_already_met_returns_immediately(void)
+{
+	EventGroupHandle_t xGroup = prvSetUp();
+	EventBits_t uxBits;
+
+	htEventGroupSetBits(xGroup, 0x05);
+	pxCurrentTCB = &xTasks[0];
+	uxBits = htEventGroupWaitBits(xGroup, 0x04, htTRUE, htFALSE, 100);
+
+	TEST_ASSERT_EQUAL(0x05, uxBits);
+	TEST_ASSERT(!prvIsWaiting(0));
+	TEST_ASSERT_EQUAL(0x01, htEventGroupGetBits(xGroup));
+	htEventGroupDelete(xGroup);
+}
+
+void test_one_set_wakes_every_satisfied_waiter(void)
+{
+	EventGroupHandle_t xGroup = prvSetUp();
+
+	prvWait(xGroup, 0, 0x01, htFALSE, htFALSE); /* 任意：0位 */
+	prvWait(xGroup, 1, 0x03, htFALSE, htTRUE); /* 全部：0,1位 */
+	prvWait(xGroup, 2, 0x06, htFALSE, htFALSE); /* 任意：1,2位 */
+	prvWait(xGroup, 3, 0x10, htFALSE, htFALSE); /* 任意：4位 */
+
+	htEventGroupSetBits(xGroup, 0x03);
+
+	TEST_ASSERT_EQUAL(3, iWokenCount);
+	TEST_ASSERT(!prvIsWaiting(0));
+	TEST_ASSERT(!prvIsWaiting(1));
+	TEST_ASSERT(!prvIsWaiting(2));
+	TEST_ASSERT(prvIsWaiting(3));
+	/* 被唤醒的任务拿到的是条件满足时的事件位 */
+	TEST_ASSERT_EQUAL(0x03, xTasks[1].ulEventWaitBits);
+	htEventGroupDelete(xGroup);
+}
+
+void test_wait_all_needs_every_bit(void)
+{
+	EventGroupHandle_t xGroup = prvSetUp();
+
+	prvWait(xGroup, 0, 0x07, htFALSE, htTRUE);
+	htEventGroupSetBits(xGroup, 0x01);
+	htEventGroupSetBits(xGroup, 0x04);
+	TEST_ASSERT(prvIsWaiting(0));
+	htEventGroupSetBits(xGroup, 0x02);
+	TEST_ASSERT(!prvIsWaiting(0));
+	TEST_ASSERT_EQUAL(0x07, htEventGroupGetBits(xGroup));
+	htEventGroupDelete(xGroup);
+}
+
+void test_clear_on_exit_applies_after_all_waiters_checked(void)
+{
+	EventGroupHandle_t xGroup = prvSetUp();
+
+	/* 第一个等待者要求清除0位，但同一次置位仍要唤醒后面等待0位的任务 */
+	prvWait(xGroup, 0, 0x01, htTRUE, htFALSE);
+	prvWait(xGroup, 1, 0x01, htFALSE, htFALSE);
+	prvWait(xGroup, 2, 0x03, htTRUE, htTRUE);
+
+	TEST_ASSERT_EQUAL(0x04, htEventGroupSetBits(xGroup, 0x07));
+	TEST_ASSERT_EQUAL(3, iWokenCount);
+	TEST_ASSERT_EQUAL(0x07, xTasks[0].ulEventWaitBits);
+	TEST_ASSERT_EQUAL(0x07, xTasks[1].ulEventWaitBits);
+	htEventGroupDelete(xGroup);
+}
+
+void test_all_32_bits_usable(void)
+{
+	EventGroupHandle_t xGroup = prvSetUp();
+
+	prvWait(xGroup, 0, 0x80000000UL, htTRUE, htFALSE);
+	prvWait(xGroup, 1, 0xFF000000UL, htFALSE, htTRUE);
+	htEventGroupSetBits(xGroup, 0x80000000UL);
+	TEST_ASSERT(!prvIsWaiting(0));
+	TEST_ASSERT(prvIsWaiting(1));
+	htEventGroupSetBits(xGroup, 0xFF000000UL);
+	TEST_ASSERT(!prvIsWaiting(1));
+	htEventGroupDelete(xGroup);
+}
+
+void test_set_from_isr_reports_higher_priority_wakeup(void)
+{
+	EventGroupHandle_t xGroup = prvSetUp();
+	BaseType_t xWoken = htFALSE;
+
+	xTasks[0].uxPriority = 5;
+	prvWait(xGroup, 0, 0x08, htFALSE, htFALSE);
+	xTasks[1].uxPriority = 2;
+	pxCurrentTCB = &xTasks[1];
+
+	htEventGroupSetBitsFromISR(xGroup, 0x08, &xWoken);
+	TEST_ASSERT_EQUAL(htTRUE, xWoken);
+	TEST_ASSERT(!prvIsWaiting(0));
+	htEventGroupDelete(xGroup);
+}
+
+int main(void)
+{
+	UnityBegin("test_eventgroup.c");
+
+	RUN_TEST(test_condition_already_met_returns_immediately);
+	RUN_TEST(test_one_set_wakes_every_satisfied_waiter);
+	RUN_TEST(test_wait_all_needs_every_bit);
+	RUN_TEST(test_clear_on_exit_applies_after_all_waiters_checked);
+	RUN_TEST(test_all_32_bits_usable);
+	RUN_TEST(test_set_from_isr_reports_higher_priority_wakeup);
+
+	return UnityEnd();
+}
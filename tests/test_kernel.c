@@ -0,0 +1,1103 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "unity.h"
+#include "htos.h"
+#include "httask.h"
+#include "htscheduler.h"
+#include "htqueue.h"
+#include "htsemaphore.h"
+#include "htmutex.h"
+#include "hteventgroup.h"
+#include "httimer.h"
+#include "htmem.h"
+#include "htutils.h"
+
+/*
+ * 内核集成测试：链接完整内核和POSIX移植层，任务由SIGALRM滴答驱动真实调度。
+ * 每个场景在子进程中启动调度器，任务中用CHECK记录失败，最后由控制任务调用
+ * htTaskEndScheduler()；父进程根据子进程退出码判断结果，并对卡死的场景超时处理。
+ */
+
+#define SCENARIO_TIMEOUT_MS 5000
+#define TEST_STACK 256
+
+#define CHECK(xCondition) \
+	do { \
+		if (!(xCondition)) { \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #xCondition); \
+			iFailures++; \
+		} \
+	} while (0)
+
+static volatile int iFailures;
+static volatile int iLog[16];
+static volatile int iLogCount;
+
+static void prvLog(int iValue)
+{
+	if (iLogCount < (int)(sizeof(iLog) / sizeof(iLog[0]))) {
+		iLog[iLogCount++] = iValue;
+	}
+}
+
+/* 在子进程中初始化内核、运行pxSetup创建的任务，返回失败的CHECK数，超时或崩溃返回-1 */
+static int prvRunKernel(void (*pxSetup)(void))
+{
+	pid_t xPid;
+	int iStatus;
+	int i;
+
+	fflush(stdout);
+	xPid = fork();
+	if (xPid == 0) {
+		/* 内核创建任务时的调试输出不混入测试结果 */
+		(void)freopen("/dev/null", "w", stdout);
+		htOSInit();
+		pxSetup();
+		htOSStart();
+		_exit(iFailures == 0 ? 0 : 1);
+	}
+
+	for (i = 0; i < SCENARIO_TIMEOUT_MS; i++) {
+		if (waitpid(xPid, &iStatus, WNOHANG) == xPid) {
+			return WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : -1;
+		}
+		usleep(1000);
+	}
+
+	kill(xPid, SIGKILL);
+	(void)waitpid(xPid, &iStatus, 0);
+	return -1;
+}
+
+/* ---------- 调度 ---------- */
+
+static void prvPriorityTask(void *pvParameters)
+{
+	prvLog((int)(intptr_t)pvParameters);
+	if ((intptr_t)pvParameters == 1) {
+		CHECK(iLogCount == 3);
+		CHECK(iLog[0] == 3 && iLog[1] == 2 && iLog[2] == 1);
+		htTaskEndScheduler();
+	}
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvPrioritySetup(void)
+{
+	/* 最先创建的是最低优先级任务，启动后仍应先运行最高优先级任务 */
+	htTaskCreate(prvPriorityTask, "p1", TEST_STACK, (void *)1, 1, NULL);
+	htTaskCreate(prvPriorityTask, "p2", TEST_STACK, (void *)2, 2, NULL);
+	htTaskCreate(prvPriorityTask, "p3", TEST_STACK, (void *)3, 3, NULL);
+}
+
+void test_highest_priority_task_runs_first(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvPrioritySetup));
+}
+
+static void prvDelayTask(void *pvParameters)
+{
+	const TickType_t xDelay = (TickType_t)(intptr_t)pvParameters;
+	const TickType_t xStart = xTickCount;
+
+	htTaskDelay(xDelay);
+	CHECK(xTickCount - xStart >= xDelay);
+	prvLog((int)xDelay);
+	if (iLogCount == 3) {
+		CHECK(iLog[0] == 10 && iLog[1] == 20 && iLog[2] == 30);
+		htTaskEndScheduler();
+	}
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvDelaySetup(void)
+{
+	htTaskCreate(prvDelayTask, "d30", TEST_STACK, (void *)30, 2, NULL);
+	htTaskCreate(prvDelayTask, "d10", TEST_STACK, (void *)10, 2, NULL);
+	htTaskCreate(prvDelayTask, "d20", TEST_STACK, (void *)20, 2, NULL);
+}
+
+void test_delayed_tasks_wake_in_deadline_order(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvDelaySetup));
+}
+
+/* ---------- 队列 ---------- */
+
+static QueueHandle_t xQueue;
+
+static void prvConsumerTask(void *pvParameters)
+{
+	uint32_t ulValue;
+	TickType_t xStart;
+	int i;
+
+	(void)pvParameters;
+
+	for (i = 0; i < 3; i++) {
+		CHECK(htQueueReceive(xQueue, &ulValue, 100) == htPASS);
+		CHECK(ulValue == (uint32_t)(100 + i));
+	}
+
+	/* 队列已空：等待必须真正阻塞到超时 */
+	xStart = xTickCount;
+	CHECK(htQueueReceive(xQueue, &ulValue, 20) == htFAIL);
+	CHECK(xTickCount - xStart >= 20);
+
+	htTaskEndScheduler();
+}
+
+static void prvProducerTask(void *pvParameters)
+{
+	uint32_t ulValue;
+
+	(void)pvParameters;
+
+	for (ulValue = 100; ulValue < 103; ulValue++) {
+		htTaskDelay(2);
+		CHECK(htQueueSend(xQueue, &ulValue, 0) == htPASS);
+	}
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvQueueSetup(void)
+{
+	xQueue = htQueueCreate(2, sizeof(uint32_t));
+	htTaskCreate(prvConsumerTask, "cons", TEST_STACK, NULL, 3, NULL);
+	htTaskCreate(prvProducerTask, "prod", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_queue_receive_blocks_until_data_or_timeout(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvQueueSetup));
+}
+
+/* ---------- 互斥量优先级继承 ---------- */
+
+static SemaphoreHandle_t xMutex;
+static TaskHandle_t xLowTask;
+
+static void prvHighMutexTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(5);
+	CHECK(htSemaphoreTakeMutex(xMutex, 100) == htPASS);
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 1);
+	CHECK(htSemaphoreGiveMutex(xMutex) == htPASS);
+	htTaskEndScheduler();
+}
+
+static void prvLowMutexTask(void *pvParameters)
+{
+	TickType_t xStart;
+
+	(void)pvParameters;
+
+	CHECK(htSemaphoreTakeMutex(xMutex, 0) == htPASS);
+	/* 持有期间高优先级任务来等待，持有者被提升 */
+	xStart = xTickCount;
+	while (xTickCount - xStart < 10) {
+	}
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 3);
+	CHECK(htSemaphoreGiveMutex(xMutex) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvMutexSetup(void)
+{
+	xMutex = htSemaphoreCreateMutex();
+	htTaskCreate(prvLowMutexTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvHighMutexTask, "high", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_mutex_holder_inherits_waiter_priority(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvMutexSetup));
+}
+
+/* ---------- 传递的优先级继承 ---------- */
+
+static SemaphoreHandle_t xMutexA;
+static SemaphoreHandle_t xMutexB;
+static TaskHandle_t xMidTask;
+
+static void prvSpinTicks(TickType_t xTicks)
+{
+	const TickType_t xStart = xTickCount;
+
+	while (xTickCount - xStart < xTicks) {
+	}
+}
+
+/* low持有A；mid持有B后等待A；high等待B时沿链把mid和low都提升到3 */
+static void prvChainLowTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	CHECK(htSemaphoreTakeMutex(xMutexA, 0) == htPASS);
+	prvSpinTicks(12);
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 3);
+	CHECK(htSemaphoreGiveMutex(xMutexA) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvChainMidTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(2);
+	CHECK(htSemaphoreTakeMutex(xMutexB, 0) == htPASS);
+	CHECK(htSemaphoreTakeMutex(xMutexA, 100) == htPASS);
+	/* 释放A后low回到基础优先级，mid仍持有B，high还在等待 */
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 1);
+	CHECK(((htTCB_t *)xMidTask)->uxPriority == 3);
+	CHECK(htSemaphoreGiveMutex(xMutexA) == htPASS);
+	CHECK(htSemaphoreGiveMutex(xMutexB) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvChainHighTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(4);
+	CHECK(htSemaphoreTakeMutex(xMutexB, 100) == htPASS);
+	CHECK(((htTCB_t *)xMidTask)->uxPriority == 2);
+	CHECK(htSemaphoreGiveMutex(xMutexB) == htPASS);
+	htTaskEndScheduler();
+}
+
+static void prvChainSetup(void)
+{
+	xMutexA = htSemaphoreCreateMutex();
+	xMutexB = htSemaphoreCreateMutex();
+	htTaskCreate(prvChainLowTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvChainMidTask, "mid", TEST_STACK, NULL, 2, &xMidTask);
+	htTaskCreate(prvChainHighTask, "high", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_priority_inheritance_follows_chain_of_blocked_holders(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvChainSetup));
+}
+
+/* low同时持有A和B，分别有优先级3和2的任务在等待；释放A后降到2而不是基础优先级 */
+static void prvMultiLowTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	CHECK(htSemaphoreTakeMutex(xMutexA, 0) == htPASS);
+	CHECK(htSemaphoreTakeMutex(xMutexB, 0) == htPASS);
+	prvSpinTicks(10);
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 3);
+	CHECK(htSemaphoreGiveMutex(xMutexA) == htPASS);
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 2);
+	CHECK(htSemaphoreGiveMutex(xMutexB) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvMultiWaiterTask(void *pvParameters)
+{
+	SemaphoreHandle_t xMutexToTake = (SemaphoreHandle_t)pvParameters;
+
+	htTaskDelay(2);
+	CHECK(htSemaphoreTakeMutex(xMutexToTake, 100) == htPASS);
+	CHECK(htSemaphoreGiveMutex(xMutexToTake) == htPASS);
+	if (xMutexToTake == xMutexB) {
+		CHECK(((htTCB_t *)xLowTask)->uxPriority == 1);
+		htTaskEndScheduler();
+	}
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvMultiSetup(void)
+{
+	xMutexA = htSemaphoreCreateMutex();
+	xMutexB = htSemaphoreCreateMutex();
+	htTaskCreate(prvMultiLowTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvMultiWaiterTask, "waitA", TEST_STACK, xMutexA, 3, NULL);
+	htTaskCreate(prvMultiWaiterTask, "waitB", TEST_STACK, xMutexB, 2, NULL);
+}
+
+void test_release_drops_to_highest_waiter_of_mutexes_still_held(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvMultiSetup));
+}
+
+/* ---------- 删除持有互斥量的任务 ---------- */
+
+static SemaphoreHandle_t xRecursiveMutex;
+static volatile BaseType_t xMidTakeResult = htFAIL;
+
+/* 持有互斥量A和两层递归互斥量后阻塞，之后被删除 */
+static void prvDeletedHolderTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	CHECK(htSemaphoreTakeMutex(xMutexA, 0) == htPASS);
+	CHECK(htSemaphoreTakeRecursive(xRecursiveMutex, 0) == htPASS);
+	CHECK(htSemaphoreTakeRecursive(xRecursiveMutex, 0) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvDeleteWaiterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(1);
+	xMidTakeResult = htSemaphoreTakeMutex(xMutexA, 100);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvHolderDeleterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(3);
+	CHECK(xMutexA->u.xSemaphore.pxMutexHolder == (htTCB_t *)xLowTask);
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 2);
+
+	/* 互斥量恢复可用并唤醒等待者，递归互斥量的持有者和递归计数清零 */
+	htTaskDelete(xLowTask);
+	CHECK(htSemaphoreTakeRecursive(xRecursiveMutex, 0) == htPASS);
+	CHECK(htSemaphoreGiveRecursive(xRecursiveMutex) == htPASS);
+	CHECK(htSemaphoreGiveRecursive(xRecursiveMutex) == htFAIL);
+
+	htTaskDelay(1);
+	CHECK(xMidTakeResult == htPASS);
+	CHECK(xMutexA->u.xSemaphore.pxMutexHolder == (htTCB_t *)xMidTask);
+	CHECK(((htTCB_t *)xMidTask)->pxMutexesHeld == &(xMutexA->xTasksWaitingToReceive));
+	htTaskEndScheduler();
+}
+
+static void prvDeleteHolderSetup(void)
+{
+	xMutexA = htSemaphoreCreateMutex();
+	xRecursiveMutex = htSemaphoreCreateRecursiveMutex();
+	htTaskCreate(prvDeletedHolderTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvDeleteWaiterTask, "mid", TEST_STACK, NULL, 2, &xMidTask);
+	htTaskCreate(prvHolderDeleterTask, "high", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_deleting_mutex_holder_makes_its_mutexes_available(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvDeleteHolderSetup));
+}
+
+/* 持有互斥量A后阻塞 */
+static void prvGiveHolderTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	CHECK(htSemaphoreTakeMutex(xMutexA, 0) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNonHolderGiverTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(1);
+
+	/* 非持有者释放失败，持有关系保持不变 */
+	CHECK(htSemaphoreGiveMutex(xMutexA) == htFAIL);
+	CHECK(xMutexA->uxMessagesWaiting == 0);
+	CHECK(xMutexA->u.xSemaphore.pxMutexHolder == (htTCB_t *)xLowTask);
+	CHECK(((htTCB_t *)xLowTask)->pxMutexesHeld == &(xMutexA->xTasksWaitingToReceive));
+
+	/* 删除持有者后互斥量只释放一次 */
+	htTaskDelete(xLowTask);
+	CHECK(xMutexA->uxMessagesWaiting == 1);
+	CHECK(htSemaphoreTakeMutex(xMutexA, 0) == htPASS);
+	CHECK(htSemaphoreTakeMutex(xMutexA, 0) == htFAIL);
+	CHECK(htSemaphoreGiveMutex(xMutexA) == htPASS);
+	CHECK(htSemaphoreGiveMutex(xMutexA) == htFAIL);
+	htTaskEndScheduler();
+}
+
+static void prvNonHolderGiveSetup(void)
+{
+	xMutexA = htSemaphoreCreateMutex();
+	htTaskCreate(prvGiveHolderTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvNonHolderGiverTask, "high", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_mutex_give_by_non_holder_fails(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvNonHolderGiveSetup));
+}
+
+/* ---------- 轻量互斥量 ---------- */
+
+static MutexHandle_t xNativeMutex;
+
+static void prvNativeHighTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(5);
+	CHECK(htMutexLock(xNativeMutex, 100) == htPASS);
+	/* 释放者直接把互斥量交给等待者，并恢复了自己的优先级 */
+	CHECK(htMutexGetOwner(xNativeMutex) == htTaskGetCurrentTaskHandle());
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 1);
+	CHECK(((htTCB_t *)xLowTask)->pxMutexesHeld == NULL);
+	CHECK(htMutexUnlock(xNativeMutex) == htPASS);
+	CHECK(htMutexGetOwner(xNativeMutex) == NULL);
+	htTaskEndScheduler();
+}
+
+static void prvNativeLowTask(void *pvParameters)
+{
+	htTCB_t *pxSelf = (htTCB_t *)htTaskGetCurrentTaskHandle();
+	TickType_t xStart;
+
+	(void)pvParameters;
+
+	/* 无竞争的获取不挂到持有链表上，不支持递归获取 */
+	CHECK(htMutexLock(xNativeMutex, 0) == htPASS);
+	CHECK(pxSelf->pxMutexesHeld == NULL);
+	CHECK(htMutexLock(xNativeMutex, 10) == htFAIL);
+
+	xStart = xTickCount;
+	while (xTickCount - xStart < 10) {
+	}
+	CHECK(pxSelf->uxPriority == 3);
+	CHECK(pxSelf->pxMutexesHeld == &(xNativeMutex->xWaiters));
+	CHECK(htMutexUnlock(xNativeMutex) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNativeMutexSetup(void)
+{
+	xNativeMutex = htMutexCreate();
+	htTaskCreate(prvNativeLowTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvNativeHighTask, "high", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_native_mutex_hands_off_to_waiter_and_restores_priority(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvNativeMutexSetup));
+}
+
+static void prvNativeTimeoutHighTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(2);
+	CHECK(htMutexLock(xNativeMutex, 5) == htFAIL);
+	/* 唯一的等待者超时离开，持有者回到基础优先级 */
+	CHECK(htMutexGetOwner(xNativeMutex) == xLowTask);
+	CHECK(((htTCB_t *)xLowTask)->uxPriority == 1);
+	CHECK(((htTCB_t *)xLowTask)->pxMutexesHeld == NULL);
+
+	CHECK(htMutexLock(xNativeMutex, 100) == htPASS);
+	CHECK(htMutexUnlock(xNativeMutex) == htPASS);
+	htTaskEndScheduler();
+}
+
+static void prvNativeTimeoutLowTask(void *pvParameters)
+{
+	TickType_t xStart;
+
+	(void)pvParameters;
+
+	CHECK(htMutexLock(xNativeMutex, 0) == htPASS);
+	xStart = xTickCount;
+	while (xTickCount - xStart < 15) {
+	}
+	CHECK(htMutexUnlock(xNativeMutex) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNativeTimeoutSetup(void)
+{
+	xNativeMutex = htMutexCreate();
+	htTaskCreate(prvNativeTimeoutLowTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvNativeTimeoutHighTask, "high", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_native_mutex_waiter_timeout_drops_inherited_priority(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvNativeTimeoutSetup));
+}
+
+static MutexHandle_t xNativeMutex2;
+static volatile BaseType_t xMidLockResult = htFAIL;
+
+/* 无竞争地持有两个互斥量后阻塞，之后被删除 */
+static void prvNativeDeletedHolderTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	CHECK(htMutexLock(xNativeMutex, 0) == htPASS);
+	CHECK(htMutexLock(xNativeMutex2, 0) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNativeDeleteWaiterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(1);
+	xMidLockResult = htMutexLock(xNativeMutex, 100);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNativeDeleterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(3);
+	CHECK(htMutexGetOwner(xNativeMutex) == xLowTask);
+	CHECK(htMutexGetOwner(xNativeMutex2) == xLowTask);
+
+	/* 有等待者的交给等待者，无竞争持有的变为空闲 */
+	htTaskDelete(xLowTask);
+	CHECK(htMutexGetOwner(xNativeMutex) == xMidTask);
+	CHECK(htMutexGetOwner(xNativeMutex2) == NULL);
+	CHECK(htMutexLock(xNativeMutex2, 0) == htPASS);
+	CHECK(htMutexUnlock(xNativeMutex2) == htPASS);
+
+	htTaskDelay(1);
+	CHECK(xMidLockResult == htPASS);
+	htTaskEndScheduler();
+}
+
+static void prvNativeDeleteSetup(void)
+{
+	xNativeMutex = htMutexCreate();
+	xNativeMutex2 = htMutexCreate();
+	/* 调度器启动前没有当前任务，不能获取 */
+	CHECK(htMutexLock(xNativeMutex, 0) == htFAIL);
+	CHECK(htMutexGetOwner(xNativeMutex) == NULL);
+
+	htTaskCreate(prvNativeDeletedHolderTask, "low", TEST_STACK, NULL, 1, &xLowTask);
+	htTaskCreate(prvNativeDeleteWaiterTask, "mid", TEST_STACK, NULL, 2, &xMidTask);
+	htTaskCreate(prvNativeDeleterTask, "high", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_deleting_native_mutex_holder_releases_its_mutexes(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvNativeDeleteSetup));
+}
+
+/* ---------- 任务通知 ---------- */
+
+static TaskHandle_t xNotifyWaiter;
+
+static void prvNotifyWaiterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	/* 两次给出只需一次取走 */
+	CHECK(htTaskNotifyTake(htTRUE, 100) == 2);
+	CHECK(htTaskNotifyTake(htTRUE, 5) == 0);
+	htTaskEndScheduler();
+}
+
+static void prvNotifierTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(3);
+	CHECK(htTaskNotifyGive(xNotifyWaiter) == htPASS);
+	CHECK(htTaskNotifyGive(xNotifyWaiter) == htPASS);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNotifySetup(void)
+{
+	/* 通知方优先级更高，两次给出都在等待方运行之前完成 */
+	htTaskCreate(prvNotifyWaiterTask, "wait", TEST_STACK, NULL, 2, &xNotifyWaiter);
+	htTaskCreate(prvNotifierTask, "give", TEST_STACK, NULL, 3, NULL);
+}
+
+void test_notify_give_take_counts(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvNotifySetup));
+}
+
+/* ---------- 事件组 ---------- */
+
+static EventGroupHandle_t xEventGroup;
+
+static void prvEventWaiterTask(void *pvParameters)
+{
+	EventBits_t uxBits;
+
+	(void)pvParameters;
+
+	uxBits = htEventGroupWaitBits(xEventGroup, 0x3, htTRUE, htTRUE, 100);
+	CHECK((uxBits & 0x3) == 0x3);
+	CHECK(iLogCount == 2);
+	CHECK(htEventGroupGetBits(xEventGroup) == 0);
+
+	/* 条件不满足时超时返回 */
+	uxBits = htEventGroupWaitBits(xEventGroup, 0x4, htFALSE, htFALSE, 10);
+	CHECK((uxBits & 0x4) == 0);
+	htTaskEndScheduler();
+}
+
+static void prvEventSetterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(2);
+	prvLog(1);
+	(void)htEventGroupSetBits(xEventGroup, 0x1);
+	htTaskDelay(2);
+	prvLog(2);
+	(void)htEventGroupSetBits(xEventGroup, 0x2);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvEventSetup(void)
+{
+	xEventGroup = htEventGroupCreate();
+	htTaskCreate(prvEventWaiterTask, "ewait", TEST_STACK, NULL, 3, NULL);
+	htTaskCreate(prvEventSetterTask, "eset", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_event_group_waits_for_all_bits(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvEventSetup));
+}
+
+/* ---------- 软件定时器 ---------- */
+
+static volatile int iPeriodicCount;
+static volatile int iOneShotCount;
+
+static void prvTimerCallback(TimerHandle_t xTimer)
+{
+	if (htTimerGetTimerID(xTimer) == (void *)1) {
+		iPeriodicCount++;
+	} else {
+		iOneShotCount++;
+	}
+}
+
+static void prvTimerTask(void *pvParameters)
+{
+	TimerHandle_t xPeriodic;
+	TimerHandle_t xOneShot;
+
+	(void)pvParameters;
+
+	xPeriodic = htTimerCreate("per", 10, htTRUE, (void *)1, prvTimerCallback);
+	xOneShot = htTimerCreate("one", 25, htFALSE, (void *)2, prvTimerCallback);
+	CHECK(htTimerStart(xPeriodic, 10) == htPASS);
+	CHECK(htTimerStart(xOneShot, 10) == htPASS);
+
+	htTaskDelay(105);
+	CHECK(iPeriodicCount == 10);
+	CHECK(iOneShotCount == 1);
+	CHECK(htTimerIsTimerActive(xPeriodic) == htTRUE);
+	CHECK(htTimerIsTimerActive(xOneShot) == htFALSE);
+
+	CHECK(htTimerStop(xPeriodic, 10) == htPASS);
+	htTaskDelay(30);
+	CHECK(iPeriodicCount == 10);
+	htTaskEndScheduler();
+}
+
+static void prvTimerSetup(void)
+{
+	htTaskCreate(prvTimerTask, "tmr", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_software_timers_fire_on_schedule(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvTimerSetup));
+}
+
+/* ---------- 临界区 ---------- */
+
+static void prvCriticalTask(void *pvParameters)
+{
+	QueueHandle_t xQueue;
+	TickType_t xStart;
+	uint32_t ulItem = 1;
+
+	(void)pvParameters;
+
+	xQueue = htQueueCreate(1, sizeof(uint32_t));
+	CHECK(xQueue != NULL);
+
+	/* 临界区中调用FromISR接口，退出时不能提前解除任务临界区的屏蔽 */
+	htEnterCritical();
+	xStart = xTickCount;
+	CHECK(htQueueSendFromISR(xQueue, &ulItem, NULL) == htPASS);
+	usleep(20000);
+	CHECK(xTickCount == xStart);
+	htExitCritical();
+
+	htTaskDelay(2);
+	CHECK(xTickCount != xStart);
+	CHECK(htQueueMessagesWaiting(xQueue) == 1);
+	htTaskEndScheduler();
+}
+
+static void prvCriticalSetup(void)
+{
+	htTaskCreate(prvCriticalTask, "crit", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_isr_mask_nested_in_critical_section_restores_mask(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvCriticalSetup));
+}
+
+/* ---------- 挂起调度器 ---------- */
+
+static QueueHandle_t xPendingQueue;
+static volatile int iWaiterRan;
+static volatile int iSleeperRan;
+
+static void prvPendingWaiterTask(void *pvParameters)
+{
+	uint32_t ulItem;
+
+	(void)pvParameters;
+
+	CHECK(htQueueReceive(xPendingQueue, &ulItem, htBLOCKED_INDEFINITELY) == htPASS);
+	iWaiterRan = 1;
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvPendingSleeperTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	htTaskDelay(5);
+	iSleeperRan = 1;
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvPendingTask(void *pvParameters)
+{
+	BaseType_t xWoken = htFALSE;
+	TickType_t xStart;
+	uint32_t ulItem = 7;
+
+	(void)pvParameters;
+
+	/* 挂起期间中断唤醒的任务和到期的任务都不运行，滴答照常计数 */
+	htSchedulerSuspend();
+	xStart = xTickCount;
+	CHECK(htQueueSendFromISR(xPendingQueue, &ulItem, &xWoken) == htPASS);
+	CHECK(xWoken == htTRUE);
+	while ((TickType_t)(xTickCount - xStart) < 10) {
+		usleep(1000);
+	}
+	CHECK(iWaiterRan == 0);
+	CHECK(iSleeperRan == 0);
+
+	/* 恢复时两个更高优先级的任务立即运行 */
+	htSchedulerResume();
+	CHECK(iWaiterRan == 1);
+	CHECK(iSleeperRan == 1);
+	htTaskEndScheduler();
+}
+
+static void prvPendingSetup(void)
+{
+	xPendingQueue = htQueueCreate(1, sizeof(uint32_t));
+	htTaskCreate(prvPendingWaiterTask, "wait", TEST_STACK, NULL, 3, NULL);
+	htTaskCreate(prvPendingSleeperTask, "sleep", TEST_STACK, NULL, 3, NULL);
+	htTaskCreate(prvPendingTask, "pend", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_wakeups_while_suspended_run_on_resume(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvPendingSetup));
+}
+
+/* ---------- 自删除任务的回收 ---------- */
+
+#define REAP_ROUNDS 100
+#define REAP_BATCH 3
+
+static volatile int iReapWorkerRuns;
+
+static void prvReapWorkerTask(void *pvParameters)
+{
+	(void)pvParameters;
+	iReapWorkerRuns++;
+	htTaskDelete(NULL);
+}
+
+static void prvReapSpawnerTask(void *pvParameters)
+{
+	size_t uxFreeAtStart;
+	int i;
+	int j;
+
+	(void)pvParameters;
+
+	htTaskDelay(1);
+	uxFreeAtStart = htGetFreeHeapSize();
+
+	for (i = 0; i < REAP_ROUNDS; i++) {
+		/* 工作任务优先级更高，创建后立即运行并删除自身 */
+		for (j = 0; j < REAP_BATCH; j++) {
+			CHECK(htTaskCreate(prvReapWorkerTask, "worker", TEST_STACK, NULL, 3, NULL) == htPASS);
+		}
+		CHECK(iReapWorkerRuns == (i + 1) * REAP_BATCH);
+
+		/* 栈和TCB要等空闲任务运行后才一批释放 */
+		CHECK(htGetFreeHeapSize() < uxFreeAtStart);
+		/* 延时1个tick可能紧接着就到期，空闲任务来不及运行；2个tick保证至少阻塞一整个tick */
+		htTaskDelay(2);
+		CHECK(htGetFreeHeapSize() == uxFreeAtStart);
+	}
+
+	htTaskEndScheduler();
+}
+
+static void prvReapSetup(void)
+{
+	htTaskCreate(prvReapSpawnerTask, "spawner", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_self_deleted_tasks_are_reaped_by_idle(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvReapSetup));
+}
+
+/* ---------- 让出时的切换判断 ---------- */
+
+static volatile int iYieldPeerRuns;
+static volatile int iYieldLowRuns;
+
+static void prvYieldPeerTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		iYieldPeerRuns++;
+		htTaskYield();
+	}
+}
+
+static void prvYieldLowTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		iYieldLowRuns++;
+	}
+}
+
+static void prvYieldTask(void *pvParameters)
+{
+	TaskHandle_t xPeer = NULL;
+	int iBefore;
+	int i;
+
+	(void)pvParameters;
+
+	/* 同优先级没有其他任务，让出后继续运行，低优先级任务不会插进来 */
+	for (i = 0; i < 100; i++) {
+		htTaskYield();
+	}
+	CHECK(iYieldLowRuns == 0);
+
+	/* 有同优先级任务时每次让出都轮到它，滴答轮转可能让它多运行几次 */
+	CHECK(htTaskCreate(prvYieldPeerTask, "peer", TEST_STACK, NULL, 2, &xPeer) == htPASS);
+	for (i = 0; i < 10; i++) {
+		iBefore = iYieldPeerRuns;
+		htTaskYield();
+		CHECK(iYieldPeerRuns > iBefore);
+	}
+
+	/* 挂起调度器时的让出推迟到恢复时，仍然轮到同优先级任务 */
+	htSchedulerSuspend();
+	iBefore = iYieldPeerRuns;
+	htTaskYield();
+	CHECK(iYieldPeerRuns == iBefore);
+	htSchedulerResume();
+	CHECK(iYieldPeerRuns > iBefore);
+
+	/* 同优先级任务删除后，推迟的让出在恢复时判断为不需要切换 */
+	htTaskDelete(xPeer);
+	htSchedulerSuspend();
+	htTaskYield();
+	htSchedulerResume();
+	CHECK(htTaskGetCurrentTaskHandle() != xPeer);
+	CHECK(iYieldLowRuns == 0);
+
+	htTaskEndScheduler();
+}
+
+static void prvYieldSetup(void)
+{
+	htTaskCreate(prvYieldTask, "yield", TEST_STACK, NULL, 2, NULL);
+	htTaskCreate(prvYieldLowTask, "low", TEST_STACK, NULL, 1, NULL);
+}
+
+void test_yield_switches_only_when_another_task_is_selected(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvYieldSetup));
+}
+
+/* ---------- 栈使用分析 ---------- */
+
+#define STACK_USED_WORDS 180
+/* 180字加25%余量为225，按8字向上取整 */
+#define STACK_ADVISED_WORDS 232
+
+static void prvStackUserTask(void *pvParameters)
+{
+	htTCB_t *pxSelf = (htTCB_t *)htTaskGetCurrentTaskHandle();
+	char cExpected[128];
+	char cReport[2048];
+	FILE *pxReport;
+	size_t uxLength;
+	int iStdout;
+
+	(void)pvParameters;
+
+	/* 主机上任务运行在各自的主机栈上，直接改写内核栈区中距栈顶180字的字，模拟用到这个深度 */
+	pxSelf->pxStack[TEST_STACK - STACK_USED_WORDS] = 0;
+
+	/* 本文件以configIDLE_STACK_SCAN_PERIOD=10编译，等空闲任务的周期扫描记下最小剩余栈 */
+	htTaskDelay(3 * configIDLE_STACK_SCAN_PERIOD);
+	CHECK(pxSelf->uxStackHighWaterMark == TEST_STACK - STACK_USED_WORDS);
+	CHECK(htGetTaskStackHighWaterMark(NULL) == TEST_STACK - STACK_USED_WORDS);
+
+	CHECK(htGetRecommendedStackDepth(STACK_USED_WORDS) == STACK_ADVISED_WORDS);
+	/* 用量很小时不低于最小栈 */
+	CHECK(htGetRecommendedStackDepth(1) == configMINIMAL_STACK_SIZE);
+
+	/* 报告写到临时文件中检查本任务的一行 */
+	fflush(stdout);
+	iStdout = dup(STDOUT_FILENO);
+	pxReport = tmpfile();
+	CHECK(iStdout >= 0 && pxReport != NULL);
+	if (iStdout >= 0 && pxReport != NULL) {
+		(void)dup2(fileno(pxReport), STDOUT_FILENO);
+		htStackReport();
+		fflush(stdout);
+		(void)dup2(iStdout, STDOUT_FILENO);
+		close(iStdout);
+
+		rewind(pxReport);
+		uxLength = fread(cReport, 1, sizeof(cReport) - 1U, pxReport);
+		cReport[uxLength] = '\0';
+		fclose(pxReport);
+
+		(void)snprintf(cExpected, sizeof(cExpected), "%-16s %6d %6d %6d %6d\r\n", "stack", TEST_STACK,
+			STACK_USED_WORDS, TEST_STACK - STACK_USED_WORDS, STACK_ADVISED_WORDS);
+		CHECK(strstr(cReport, cExpected) != NULL);
+	}
+
+	htTaskEndScheduler();
+}
+
+static void prvStackUsageSetup(void)
+{
+	htTaskCreate(prvStackUserTask, "stack", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_stack_high_water_mark_and_report_follow_deepest_use(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvStackUsageSetup));
+}
+
+/* ---------- 栈溢出检查 ---------- */
+
+static volatile TaskHandle_t xOverflowTask;
+static char cOverflowName[configMAX_TASK_NAME_LEN];
+static volatile int iOverflowHookCalls;
+
+/* 本文件以configUSE_STACK_OVERFLOW_HOOK=1编译 */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, const char *pcTaskName)
+{
+	htTCB_t *pxTCB = (htTCB_t *)xTask;
+
+	iOverflowHookCalls++;
+	xOverflowTask = xTask;
+	(void)strncpy(cOverflowName, pcTaskName, sizeof(cOverflowName) - 1);
+
+	/* 修复哨兵，之后的切换不再报告 */
+	pxTCB->pxStack[0] = (StackType_t)configSTACK_FILL_PATTERN;
+}
+
+static void prvOverflowVictimTask(void *pvParameters)
+{
+	htTCB_t *pxSelf = (htTCB_t *)htTaskGetCurrentTaskHandle();
+
+	(void)pvParameters;
+
+	/* 模拟越过栈底的写入：栈指针已经回到栈区内，只有栈底的哨兵字被改写 */
+	pxSelf->pxStack[0] = 0;
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvOverflowTask(void *pvParameters)
+{
+	TaskHandle_t xVictim = NULL;
+
+	(void)pvParameters;
+
+	/* 正常运行的任务经过多次切换都不会报告 */
+	htTaskDelay(5);
+	CHECK(iOverflowHookCalls == 0);
+
+	/* 受害任务优先级更高，创建后立即运行并在阻塞时被切出 */
+	CHECK(htTaskCreate(prvOverflowVictimTask, "victim", TEST_STACK, NULL, 3, &xVictim) == htPASS);
+	CHECK(iOverflowHookCalls == 1);
+	CHECK(xOverflowTask == xVictim);
+	CHECK(strcmp(cOverflowName, "victim") == 0);
+
+	htTaskDelay(5);
+	CHECK(iOverflowHookCalls == 1);
+
+	htTaskDelete(xVictim);
+	htTaskEndScheduler();
+}
+
+static void prvOverflowSetup(void)
+{
+	htTaskCreate(prvOverflowTask, "overflow", TEST_STACK, NULL, 2, NULL);
+}
+
+void test_stack_canary_overwrite_is_reported_on_switch(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvOverflowSetup));
+}
+
+int main(void)
+{
+	UnityBegin("test_kernel.c");
+
+	RUN_TEST(test_highest_priority_task_runs_first);
+	RUN_TEST(test_delayed_tasks_wake_in_deadline_order);
+	RUN_TEST(test_queue_receive_blocks_until_data_or_timeout);
+	RUN_TEST(test_mutex_holder_inherits_waiter_priority);
+	RUN_TEST(test_priority_inheritance_follows_chain_of_blocked_holders);
+	RUN_TEST(test_release_drops_to_highest_waiter_of_mutexes_still_held);
+	RUN_TEST(test_deleting_mutex_holder_makes_its_mutexes_available);
+	RUN_TEST(test_mutex_give_by_non_holder_fails);
+	RUN_TEST(test_native_mutex_hands_off_to_waiter_and_restores_priority);
+	RUN_TEST(test_native_mutex_waiter_timeout_drops_inherited_priority);
+	RUN_TEST(test_deleting_native_mutex_holder_releases_its_mutexes);
+	RUN_TEST(test_notify_give_take_counts);
+	RUN_TEST(test_event_group_waits_for_all_bits);
+	RUN_TEST(test_software_timers_fire_on_schedule);
+	RUN_TEST(test_isr_mask_nested_in_critical_section_restores_mask);
+	RUN_TEST(test_wakeups_while_suspended_run_on_resume);
+	RUN_TEST(test_self_deleted_tasks_are_reaped_by_idle);
+	RUN_TEST(test_yield_switches_only_when_another_task_is_selected);
+	RUN_TEST(test_stack_high_water_mark_and_report_follow_deepest_use);
+	RUN_TEST(test_stack_canary_overwrite_is_reported_on_switch);
+
+	return UnityEnd();
+}
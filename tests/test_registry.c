@@ -0,0 +1,125 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "unity.h"
+#include "htos.h"
+#include "httask.h"
+#include "htregistry.h"
+
+/*
+ * 链接期任务表测试：本文件用HT_TASK_DEFINE定义任务，不调用任何创建函数，
+ * 由htOSStart()从htTasks段中创建。场景运行方式与test_kernel.c相同。
+ */
+
+#define SCENARIO_TIMEOUT_MS 5000
+
+#define CHECK(xCondition) \
+	do { \
+		if (!(xCondition)) { \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #xCondition); \
+			iFailures++; \
+		} \
+	} while (0)
+
+/* 主机上由链接器生成的段边界 */
+extern const htTaskDescriptor_t __start_htTasks[];
+extern const htTaskDescriptor_t __stop_htTasks[];
+
+static volatile int iFailures;
+static volatile int iLog[16];
+static volatile int iLogCount;
+
+static void prvLog(int iValue)
+{
+	if (iLogCount < (int)(sizeof(iLog) / sizeof(iLog[0]))) {
+		iLog[iLogCount++] = iValue;
+	}
+}
+
+/* 在子进程中初始化内核并启动，返回失败的CHECK数，超时或崩溃返回-1 */
+static int prvRunKernel(void)
+{
+	pid_t xPid;
+	int iStatus;
+	int i;
+
+	fflush(stdout);
+	xPid = fork();
+	if (xPid == 0) {
+		/* 内核创建任务时的调试输出不混入测试结果 */
+		(void)freopen("/dev/null", "w", stdout);
+		htOSInit();
+		htOSStart();
+		_exit(iFailures == 0 ? 0 : 1);
+	}
+
+	for (i = 0; i < SCENARIO_TIMEOUT_MS; i++) {
+		if (waitpid(xPid, &iStatus, WNOHANG) == xPid) {
+			return WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : -1;
+		}
+		usleep(1000);
+	}
+
+	kill(xPid, SIGKILL);
+	(void)waitpid(xPid, &iStatus, 0);
+	return -1;
+}
+
+static void prvHighTask(void *pvParameters)
+{
+	CHECK(pvParameters == NULL);
+	prvLog(HT_HIGH_TASK);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvNormalTask(void *pvParameters)
+{
+	(void)pvParameters;
+	prvLog(HT_NORMAL_TASK);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvCheckTask(void *pvParameters);
+
+HT_TASK_DEFINE(reg_check, prvCheckTask, 256, HT_LOW_TASK);
+HT_TASK_DEFINE(reg_high, prvHighTask, 256, HT_HIGH_TASK);
+HT_TASK_DEFINE(reg_normal, prvNormalTask, 192, HT_NORMAL_TASK);
+
+/* 最低优先级的任务最后运行，检查所有表项都按描述符创建 */
+static void prvCheckTask(void *pvParameters)
+{
+	htTCB_t *pxHigh = (htTCB_t *)HT_TASK_HANDLE(reg_high);
+	htTCB_t *pxNormal = (htTCB_t *)HT_TASK_HANDLE(reg_normal);
+
+	(void)pvParameters;
+
+	CHECK(iLogCount == 2);
+	CHECK(iLog[0] == HT_HIGH_TASK && iLog[1] == HT_NORMAL_TASK);
+	CHECK(htTaskGetCurrentTaskHandle() == HT_TASK_HANDLE(reg_check));
+	CHECK(strcmp(pxHigh->pcTaskName, "reg_high") == 0);
+	CHECK(pxNormal->uxStackDepth == 192);
+	CHECK(pxNormal->uxPriority == HT_NORMAL_TASK);
+	CHECK(pxNormal->ucStaticallyAllocated == htTRUE);
+
+	/* 三个描述符在段中紧密排列，中间没有对齐空隙 */
+	CHECK(__stop_htTasks - __start_htTasks == 3);
+
+	htTaskEndScheduler();
+}
+
+void test_registered_tasks_start_with_os(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel());
+}
+
+int main(void)
+{
+	UnityBegin("test_registry.c");
+
+	RUN_TEST(test_registered_tasks_start_with_os);
+
+	return UnityEnd();
+}
@@ -0,0 +1,512 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "unity.h"
+#include "htos.h"
+#include "httask.h"
+#include "htscheduler.h"
+#include "htsemaphore.h"
+#include "htutils.h"
+#include "htSim.h"
+
+/*
+ * 虚拟时间仿真测试：链接完整内核和仿真模式的POSIX移植层，时钟只在所有任务阻塞时前进，
+ * 中断由脚本在指定tick注入。每个场景在子进程中运行到htOSStart()返回，之后在子进程中
+ * 检查结果，并把跟踪记录按文本写回父进程，用于断言和比较两次运行是否一致。
+ */
+
+#define SCENARIO_TIMEOUT_MS 5000
+#define TEST_STACK 256
+#define TRACE_TEXT_SIZE 65536
+
+#define CHECK(xCondition) \
+	do { \
+		if (!(xCondition)) { \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #xCondition); \
+			iFailures++; \
+		} \
+	} while (0)
+
+static volatile int iFailures;
+static volatile TickType_t xLog[16];
+static volatile int iLogCount;
+static char cTrace[TRACE_TEXT_SIZE];
+
+static void prvLog(TickType_t xValue)
+{
+	if (iLogCount < (int)(sizeof(xLog) / sizeof(xLog[0]))) {
+		xLog[iLogCount++] = xValue;
+	}
+}
+
+/* 把跟踪记录按"tick 类型 切出任务 切入任务 中断号"逐行写出 */
+static void prvWriteTrace(int iFd)
+{
+	const htSimEvent_t *pxEvents;
+	UBaseType_t uxCount;
+	UBaseType_t i;
+
+	uxCount = htSimGetTrace(&pxEvents);
+	for (i = 0; i < uxCount; i++) {
+		dprintf(iFd, "%lu %lu %s %s %lu\n", (unsigned long)pxEvents[i].xTick, (unsigned long)pxEvents[i].uxType,
+			(pxEvents[i].xFrom != NULL) ? ((htTCB_t *)pxEvents[i].xFrom)->pcTaskName : "-",
+			(pxEvents[i].xTo != NULL) ? ((htTCB_t *)pxEvents[i].xTo)->pcTaskName : "-",
+			(unsigned long)pxEvents[i].uxId);
+	}
+}
+
+/*
+ * 在子进程中运行一个仿真场景：pxSetup创建任务和脚本中断，htOSStart()返回后由pxCheck检查结果
+ * 跟踪记录文本保存到cTrace；返回失败的CHECK数，超时或崩溃返回-1
+ */
+static int prvRunSim(void (*pxSetup)(void), void (*pxCheck)(void))
+{
+	struct pollfd xPoll;
+	size_t uxLength = 0;
+	ssize_t xRead;
+	pid_t xPid;
+	int iPipe[2];
+	int iStatus;
+
+	if (pipe(iPipe) != 0) {
+		return -1;
+	}
+
+	fflush(stdout);
+	xPid = fork();
+	if (xPid == 0) {
+		close(iPipe[0]);
+		/* 内核创建任务时的调试输出不混入测试结果 */
+		(void)freopen("/dev/null", "w", stdout);
+		htOSInit();
+		pxSetup();
+		htOSStart();
+		pxCheck();
+		prvWriteTrace(iPipe[1]);
+		_exit(iFailures == 0 ? 0 : 1);
+	}
+
+	close(iPipe[1]);
+	xPoll.fd = iPipe[0];
+	xPoll.events = POLLIN;
+	for (;;) {
+		if (poll(&xPoll, 1, SCENARIO_TIMEOUT_MS) <= 0) {
+			kill(xPid, SIGKILL);
+			break;
+		}
+		xRead = read(iPipe[0], cTrace + uxLength, sizeof(cTrace) - 1U - uxLength);
+		if (xRead <= 0) {
+			break;
+		}
+		uxLength += (size_t)xRead;
+	}
+	cTrace[uxLength] = '\0';
+	close(iPipe[0]);
+
+	(void)waitpid(xPid, &iStatus, 0);
+	return WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : -1;
+}
+
+/* ---------- 虚拟时间 ---------- */
+
+static struct timespec xWallStart;
+
+static void prvHourTask(void *pvParameters)
+{
+	int i;
+
+	(void)pvParameters;
+	for (i = 0; i < 60; i++) {
+		htTaskDelay(60000);
+	}
+	prvLog(xTickCount);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvHourSetup(void)
+{
+	(void)clock_gettime(CLOCK_MONOTONIC, &xWallStart);
+	htTaskCreate(prvHourTask, "hour", TEST_STACK, NULL, HT_NORMAL_TASK, NULL);
+}
+
+static void prvHourCheck(void)
+{
+	struct timespec xWallEnd;
+	long long llElapsedMs;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xWallEnd);
+	llElapsedMs = (long long)(xWallEnd.tv_sec - xWallStart.tv_sec) * 1000LL +
+		(xWallEnd.tv_nsec - xWallStart.tv_nsec) / 1000000LL;
+
+	CHECK(iLogCount == 1);
+	CHECK(xLog[0] == 3600000UL);
+	CHECK(llElapsedMs < 1000);
+}
+
+void test_simulated_hour_runs_in_milliseconds(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvHourSetup, prvHourCheck));
+	/* 没有任何待发生事件时仿真结束 */
+	TEST_ASSERT_NOT_NULL(strstr(cTrace, "3600000 2 - - 0\n"));
+}
+
+/* ---------- 中断注入 ---------- */
+
+static SemaphoreHandle_t xIrqSem;
+
+static void prvGiveISR(void *pvParameter)
+{
+	BaseType_t xWoken = htFALSE;
+
+	(void)pvParameter;
+	(void)htSemaphoreGiveFromISR(xIrqSem, &xWoken);
+	if (xWoken == htTRUE) {
+		htTaskYield();
+	}
+}
+
+/* 高优先级中断处理任务：记录每次被唤醒时的虚拟时间 */
+static void prvHandlerTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		if (htSemaphoreTake(xIrqSem, htBLOCKED_INDEFINITELY) == htPASS) {
+			prvLog(xTickCount);
+		}
+	}
+}
+
+/* 低优先级周期任务，让延时定时轮上始终有事件 */
+static void prvBackgroundTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;) {
+		htTaskDelay(7);
+	}
+}
+
+static void prvIrqSetup(void)
+{
+	xIrqSem = htSemaphoreCreateBinary();
+	htTaskCreate(prvHandlerTask, "handler", TEST_STACK, NULL, HT_HIGH_TASK, NULL);
+	htTaskCreate(prvBackgroundTask, "bg", TEST_STACK, NULL, HT_LOW_TASK, NULL);
+	htSimScheduleISR(250, prvGiveISR, NULL);
+	htSimScheduleISR(100, prvGiveISR, NULL);
+	htSimSetEndTick(1000);
+}
+
+static void prvIrqCheck(void)
+{
+	CHECK(iLogCount == 2);
+	CHECK(xLog[0] == 100);
+	CHECK(xLog[1] == 250);
+	CHECK(xTickCount == 1000);
+}
+
+void test_injected_isr_wakes_handler_at_exact_tick(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvIrqSetup, prvIrqCheck));
+	/* 按时刻排序执行，登记号保持登记顺序；中断结束后立即切到处理任务 */
+	TEST_ASSERT_NOT_NULL(strstr(cTrace, "100 1 - - 1\n100 0 IDLE handler 0\n"));
+	TEST_ASSERT_NOT_NULL(strstr(cTrace, "250 1 - - 0\n250 0 IDLE handler 0\n"));
+	TEST_ASSERT_NOT_NULL(strstr(cTrace, "1000 2 - - 0\n"));
+}
+
+void test_same_scenario_gives_identical_trace(void)
+{
+	static char cFirst[TRACE_TEXT_SIZE];
+
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvIrqSetup, prvIrqCheck));
+	memcpy(cFirst, cTrace, sizeof(cFirst));
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvIrqSetup, prvIrqCheck));
+
+	TEST_ASSERT(strlen(cFirst) > 0);
+	TEST_ASSERT(strcmp(cFirst, cTrace) == 0);
+}
+
+/* ---------- 无滴答睡眠中的中断唤醒 ---------- */
+
+static volatile BaseType_t xWakeResult;
+
+/* 等待信号量，超时时刻为tick 5 */
+static void prvTimeoutWaiterTask(void *pvParameters)
+{
+	(void)pvParameters;
+
+	xWakeResult = htSemaphoreTake(xIrqSem, 5);
+	prvLog(xTickCount);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+/*
+ * 按移植层无滴答睡眠的顺序执行：挂起调度器，一次补偿到等待者的超时时刻，
+ * 同一tick的中断唤醒等待者，再恢复调度器
+ */
+static void prvSleeperTask(void *pvParameters)
+{
+	BaseType_t xWoken = htFALSE;
+
+	(void)pvParameters;
+
+	htSchedulerSuspend();
+	htTaskStepTick(5);
+	(void)htSemaphoreGiveFromISR(xIrqSem, &xWoken);
+	htSchedulerResume();
+
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvSleepWakeSetup(void)
+{
+	xIrqSem = htSemaphoreCreateBinary();
+	htTaskCreate(prvTimeoutWaiterTask, "waiter", TEST_STACK, NULL, HT_HIGH_TASK, NULL);
+	htTaskCreate(prvSleeperTask, "sleeper", TEST_STACK, NULL, HT_NORMAL_TASK, NULL);
+}
+
+static void prvSleepWakeCheck(void)
+{
+	/* 中断的唤醒先于定时轮的到期处理，等待者拿到信号量而不是超时 */
+	CHECK(xWakeResult == htPASS);
+	CHECK(iLogCount == 1);
+	CHECK(xLog[0] == 5);
+	CHECK(htSemaphoreGetCount(xIrqSem) == 0);
+}
+
+void test_isr_wake_in_tickless_sleep_beats_timeout_on_same_tick(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvSleepWakeSetup, prvSleepWakeCheck));
+}
+
+/* ---------- 时间片轮转 ---------- */
+
+#define SLICE_RUN_TICKS 60
+
+static volatile int iSliceSegments[2];
+static volatile int iSliceLastRunner = -1;
+static volatile TickType_t xSliceStart;
+static const TickType_t xSliceLength[2] = { 2, 4 };
+
+/* 不阻塞的计算任务，每开始一段连续运行时检查上一个任务刚好用完了自己的时间片 */
+static void prvSliceWorkerTask(void *pvParameters)
+{
+	const int iId = (int)(intptr_t)pvParameters;
+
+	for (;;) {
+		if (iSliceLastRunner != iId) {
+			if (iSliceLastRunner >= 0) {
+				CHECK(xTickCount - xSliceStart == xSliceLength[iSliceLastRunner]);
+			}
+			xSliceStart = xTickCount;
+			iSliceLastRunner = iId;
+			iSliceSegments[iId]++;
+		}
+		htSimBusy(1);
+	}
+}
+
+static void prvSliceSetup(void)
+{
+	TaskHandle_t xWorker;
+
+	htTaskCreate(prvSliceWorkerTask, "w0", TEST_STACK, (void *)0, HT_NORMAL_TASK, &xWorker);
+	htTaskSetTimeSlice(xWorker, xSliceLength[0]);
+	htTaskCreate(prvSliceWorkerTask, "w1", TEST_STACK, (void *)1, HT_NORMAL_TASK, &xWorker);
+	htTaskSetTimeSlice(xWorker, xSliceLength[1]);
+	htSimSetEndTick(SLICE_RUN_TICKS);
+}
+
+static void prvSliceCheck(void)
+{
+	/* 两个同优先级任务交替运行，每轮2+4个tick；w0在结束时刻开始了第11段 */
+	CHECK(iSliceSegments[0] == SLICE_RUN_TICKS / 6 + 1);
+	CHECK(iSliceSegments[1] == SLICE_RUN_TICKS / 6);
+	CHECK(xTickCount == SLICE_RUN_TICKS);
+}
+
+void test_equal_priority_tasks_share_cpu_by_time_slice(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvSliceSetup, prvSliceCheck));
+	TEST_ASSERT_NOT_NULL(strstr(cTrace, "2 0 w0 w1 0\n6 0 w1 w0 0\n8 0 w0 w1 0\n"));
+}
+
+/* ---------- 绝对时间延时与周期任务 ---------- */
+
+static void prvDelayUntilTask(void *pvParameters)
+{
+	TickType_t xStart;
+	TickType_t xLastWake;
+	int i;
+
+	(void)pvParameters;
+
+	xStart = xTickCount;
+	xLastWake = xStart;
+
+	/* 每个周期执行2个tick，唤醒时刻仍严格按周期排列，不累积漂移 */
+	for (i = 1; i <= 10; i++) {
+		htSimBusy(2);
+		CHECK(htTaskDelayUntil(&xLastWake, 5) == htPASS);
+		CHECK(xLastWake == xStart + (TickType_t)(5 * i));
+		CHECK(xTickCount == xLastWake);
+	}
+
+	/* 唤醒时刻已过时不延时 */
+	htSimBusy(6);
+	CHECK(htTaskDelayUntil(&xLastWake, 5) == htFAIL);
+	CHECK(xLastWake == xStart + 55);
+
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvDelayUntilSetup(void)
+{
+	htTaskCreate(prvDelayUntilTask, "until", TEST_STACK, NULL, HT_NORMAL_TASK, NULL);
+}
+
+static void prvDelayUntilCheck(void)
+{
+	/* 最后一次超出周期后不再延时，之后再无事件 */
+	CHECK(xTickCount == 56);
+}
+
+void test_delay_until_does_not_drift(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvDelayUntilSetup, prvDelayUntilCheck));
+}
+
+static void prvPeriodicTask(void *pvParameters)
+{
+	htPeriodicStats_t xStats;
+	TickType_t xStart;
+
+	(void)pvParameters;
+
+	xStart = xTickCount;
+	CHECK(htTaskWaitForNextPeriod() == htFAIL);
+	CHECK(htTaskSetPeriodic(10, 5) == htPASS);
+
+	/* 在截止时间内完成 */
+	htSimBusy(2);
+	CHECK(htTaskWaitForNextPeriod() == htPASS);
+	CHECK(xTickCount - xStart == 10);
+
+	/* 超过截止时间，但没有错过下一个释放时刻 */
+	htSimBusy(7);
+	CHECK(htTaskWaitForNextPeriod() == htFAIL);
+	CHECK(xTickCount - xStart == 20);
+
+	/* 超过整个周期：释放时刻30被跳过，下一个周期从40开始 */
+	htSimBusy(14);
+	CHECK(htTaskWaitForNextPeriod() == htFAIL);
+	CHECK(xTickCount - xStart == 40);
+
+	htSimBusy(1);
+	CHECK(htTaskWaitForNextPeriod() == htPASS);
+	CHECK(xTickCount - xStart == 50);
+
+	CHECK(htTaskGetPeriodicStats(NULL, &xStats) == htPASS);
+	CHECK(xStats.ulReleases == 5);
+	CHECK(xStats.ulDeadlineMisses == 3);
+	CHECK(xStats.xWorstResponseTime == 14);
+	CHECK(xStats.xMaxReleaseJitter == 0);
+
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvPeriodicSetup(void)
+{
+	htTaskCreate(prvPeriodicTask, "periodic", TEST_STACK, NULL, HT_NORMAL_TASK, NULL);
+}
+
+static void prvPeriodicCheck(void)
+{
+	CHECK(xTickCount == 50);
+}
+
+void test_periodic_task_counts_deadline_misses(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvPeriodicSetup, prvPeriodicCheck));
+}
+
+/* ---------- CPU使用率统计窗口 ---------- */
+
+static volatile uint32_t ulUsageBeforeRollover;
+static volatile uint32_t ulUsageAfterRollover;
+static volatile uint32_t ulTaskPercent;
+static uint64_t ullWindowTotal;
+static uint64_t ullWindowIdle;
+
+/* 每10个tick的周期中先占用n个tick，其余时间阻塞，由空闲任务运行 */
+static void prvLoadPeriods(TickType_t *pxLastWake, TickType_t xBusy, int iPeriods)
+{
+	int i;
+
+	for (i = 0; i < iPeriods; i++) {
+		htSimBusy(xBusy);
+		(void)htTaskDelayUntil(pxLastWake, 10);
+	}
+}
+
+static void prvLoadTask(void *pvParameters)
+{
+	TickType_t xLastWake = xTickCount;
+
+	(void)pvParameters;
+
+	/* 前10秒负载90%，之后30% */
+	prvLoadPeriods(&xLastWake, 9, 1000);
+	prvLoadPeriods(&xLastWake, 3, 500);
+	/* tick 15000：窗口内两种负载各占一半 */
+	ulUsageBeforeRollover = htGetCPUUsage();
+	prvLoadPeriods(&xLastWake, 3, 500);
+	/* tick 20000：90%的一段已经滑出窗口 */
+	ulUsageAfterRollover = htGetCPUUsage();
+	htTaskGetRunTimeWindow(&ullWindowTotal, &ullWindowIdle);
+	ulTaskPercent = htGetTaskRunTimePercent(NULL);
+
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvCpuUsageSetup(void)
+{
+	htTaskCreate(prvLoadTask, "load", TEST_STACK, NULL, HT_NORMAL_TASK, NULL);
+}
+
+static void prvCpuUsageCheck(void)
+{
+	CHECK(ulUsageBeforeRollover == 60);
+	CHECK(ulUsageAfterRollover == 30);
+	/* 刚采样后窗口正好覆盖最近configRUN_TIME_STATS_WINDOW秒 */
+	CHECK(ullWindowTotal == (uint64_t)configRUN_TIME_STATS_WINDOW * configTICK_RATE_HZ);
+	CHECK(ullWindowIdle == ullWindowTotal * 7U / 10U);
+	/* 单个任务的占比从启动开始统计：(9000 + 3000) / 20000 */
+	CHECK(ulTaskPercent == 60);
+}
+
+void test_cpu_usage_window_drops_load_older_than_window(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunSim(prvCpuUsageSetup, prvCpuUsageCheck));
+}
+
+int main(void)
+{
+	UnityBegin("test_sim.c");
+
+	RUN_TEST(test_simulated_hour_runs_in_milliseconds);
+	RUN_TEST(test_injected_isr_wakes_handler_at_exact_tick);
+	RUN_TEST(test_same_scenario_gives_identical_trace);
+	RUN_TEST(test_isr_wake_in_tickless_sleep_beats_timeout_on_same_tick);
+	RUN_TEST(test_equal_priority_tasks_share_cpu_by_time_slice);
+	RUN_TEST(test_delay_until_does_not_drift);
+	RUN_TEST(test_periodic_task_counts_deadline_misses);
+	RUN_TEST(test_cpu_usage_window_drops_load_older_than_window);
+
+	return UnityEnd();
+}
@@ -0,0 +1,231 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "unity.h"
+#include "htos.h"
+#include "httask.h"
+#include "htqueue.h"
+#include "htsemaphore.h"
+#include "hteventgroup.h"
+#include "httimer.h"
+
+/*
+ * 静态创建测试：内核以configSUPPORT_DYNAMIC_ALLOCATION=0编译并且不链接htmem.c，
+ * 任务和内核对象全部使用本文件中的静态存储区，空闲任务和定时器守护任务使用内核自带的存储区。
+ * 场景运行方式与test_kernel.c相同，每个场景在子进程中启动调度器。
+ */
+
+#define SCENARIO_TIMEOUT_MS 5000
+#define TEST_STACK 256
+#define TEST_QUEUE_LENGTH 4
+
+#define CHECK(xCondition) \
+	do { \
+		if (!(xCondition)) { \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #xCondition); \
+			iFailures++; \
+		} \
+	} while (0)
+
+static volatile int iFailures;
+
+/* 在子进程中初始化内核、运行pxSetup创建的任务，返回失败的CHECK数，超时或崩溃返回-1 */
+static int prvRunKernel(void (*pxSetup)(void))
+{
+	pid_t xPid;
+	int iStatus;
+	int i;
+
+	fflush(stdout);
+	xPid = fork();
+	if (xPid == 0) {
+		/* 内核创建任务时的调试输出不混入测试结果 */
+		(void)freopen("/dev/null", "w", stdout);
+		htOSInit();
+		pxSetup();
+		htOSStart();
+		_exit(iFailures == 0 ? 0 : 1);
+	}
+
+	for (i = 0; i < SCENARIO_TIMEOUT_MS; i++) {
+		if (waitpid(xPid, &iStatus, WNOHANG) == xPid) {
+			return WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : -1;
+		}
+		usleep(1000);
+	}
+
+	kill(xPid, SIGKILL);
+	(void)waitpid(xPid, &iStatus, 0);
+	return -1;
+}
+
+/* ---------- 静态创建的任务和内核对象 ---------- */
+
+static htTCB_t xProducerTCB;
+static StackType_t xProducerStack[TEST_STACK];
+static htTCB_t xConsumerTCB;
+static StackType_t xConsumerStack[TEST_STACK];
+
+static htStaticQueue_t xQueueBuffer;
+static uint8_t ucQueueStorage[TEST_QUEUE_LENGTH * sizeof(uint32_t)];
+static htStaticSemaphore_t xMutexBuffer;
+static htStaticSemaphore_t xRecursiveBuffer;
+static htStaticSemaphore_t xCountingBuffer;
+static htStaticEventGroup_t xEventGroupBuffer;
+static htStaticTimer_t xTimerBuffer;
+
+static QueueHandle_t xQueue;
+static SemaphoreHandle_t xMutex;
+static SemaphoreHandle_t xRecursive;
+static SemaphoreHandle_t xCounting;
+static EventGroupHandle_t xEvents;
+static TimerHandle_t xTimer;
+
+static void prvTimerCallback(TimerHandle_t xExpired)
+{
+	(void)xExpired;
+	(void)htEventGroupSetBits(xEvents, 0x02);
+}
+
+static void prvProducerTask(void *pvParameters)
+{
+	uint32_t i;
+
+	(void)pvParameters;
+	for (i = 0; i < 10; i++) {
+		CHECK(htQueueSend(xQueue, &i, htBLOCKED_INDEFINITELY) == htPASS);
+	}
+	(void)htEventGroupSetBits(xEvents, 0x01);
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvConsumerTask(void *pvParameters)
+{
+	uint32_t ulValue;
+	uint32_t i;
+
+	(void)pvParameters;
+
+	/* 队列存储区只有4项，生产者会多次阻塞在发送上 */
+	for (i = 0; i < 10; i++) {
+		CHECK(htQueueReceive(xQueue, &ulValue, 100) == htPASS);
+		CHECK(ulValue == i);
+	}
+
+	CHECK(htSemaphoreTakeMutex(xMutex, 0) == htPASS);
+	CHECK(htSemaphoreGiveMutex(xMutex) == htPASS);
+	CHECK(htSemaphoreTakeRecursive(xRecursive, 0) == htPASS);
+	CHECK(htSemaphoreTakeRecursive(xRecursive, 0) == htPASS);
+	CHECK(htSemaphoreGiveRecursive(xRecursive) == htPASS);
+	CHECK(htSemaphoreGiveRecursive(xRecursive) == htPASS);
+	CHECK(htSemaphoreGetCount(xCounting) == 2);
+	CHECK(htSemaphoreTake(xCounting, 0) == htPASS);
+	CHECK(htSemaphoreTake(xCounting, 0) == htPASS);
+	CHECK(htSemaphoreTake(xCounting, 0) == htFAIL);
+
+	/* 生产者置位0x01，定时器回调置位0x02 */
+	CHECK(htTimerStart(xTimer, 0) == htPASS);
+	CHECK((htEventGroupWaitBits(xEvents, 0x03, htTRUE, htTRUE, 100) & 0x03) == 0x03);
+
+	/* 删除静态对象不访问堆，存储区仍归调用者所有 */
+	CHECK(htTimerDelete(xTimer, 0) == htPASS);
+	htTaskDelete(&xProducerTCB);
+	htQueueDelete(xQueue);
+	htSemaphoreDelete(xMutex);
+	htSemaphoreDelete(xRecursive);
+	htSemaphoreDelete(xCounting);
+	htEventGroupDelete(xEvents);
+
+	htTaskEndScheduler();
+}
+
+static void prvObjectsSetup(void)
+{
+	xQueue = htQueueCreateStatic(TEST_QUEUE_LENGTH, sizeof(uint32_t), ucQueueStorage, &xQueueBuffer);
+	xMutex = htSemaphoreCreateMutexStatic(&xMutexBuffer);
+	xRecursive = htSemaphoreCreateRecursiveMutexStatic(&xRecursiveBuffer);
+	xCounting = htSemaphoreCreateCountingStatic(5, 2, &xCountingBuffer);
+	xEvents = htEventGroupCreateStatic(&xEventGroupBuffer);
+	xTimer = htTimerCreateStatic("t", 5, htFALSE, NULL, prvTimerCallback, &xTimerBuffer);
+	CHECK(xQueue == &xQueueBuffer);
+	CHECK(xMutex == &(xMutexBuffer.xQueue));
+	CHECK(xRecursive == &(xRecursiveBuffer.xQueue));
+	CHECK(xCounting == &(xCountingBuffer.xQueue));
+	CHECK(xEvents == &xEventGroupBuffer);
+	CHECK(xTimer == &xTimerBuffer);
+
+	/* 有消息时必须提供存储区 */
+	CHECK(htQueueCreateStatic(1, sizeof(uint32_t), NULL, &xQueueBuffer) == NULL);
+
+	CHECK(htTaskCreateStatic(prvConsumerTask, "consumer", TEST_STACK, NULL, HT_NORMAL_TASK, xConsumerStack,
+			&xConsumerTCB) == &xConsumerTCB);
+	CHECK(htTaskCreateStatic(prvProducerTask, "producer", TEST_STACK, NULL, HT_HIGH_TASK, xProducerStack,
+			&xProducerTCB) == &xProducerTCB);
+}
+
+void test_static_objects_run_without_heap(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvObjectsSetup));
+}
+
+/* ---------- 存储区复用 ---------- */
+
+static htTCB_t xWorkerTCB;
+static StackType_t xWorkerStack[TEST_STACK];
+static htTCB_t xControlTCB;
+static StackType_t xControlStack[TEST_STACK];
+static volatile int iWorkerRuns;
+
+static void prvWorkerTask(void *pvParameters)
+{
+	(void)pvParameters;
+	iWorkerRuns++;
+	htTaskDelay(htBLOCKED_INDEFINITELY);
+}
+
+static void prvControlTask(void *pvParameters)
+{
+	UBaseType_t uxTasks;
+	int i;
+
+	(void)pvParameters;
+	uxTasks = uxCurrentNumberOfTasks;
+
+	/* 删除后同一块存储区立即可以用来创建新任务，任务数不变 */
+	for (i = 0; i < 3; i++) {
+		htTaskDelay(2);
+		CHECK(iWorkerRuns == i + 1);
+		htTaskDelete(&xWorkerTCB);
+		CHECK(uxCurrentNumberOfTasks == uxTasks - 1);
+		CHECK(htTaskCreateStatic(prvWorkerTask, "worker", TEST_STACK, NULL, HT_HIGH_TASK, xWorkerStack,
+				&xWorkerTCB) == &xWorkerTCB);
+		CHECK(uxCurrentNumberOfTasks == uxTasks);
+	}
+	CHECK(iWorkerRuns == 4);
+
+	htTaskEndScheduler();
+}
+
+static void prvReuseSetup(void)
+{
+	(void)htTaskCreateStatic(prvWorkerTask, "worker", TEST_STACK, NULL, HT_HIGH_TASK, xWorkerStack, &xWorkerTCB);
+	(void)htTaskCreateStatic(prvControlTask, "control", TEST_STACK, NULL, HT_NORMAL_TASK, xControlStack,
+		&xControlTCB);
+}
+
+void test_static_task_storage_is_reusable_after_delete(void)
+{
+	TEST_ASSERT_EQUAL(0, prvRunKernel(prvReuseSetup));
+}
+
+int main(void)
+{
+	UnityBegin("test_static.c");
+
+	RUN_TEST(test_static_objects_run_without_heap);
+	RUN_TEST(test_static_task_storage_is_reusable_after_delete);
+
+	return UnityEnd();
+}
@@ -0,0 +1,216 @@
+#include "unity.h"
+#include "httimewheel.h"
+
+/* 用虚拟tick驱动定时轮，检查每一项都恰好在唤醒时间到期 */
+
+#define MAX_ITEMS 256
+
+typedef struct {
+	htListItem_t xItem;
+	TickType_t xWakeTime;
+	TickType_t xFiredAt;
+	int iFired;
+} TestTimer_t;
+
+static htTimeWheel_t xWheel;
+static TestTimer_t xTimers[MAX_ITEMS];
+
+static void prvOnExpired(htListItem_t *pxItem)
+{
+	TestTimer_t *pxTimer = (TestTimer_t *)htListGetItemOwner(pxItem);
+
+	pxTimer->xFiredAt = xWheel.xTime;
+	pxTimer->iFired++;
+}
+
+static void prvArm(TestTimer_t *pxTimer, TickType_t xDelay)
+{
+	htListItemInit(&(pxTimer->xItem));
+	htListSetItemOwner(&(pxTimer->xItem), pxTimer);
+	pxTimer->iFired = 0;
+	htTimeWheelInsert(&xWheel, &(pxTimer->xItem), xWheel.xTime + xDelay);
+	pxTimer->xWakeTime = htListGetItemValue(&(pxTimer->xItem));
+}
+
+static void prvRun(TickType_t xTicks)
+{
+	while (xTicks-- > 0) {
+		htTimeWheelTick(&xWheel, prvOnExpired);
+	}
+}
+
+/* 简单的线性同余伪随机数，保证结果可复现 */
+static uint32_t ulSeed = 12345;
+static uint32_t prvRand(void)
+{
+	ulSeed = ulSeed * 1103515245UL + 12345UL;
+	return ulSeed >> 8;
+}
+
+static int prvAllFiredOnTime(int iCount)
+{
+	int i;
+
+	for (i = 0; i < iCount; i++) {
+		if (xTimers[i].iFired != 1 || xTimers[i].xFiredAt != xTimers[i].xWakeTime) {
+			printf("  item %d: wake=%u fired=%d at=%u\n", i, (unsigned)xTimers[i].xWakeTime, xTimers[i].iFired,
+					(unsigned)xTimers[i].xFiredAt);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+void test_short_delays_expire_exactly(void)
+{
+	int i;
+
+	htTimeWheelInit(&xWheel, 0);
+	for (i = 0; i < 64; i++) {
+		prvArm(&xTimers[i], (TickType_t)(i + 1));
+	}
+	prvRun(64);
+	TEST_ASSERT(prvAllFiredOnTime(64));
+}
+
+void test_same_tick_batch(void)
+{
+	int i;
+	UBaseType_t uxExpired;
+
+	htTimeWheelInit(&xWheel, 1000);
+	for (i = 0; i < 10; i++) {
+		prvArm(&xTimers[i], 300);
+	}
+	prvRun(299);
+	uxExpired = htTimeWheelTick(&xWheel, prvOnExpired);
+	TEST_ASSERT_EQUAL(10, uxExpired);
+	TEST_ASSERT(prvAllFiredOnTime(10));
+}
+
+void test_tick_counter_wraparound(void)
+{
+	int i;
+
+	htTimeWheelInit(&xWheel, 0xFFFFFF00UL);
+	for (i = 0; i < 32; i++) {
+		prvArm(&xTimers[i], (TickType_t)(i * 37 + 1));
+	}
+	prvRun(32 * 37 + 1);
+	TEST_ASSERT(prvAllFiredOnTime(32));
+	TEST_ASSERT(xWheel.xTime < 0x1000);
+}
+
+void test_delay_beyond_wheel_range(void)
+{
+	htTimeWheelInit(&xWheel, 0xFFFF0000UL);
+	prvArm(&xTimers[0], 200000);
+	prvArm(&xTimers[1], (1UL << htTIMEWHEEL_RANGE_BITS) + 3);
+	prvArm(&xTimers[2], 1);
+	prvRun(200000);
+	TEST_ASSERT(prvAllFiredOnTime(3));
+}
+
+void test_remove_before_expiry(void)
+{
+	htTimeWheelInit(&xWheel, 0);
+	prvArm(&xTimers[0], 5);
+	prvArm(&xTimers[1], 500);
+	prvRun(100);
+	/* 已经下放过的项也能被直接移除 */
+	htListRemove(&(xTimers[1].xItem));
+	prvRun(1000);
+	TEST_ASSERT_EQUAL(1, xTimers[0].iFired);
+	TEST_ASSERT_EQUAL(0, xTimers[1].iFired);
+}
+
+void test_wake_at_current_time_fires_next_tick(void)
+{
+	htTimeWheelInit(&xWheel, 77);
+	prvArm(&xTimers[0], 0);
+	TEST_ASSERT_EQUAL(78, xTimers[0].xWakeTime);
+	prvRun(1);
+	TEST_ASSERT(prvAllFiredOnTime(1));
+}
+
+void test_random_delays(void)
+{
+	int i;
+
+	htTimeWheelInit(&xWheel, 0xFFF00000UL);
+	for (i = 0; i < MAX_ITEMS; i++) {
+		prvArm(&xTimers[i], (TickType_t)(prvRand() % 300000UL));
+	}
+	prvRun(300001);
+	TEST_ASSERT(prvAllFiredOnTime(MAX_ITEMS));
+}
+
+void test_next_event_is_never_late(void)
+{
+	htTimeWheelInit(&xWheel, 5);
+	TEST_ASSERT(htTimeWheelNextEvent(&xWheel) == htBLOCKED_INDEFINITELY);
+	prvArm(&xTimers[0], 3);
+	TEST_ASSERT_EQUAL(3, htTimeWheelNextEvent(&xWheel));
+	htListRemove(&(xTimers[0].xItem));
+	/* 高级槽返回下放时间，不晚于真正的到期时间 */
+	prvArm(&xTimers[0], 1000);
+	TEST_ASSERT(htTimeWheelNextEvent(&xWheel) <= 1000);
+	TEST_ASSERT(htTimeWheelNextEvent(&xWheel) > 0);
+}
+
+void test_advance_accounts_every_tick(void)
+{
+	int i;
+	UBaseType_t uxExpired;
+	TickType_t xLeft;
+	TickType_t xStep;
+
+	/* 模拟无滴答空闲：一次跳过一大段tick，到期项与逐tick驱动完全一致 */
+	htTimeWheelInit(&xWheel, 0xFFFFF000UL);
+	for (i = 0; i < MAX_ITEMS; i++) {
+		prvArm(&xTimers[i], (TickType_t)(prvRand() % 150000UL) + 1);
+	}
+	uxExpired = 0;
+	for (xLeft = 150001UL; xLeft > 0; xLeft -= xStep) {
+		xStep = (xLeft < 997UL) ? xLeft : 997UL;
+		uxExpired += htTimeWheelAdvance(&xWheel, xStep, prvOnExpired);
+	}
+	TEST_ASSERT_EQUAL(MAX_ITEMS, uxExpired);
+	TEST_ASSERT(prvAllFiredOnTime(MAX_ITEMS));
+}
+
+void test_advance_to_next_event(void)
+{
+	TickType_t xSlept = 0;
+	TickType_t xNext;
+
+	/* 空闲任务的用法：睡到下一个事件，补偿tick，直至所有项到期 */
+	htTimeWheelInit(&xWheel, 123);
+	prvArm(&xTimers[0], 40000);
+	prvArm(&xTimers[1], 70000);
+	while ((xNext = htTimeWheelNextEvent(&xWheel)) != htBLOCKED_INDEFINITELY) {
+		htTimeWheelAdvance(&xWheel, xNext, prvOnExpired);
+		xSlept += xNext;
+	}
+	TEST_ASSERT(prvAllFiredOnTime(2));
+	TEST_ASSERT(xSlept == 70000);
+	TEST_ASSERT(xWheel.xTime == 123 + 70000);
+}
+
+int main(void)
+{
+	UnityBegin("test_timewheel.c");
+
+	RUN_TEST(test_short_delays_expire_exactly);
+	RUN_TEST(test_same_tick_batch);
+	RUN_TEST(test_tick_counter_wraparound);
+	RUN_TEST(test_delay_beyond_wheel_range);
+	RUN_TEST(test_remove_before_expiry);
+	RUN_TEST(test_wake_at_current_time_fires_next_tick);
+	RUN_TEST(test_random_delays);
+	RUN_TEST(test_next_event_is_never_late);
+	RUN_TEST(test_advance_accounts_every_tick);
+	RUN_TEST(test_advance_to_next_event);
+
+	return UnityEnd();
+}
@@ -0,0 +1,179 @@
+#include "unity.h"
+#include "htwait.h"
+
+/* 等待队列唤醒顺序测试：任务切换相关函数用桩代替，htWaitQueueBlock()立即返回，任务留在等待列表中 */
+
+#define MAX_TASKS 16
+
+htTCB_t *pxCurrentTCB = NULL;
+TickType_t xTickCount = 0;
+
+static htTCB_t xTasks[MAX_TASKS];
+static htTCB_t *pxWoken[MAX_TASKS];
+static int iWokenCount;
+
+void htEnterCritical(void)
+{
+}
+
+void htExitCritical(void)
+{
+}
+
+void htTaskYield(void)
+{
+}
+
+void htTaskPlaceOnDelayedList(TickType_t xTicksToWait)
+{
+	(void)xTicksToWait;
+	pxCurrentTCB->uxTaskState = HT_TASK_BLOCKED;
+}
+
+void htTaskUnblock(htTCB_t *pxTCB)
+{
+	pxTCB->uxTaskState = HT_TASK_READY;
+	pxWoken[iWokenCount++] = pxTCB;
+}
+
+static void prvReset(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_TASKS; i++) {
+		htListItemInit(&(xTasks[i].xStateListItem));
+		htListItemInit(&(xTasks[i].xEventListItem));
+		htListSetItemOwner(&(xTasks[i].xEventListItem), &xTasks[i]);
+		xTasks[i].pxWaitQueue = NULL;
+	}
+	iWokenCount = 0;
+}
+
+/* 让任务i以给定优先级在等待队列上阻塞 */
+static void prvBlock(htWaitQueue_t *pxWaitQueue, int i, UBaseType_t uxPriority)
+{
+	TickType_t xTicksToWait = htBLOCKED_INDEFINITELY;
+
+	xTasks[i].uxPriority = uxPriority;
+	pxCurrentTCB = &xTasks[i];
+	htWaitQueueBlock(pxWaitQueue, &xTicksToWait);
+}
+
+static void prvWakeAll(htWaitQueue_t *pxWaitQueue)
+{
+	while (htWaitQueueWakeOne(pxWaitQueue) != NULL) {
+	}
+}
+
+void test_wakes_highest_priority_first(void)
+{
+	htWaitQueue_t xWaitQueue;
+
+	prvReset();
+	htWaitQueueInit(&xWaitQueue);
+	prvBlock(&xWaitQueue, 0, 1);
+	prvBlock(&xWaitQueue, 1, 5);
+	prvBlock(&xWaitQueue, 2, 3);
+	prvBlock(&xWaitQueue, 3, 31);
+	prvBlock(&xWaitQueue, 4, 0);
+	prvWakeAll(&xWaitQueue);
+
+	TEST_ASSERT_EQUAL(5, iWokenCount);
+	TEST_ASSERT(pxWoken[0] == &xTasks[3]);
+	TEST_ASSERT(pxWoken[1] == &xTasks[1]);
+	TEST_ASSERT(pxWoken[2] == &xTasks[2]);
+	TEST_ASSERT(pxWoken[3] == &xTasks[0]);
+	TEST_ASSERT(pxWoken[4] == &xTasks[4]);
+	TEST_ASSERT(htWaitQueueIsEmpty(&xWaitQueue) == htTRUE);
+}
+
+void test_same_priority_is_first_come_first_served(void)
+{
+	htWaitQueue_t xWaitQueue;
+
+	prvReset();
+	htWaitQueueInit(&xWaitQueue);
+	prvBlock(&xWaitQueue, 0, 2);
+	prvBlock(&xWaitQueue, 1, 4);
+	prvBlock(&xWaitQueue, 2, 2);
+	prvBlock(&xWaitQueue, 3, 4);
+	prvBlock(&xWaitQueue, 4, 2);
+	prvWakeAll(&xWaitQueue);
+
+	TEST_ASSERT(pxWoken[0] == &xTasks[1]);
+	TEST_ASSERT(pxWoken[1] == &xTasks[3]);
+	TEST_ASSERT(pxWoken[2] == &xTasks[0]);
+	TEST_ASSERT(pxWoken[3] == &xTasks[2]);
+	TEST_ASSERT(pxWoken[4] == &xTasks[4]);
+}
+
+void test_fifo_order_ignores_priority(void)
+{
+	htWaitQueue_t xWaitQueue;
+	int i;
+
+	prvReset();
+	htWaitQueueInit(&xWaitQueue);
+	htWaitQueueSetOrder(&xWaitQueue, htWAIT_ORDER_FIFO);
+	for (i = 0; i < 6; i++) {
+		prvBlock(&xWaitQueue, i, (UBaseType_t)((i * 7) % 5));
+	}
+	prvWakeAll(&xWaitQueue);
+
+	for (i = 0; i < 6; i++) {
+		TEST_ASSERT(pxWoken[i] == &xTasks[i]);
+	}
+}
+
+void test_reposition_after_priority_change(void)
+{
+	htWaitQueue_t xWaitQueue;
+
+	prvReset();
+	htWaitQueueInit(&xWaitQueue);
+	prvBlock(&xWaitQueue, 0, 3);
+	prvBlock(&xWaitQueue, 1, 2);
+	prvBlock(&xWaitQueue, 2, 1);
+
+	/* 模拟优先级继承：最低的等待者被提升到最高 */
+	xTasks[2].uxPriority = 6;
+	htWaitQueueReposition(&xTasks[2]);
+	prvWakeAll(&xWaitQueue);
+
+	TEST_ASSERT(pxWoken[0] == &xTasks[2]);
+	TEST_ASSERT(pxWoken[1] == &xTasks[0]);
+	TEST_ASSERT(pxWoken[2] == &xTasks[1]);
+}
+
+void test_removed_waiter_is_not_woken(void)
+{
+	htWaitQueue_t xWaitQueue;
+
+	prvReset();
+	htWaitQueueInit(&xWaitQueue);
+	prvBlock(&xWaitQueue, 0, 3);
+	prvBlock(&xWaitQueue, 1, 7);
+
+	/* 模拟超时：任务被移出等待列表 */
+	htWaitQueueRemove(&xTasks[1]);
+	TEST_ASSERT_NULL(xTasks[1].pxWaitQueue);
+	prvWakeAll(&xWaitQueue);
+
+	TEST_ASSERT_EQUAL(1, iWokenCount);
+	TEST_ASSERT(pxWoken[0] == &xTasks[0]);
+	TEST_ASSERT_EQUAL(htWAIT_SIGNALLED, xTasks[0].xWaitResult);
+	TEST_ASSERT_EQUAL(HT_TASK_READY, xTasks[0].uxTaskState);
+}
+
+int main(void)
+{
+	UnityBegin("test_waitqueue.c");
+
+	RUN_TEST(test_wakes_highest_priority_first);
+	RUN_TEST(test_same_priority_is_first_come_first_served);
+	RUN_TEST(test_fifo_order_ignores_priority);
+	RUN_TEST(test_reposition_after_priority_change);
+	RUN_TEST(test_removed_waiter_is_not_woken);
+
+	return UnityEnd();
+}